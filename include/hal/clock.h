@@ -0,0 +1,170 @@
+#ifndef HAL_CLOCK_H__
+#define HAL_CLOCK_H__
+
+#include <stdint.h>
+
+// System clock out of reset, the precision internal oscillator
+#define CLOCK_RESET_HZ 16000000UL
+#define CLOCK_PIOSC_HZ 16000000UL
+// Main oscillator crystal, the PLL reference
+#define CLOCK_XTAL_HZ 16000000UL
+// PLL output with DIV400. SysClk = 400MHz / divisor, divisor 5:128
+#define CLOCK_PLL_HZ 400000000UL
+#define CLOCK_MAX_HZ 80000000UL
+// Oscillator divisors with the PLL bypassed, SysClk = oscillator / divisor
+#define CLOCK_OSC_DIVISOR_MAX 64U
+#define CLOCK_PLL_DIVISOR_MIN 5U
+#define CLOCK_PLL_DIVISOR_MAX 128U
+// Lowest clock, the cycle counter helpers need at least a cycle per us
+#define CLOCK_MIN_HZ 1000000UL
+
+// Give up on the crystal or the PLL after this long and run from an oscillator
+#define CLOCK_MOSC_TIMEOUT_US 20000UL
+#define CLOCK_PLL_TIMEOUT_US 2000UL
+
+// Drivers that can follow a clock change
+#define CLOCK_MAX_NOTIFIERS 8U
+
+enum clockret
+{
+    CLOCK_OK,
+    CLOCK_INVALID_FREQUENCY,
+    CLOCK_NOTIFIERS_FULL,
+    // Crystal didn't start, running from PIOSC at 16MHz
+    CLOCK_MOSC_TIMEOUT,
+    // PLL didn't lock, running from the crystal at 16MHz
+    CLOCK_PLL_TIMEOUT
+};
+
+enum clock_source
+{
+    // 16MHz internal oscillator, +-1%. The main oscillator is powered down
+    CLOCK_SOURCE_PIOSC,
+    // 16MHz crystal
+    CLOCK_SOURCE_MOSC,
+    // 400MHz PLL from the crystal
+    CLOCK_SOURCE_PLL
+};
+
+enum clock_event
+{
+    // About to change, finish anything timed by the old clock
+    CLOCK_PRE_CHANGE,
+    // Changed, SystemCoreClock holds the new frequency
+    CLOCK_POST_CHANGE
+};
+
+/**
+ * @brief   Called around a clock change with the new frequency, from the
+ *          caller of clock_set_*. CLOCK_POST_CHANGE runs with interrupts
+ *          masked and must only reprogram registers.
+ *
+ */
+typedef void (*clock_notifier)( enum clock_event event, uint32_t hz );
+
+struct clock_stats
+{
+    uint32_t switches;
+    // From clock_set_* being called to it returning, notifiers included
+    uint32_t last_latency_us;
+    uint32_t max_latency_us;
+};
+
+// Current system clock in Hz, as in CMSIS
+extern uint32_t SystemCoreClock;
+
+/**
+ * @brief   Frequency clock_set_frequency would run at for a request: the
+ *          fastest achievable clock at or below it
+ *
+ * @param hz Requested frequency in Hz
+ * @return uint32_t Achievable frequency, 0 if outside CLOCK_MIN_HZ:CLOCK_MAX_HZ
+ */
+uint32_t clock_get_achievable( uint32_t hz );
+
+/**
+ * @brief   Switch the system clock. Exact divisions of the crystal run with
+ *          the PLL powered down, everything else from the 400MHz PLL.
+ *          Notifiers are called before and after the switch.
+ *
+ * @param hz Requested frequency in Hz, rounded down to an achievable one
+ * @return enum clockret CLOCK_MOSC_TIMEOUT or CLOCK_PLL_TIMEOUT when running
+ *                       from a fallback oscillator
+ */
+enum clockret clock_set_frequency( uint32_t hz );
+
+/**
+ * @brief   Start switching the system clock without waiting for the PLL. The
+ *          core runs from the 16MHz crystal, SystemCoreClock says so, until
+ *          clock_finish_frequency. Lets bring-up run alongside the lock;
+ *          drivers started meanwhile follow the CLOCK_POST_CHANGE sent when
+ *          it completes. Oscillator sources are switched straight away.
+ *
+ * @param hz Requested frequency in Hz, rounded down to an achievable one
+ * @return enum clockret
+ */
+enum clockret clock_start_frequency( uint32_t hz );
+
+/**
+ * @brief   Wait out the PLL lock started by clock_start_frequency and switch
+ *          to it. Returns straight away if nothing is pending
+ *
+ * @return enum clockret CLOCK_PLL_TIMEOUT if it didn't lock by
+ *                       CLOCK_PLL_TIMEOUT_US after the start
+ */
+enum clockret clock_finish_frequency( void );
+
+/**
+ * @brief   Check whether clock_finish_frequency would return without waiting
+ *
+ * @return uint8_t 1 if locked or nothing pending
+ */
+uint8_t clock_is_locked( void );
+
+/**
+ * @brief   Switch to a given source and divisor. The core runs from the
+ *          oscillator while dividers change and the PLL locks, so there is
+ *          never a glitch or overclock. CLOCK_PRE_CHANGE notifiers run with
+ *          interrupts enabled, so they can wait for transfers to drain; the
+ *          switch and CLOCK_POST_CHANGE notifiers run with interrupts masked,
+ *          so no ISR sees the new clock with old dividers.
+ *
+ * @param source Clock source
+ * @param divisor PLL: 5:128 except 7. Oscillators: 1:CLOCK_OSC_DIVISOR_MAX
+ * @return enum clockret CLOCK_INVALID_FREQUENCY for divisors out of range or
+ *                       results outside CLOCK_MIN_HZ:CLOCK_MAX_HZ, or a
+ *                       timeout as for clock_set_frequency
+ */
+enum clockret clock_set_source( enum clock_source source, uint8_t divisor );
+
+/**
+ * @brief   Current clock source
+ *
+ * @return enum clock_source
+ */
+enum clock_source clock_get_source( void );
+
+/**
+ * @brief   Read switch statistics. Latency is measured with the DWT cycle
+ *          counter, which must have been started with cycles_init.
+ *
+ * @param stats Statistics storage
+ */
+void clock_get_stats( struct clock_stats * stats );
+
+/**
+ * @brief   Register a driver to be told about clock changes
+ *
+ * @param notifier Notifier
+ * @return enum clockret CLOCK_NOTIFIERS_FULL if there is no room left
+ */
+enum clockret clock_register_notifier( clock_notifier notifier );
+
+/**
+ * @brief   Stop telling a driver about clock changes
+ *
+ * @param notifier Notifier
+ */
+void clock_unregister_notifier( clock_notifier notifier );
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef HAL_CLOCK_GATE_H__
+#define HAL_CLOCK_GATE_H__
+
+#include <stdint.h>
+
+/*
+ * Reference counted peripheral clock gates. Every driver that needs a module
+ * takes a reference for the modes it needs it clocked in and gives it back
+ * when done; the run, sleep and deep-sleep gate of each module is open while
+ * anyone holds a reference for that mode.
+ */
+
+// Module bits per class in the gate registers, 8 covers every class used
+#define CLOCK_GATE_MODULES 8U
+
+// Register banks, offsets are the same in each
+enum clock_gate_class
+{
+    CLOCK_GATE_TIMER,
+    CLOCK_GATE_GPIO,
+    CLOCK_GATE_DMA,
+    CLOCK_GATE_UART,
+    CLOCK_GATE_SSI,
+    CLOCK_GATE_I2C,
+    CLOCK_GATE_ADC,
+    CLOCK_GATE_WTIMER,
+    CLOCK_GATE_CLASSES
+};
+
+// Modes a reference keeps the module clocked in. Run is always included
+enum clock_gate_mode
+{
+    CLOCK_GATE_RUN = 0x01U,
+    CLOCK_GATE_SLEEP = 0x02U,
+    CLOCK_GATE_DEEP_SLEEP = 0x04U
+};
+
+/**
+ * @brief   Use the sleep and deep-sleep gates from now on. Until this is
+ *          called the core keeps the run gates while sleeping, as out of
+ *          reset, so every module enabled stays clocked.
+ *
+ */
+void clock_gate_init( void );
+
+/**
+ * @brief   Take a reference on modules and wait until they are all ready.
+ *          Safe from ISRs
+ *
+ * @param gate Class
+ * @param modules Module bits, e.g. 1 << instance or a Port
+ * @param modes enum clock_gate_mode bits
+ */
+void clock_gate_enable( enum clock_gate_class gate, uint32_t modules, uint8_t modes );
+
+/**
+ * @brief   Give back references taken by clock_gate_enable, with the same
+ *          modes. A gate closes when its last reference goes
+ *
+ * @param gate Class
+ * @param modules Module bits
+ * @param modes enum clock_gate_mode bits
+ */
+void clock_gate_disable( enum clock_gate_class gate, uint32_t modules, uint8_t modes );
+
+/**
+ * @brief   References held on a module for a mode
+ *
+ * @param gate Class
+ * @param module Module index
+ * @param mode One enum clock_gate_mode
+ * @return uint8_t Reference count
+ */
+uint8_t clock_gate_get_count( enum clock_gate_class gate, uint8_t module, enum clock_gate_mode mode );
+
+#endif
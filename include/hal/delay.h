@@ -0,0 +1,78 @@
+#ifndef HAL_DELAY_H__
+#define HAL_DELAY_H__
+
+#include <stdint.h>
+
+#include "hal/timer.h"
+
+/*
+ * One-shot delays on the general purpose timers. Each delay takes a timer
+ * counting PIOSC, so it keeps time across clock changes and in deep sleep,
+ * to 62.5ns. Longer than one 32-bit shot (268s) the interrupt rearms it. A
+ * delay either calls back from the timer interrupt or the caller sleeps
+ * through idle_wait until it ends.
+ *
+ * The wide timers have vectors too, but would only add range: 32-bit Timer A
+ * on PIOSC already resolves a single 62.5ns cycle, and the rare delay past
+ * 268s costs one extra interrupt. They stay free for other drivers.
+ */
+
+// Timers 2 to 4: 0 and 1 have the uDMA channels streams need, 5 is idle's
+#define DELAY_FIRST_TIMER TIMER_INSTANCE_2
+#define DELAY_TIMERS 3U
+#define DELAY_TICKS_PER_US 16U
+
+enum delayret
+{
+    DELAY_OK,
+    DELAY_INVALID_CONFIG,
+    // Every delay timer is running
+    DELAY_BUSY
+};
+
+/**
+ * @brief   Called from the timer interrupt when a delay ends. It may start
+ *          another delay
+ *
+ */
+typedef void (*delay_callback)( void * context );
+
+/**
+ * @brief   Start a delay. Its timer is set up on first use. From ISRs too
+ *
+ * @param ns Delay, rounded up to a PIOSC cycle
+ * @param callback Called when it ends, NULL for none
+ * @param context Passed to the callback
+ * @param id Delay id storage for delay_cancel, NULL if not needed
+ * @return enum delayret DELAY_BUSY if no timer is free
+ */
+enum delayret delay_start( uint64_t ns, delay_callback callback, void * context, uint8_t * id );
+
+/**
+ * @brief   Stop a delay before it ends, its callback isn't called
+ *
+ * @param id Delay id from delay_start
+ */
+void delay_cancel( uint8_t id );
+
+/**
+ * @brief   Time left of a delay
+ *
+ * @param id Delay id from delay_start
+ * @return uint64_t Nanoseconds, 0 once ended
+ */
+uint64_t delay_remaining_ns( uint8_t id );
+
+/**
+ * @brief   Sleep for a delay. Waits on the timebase instead if no timer is
+ *          free. A signal that comes in meanwhile is left for the main loop
+ *
+ * @param ns Delay
+ */
+void delay_sleep_ns( uint64_t ns );
+
+void delay_sleep_us( uint32_t us );
+
+void delay_sleep_ms( uint32_t ms );
+
+#endif
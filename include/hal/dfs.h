@@ -0,0 +1,117 @@
+#ifndef HAL_DFS_H__
+#define HAL_DFS_H__
+
+#include <stdint.h>
+
+#include "hal/clock.h"
+
+/*
+ * Dynamic frequency scaling. A table of clock levels, slowest first, and a
+ * governor the main loop feeds with its work backlog: a backlog that keeps up
+ * steps the clock up a level, a large one goes straight to the top, and time
+ * idle steps it back down. Energy is estimated from a run current per level,
+ * the board has no way to measure it.
+ */
+
+#define DFS_MAX_LEVELS 6U
+#define DFS_SUPPLY_MV 3300U
+
+// Backlog that goes straight to the fastest level
+#define DFS_BACKLOG_HIGH 4U
+// Time a backlog must last before stepping up, and idle time before stepping down
+#define DFS_UP_HOLD_US 2000UL
+#define DFS_DOWN_HOLD_US 50000UL
+
+// Rough run current model for the default levels, flash and peripherals on.
+// Replace with measured currents per level for real energy figures
+#define DFS_BASE_UA 5000UL
+#define DFS_UA_PER_MHZ 350UL
+#define DFS_PLL_UA 2000UL
+
+enum dfsret
+{
+    DFS_OK,
+    DFS_INVALID_CONFIG
+};
+
+struct dfs_level
+{
+    enum clock_source source;
+    uint8_t divisor;
+    // Run current at this level, for energy estimates
+    uint32_t current_ua;
+};
+
+/**
+ * @brief   Energy and time between dfs_task_begin and dfs_task_end
+ *
+ */
+struct dfs_task
+{
+    uint64_t start_nj;
+    uint64_t start_us;
+    uint32_t energy_nj;
+    uint32_t time_us;
+};
+
+struct dfs_stats
+{
+    uint8_t level;
+    // Time at each level since dfs_init
+    uint64_t residency_us[DFS_MAX_LEVELS];
+    uint64_t energy_nj;
+    struct clock_stats clock;
+};
+
+/**
+ * @brief   Take over the system clock and start at the fastest level. Needs
+ *          the DWT cycle counter, started here.
+ *
+ * @param levels Levels slowest first, copied. NULL for the defaults: PIOSC/4,
+ *               crystal, PLL 40MHz and PLL 80MHz
+ * @param count Levels, up to DFS_MAX_LEVELS
+ * @return enum dfsret DFS_INVALID_CONFIG if the fastest level is one
+ *                     clock_set_source rejects
+ */
+enum dfsret dfs_init( const struct dfs_level * levels, uint8_t count );
+
+/**
+ * @brief   Governor step, from the main loop at least every few ms. Switches
+ *          the clock when the policy says so, which blocks for the PLL lock.
+ *
+ * @param backlog Work waiting, 0 when idle
+ */
+void dfs_update( uint16_t backlog );
+
+/**
+ * @brief   Switch to a level now. The governor carries on from it
+ *
+ * @param level Level index
+ * @return enum dfsret
+ */
+enum dfsret dfs_set_level( uint8_t level );
+
+uint8_t dfs_get_level( void );
+
+/**
+ * @brief   Start measuring a task
+ *
+ * @param task Task storage
+ */
+void dfs_task_begin( struct dfs_task * task );
+
+/**
+ * @brief   Stop measuring a task, filling in its energy and time
+ *
+ * @param task Task passed to dfs_task_begin
+ */
+void dfs_task_end( struct dfs_task * task );
+
+/**
+ * @brief   Read residency, energy and clock switch statistics
+ *
+ * @param stats Statistics storage
+ */
+void dfs_get_stats( struct dfs_stats * stats );
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef HAL_DMA_MEM_H__
+#define HAL_DMA_MEM_H__
+
+#include <stdint.h>
+
+/*
+ * Memory copy and fill on the uDMA software channel. Requests are queued and
+ * run back to back from the uDMA software interrupt, so the CPU only sets
+ * up each 1024 item chunk. Requests smaller than the threshold are done by
+ * the CPU straight away, where setting up the channel would cost more than
+ * the copy itself.
+ */
+
+// Pending requests, power of 2
+#define DMA_MEM_QUEUE_SIZE 8U
+// Bytes below which the CPU copies, until dma_mem_calibrate measures it
+#define DMA_MEM_DEFAULT_THRESHOLD 64U
+
+enum dma_mem_ret
+{
+    DMA_MEM_OK,
+    DMA_MEM_QUEUE_FULL,
+    DMA_MEM_INVALID_CONFIG
+};
+
+enum dma_mem_width
+{
+    DMA_MEM_WIDTH_8 = 1,
+    DMA_MEM_WIDTH_16 = 2,
+    DMA_MEM_WIDTH_32 = 4
+};
+
+enum dma_mem_status
+{
+    DMA_MEM_IDLE,
+    DMA_MEM_QUEUED,
+    DMA_MEM_DONE
+};
+
+struct dma_mem_request;
+
+/**
+ * @brief   Called once a request is done, from the uDMA software interrupt,
+ *          or from dma_mem_submit for requests the CPU did
+ *
+ */
+typedef void (*dma_mem_callback)( struct dma_mem_request * request );
+
+/**
+ * @brief   One copy or fill. Owned by the caller and must stay valid until
+ *          its status is DONE. Buffers must be aligned to the width.
+ *
+ */
+struct dma_mem_request
+{
+    void * dst;
+    // Copy source, NULL to fill with value
+    const void * src;
+    uint32_t value;
+    // Items of width bytes
+    uint32_t count;
+    enum dma_mem_width width;
+    dma_mem_callback callback;
+    void * context;
+    volatile enum dma_mem_status status;
+
+    // Items handed to the controller so far
+    uint32_t started;
+};
+
+struct dma_mem_stats
+{
+    uint32_t dma_requests;
+    uint32_t cpu_requests;
+    uint32_t dma_bytes;
+    uint32_t queue_full;
+};
+
+/**
+ * @brief   Take the uDMA software channel and its interrupt. udma_init must
+ *          have been called.
+ *
+ */
+void dma_mem_init( void );
+
+/**
+ * @brief   Queue a request, or do it on the CPU now if it is below the
+ *          threshold. Safe from the main loop and from ISRs
+ *
+ * @param request Request with dst, src or value, count and width filled in
+ * @return enum dma_mem_ret
+ */
+enum dma_mem_ret dma_mem_submit( struct dma_mem_request * request );
+
+/**
+ * @brief   Check whether requests are queued or running
+ *
+ * @return uint8_t 1 if busy
+ */
+uint8_t dma_mem_busy( void );
+
+/**
+ * @brief   Wait for a request. Not from an ISR of higher priority than the
+ *          uDMA software interrupt
+ *
+ * @param request Submitted request
+ */
+void dma_mem_wait( struct dma_mem_request * request );
+
+/**
+ * @brief   Copy and wait
+ *
+ * @param dst Destination
+ * @param src Source
+ * @param count Items
+ * @param width Item width
+ * @return enum dma_mem_ret
+ */
+enum dma_mem_ret dma_mem_copy( void * dst, const void * src, uint32_t count, enum dma_mem_width width );
+
+/**
+ * @brief   Fill and wait
+ *
+ * @param dst Destination
+ * @param value Fill value, low width bytes are used
+ * @param count Items
+ * @param width Item width
+ * @return enum dma_mem_ret
+ */
+enum dma_mem_ret dma_mem_set( void * dst, uint32_t value, uint32_t count, enum dma_mem_width width );
+
+/**
+ * @brief   Set the size in bytes below which the CPU does the work
+ *
+ * @param bytes Threshold, 0 to always use DMA
+ */
+void dma_mem_set_threshold( uint32_t bytes );
+
+/**
+ * @brief   Read the size in bytes below which the CPU does the work
+ *
+ * @return uint32_t Threshold
+ */
+uint32_t dma_mem_get_threshold( void );
+
+/**
+ * @brief   Time CPU and DMA copies of growing size and set the threshold to
+ *          the smallest size where DMA finishes first. If DMA never does,
+ *          the threshold goes one byte past the largest size measured, so
+ *          the CPU keeps everything up to it. Needs the DWT cycle counter
+ *          and an idle queue; blocks for a few milliseconds.
+ *
+ * @return uint32_t New threshold in bytes
+ */
+uint32_t dma_mem_calibrate( void );
+
+/**
+ * @brief   Read statistics
+ *
+ * @param stats Statistics storage
+ */
+void dma_mem_get_stats( struct dma_mem_stats * stats );
+
+#endif
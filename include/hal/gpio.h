@@ -3,5 +3,131 @@
 
 #include <stdint.h>
 
+#include "hal/common.h"
+
+/**
+ * @brief   Register layout of a GPIO port on the AHB aperture. All ports are
+ *          accessed through AHB (SYSCTL_GPIOHBCTL) in this code base.
+ *
+ */
+struct gpio_regs
+{
+    // Masked data, index with the pin mask. DATA_BITS[0xFF] is GPIODATA
+    volatile uint32_t DATA_BITS[256];   // 0x000
+    volatile uint32_t DIR;              // 0x400
+    volatile uint32_t IS;               // 0x404
+    volatile uint32_t IBE;              // 0x408
+    volatile uint32_t IEV;              // 0x40C
+    volatile uint32_t IM;               // 0x410
+    volatile uint32_t RIS;              // 0x414
+    volatile uint32_t MIS;              // 0x418
+    volatile uint32_t ICR;              // 0x41C
+    volatile uint32_t AFSEL;            // 0x420
+    uint32_t RESERVED0[55];             // 0x424
+    volatile uint32_t DR2R;             // 0x500
+    volatile uint32_t DR4R;             // 0x504
+    volatile uint32_t DR8R;             // 0x508
+    volatile uint32_t ODR;              // 0x50C
+    volatile uint32_t PUR;              // 0x510
+    volatile uint32_t PDR;              // 0x514
+    volatile uint32_t SLR;              // 0x518
+    volatile uint32_t DEN;              // 0x51C
+    volatile uint32_t LOCK;             // 0x520
+    volatile uint32_t CR;               // 0x524
+    volatile uint32_t AMSEL;            // 0x528
+    volatile uint32_t PCTL;             // 0x52C
+    volatile uint32_t ADCCTL;           // 0x530
+    volatile uint32_t DMACTL;           // 0x534
+};
+
+/**
+ * @brief   Get the AHB registers of a port
+ *
+ * @param port Port
+ * @return struct gpio_regs*
+ */
+struct gpio_regs * gpio_get_port( Port port );
+
+/**
+ * @brief   Enable the clock and AHB access of a port and wait until it is
+ *          ready. Takes a clock gate reference, kept through sleep
+ *
+ * @param port Port
+ */
+void gpio_enable_port( Port port );
+
+/**
+ * @brief   Give back the reference taken by gpio_enable_port. The port clock
+ *          stops once no driver uses it; pins keep their levels
+ *
+ * @param port Port
+ */
+void gpio_disable_port( Port port );
+
+/**
+ * @brief   Route pins to a peripheral. Unlocks the commit register so locked
+ *          pins (PF0, PD7) can be used.
+ *
+ * @param port Port
+ * @param pins Pin mask
+ * @param function PCTL mux value, see the datasheet signal tables
+ */
+void gpio_set_alternate( Port port, uint8_t pins, uint8_t function );
+
+/**
+ * @brief   Configure pins as digital outputs
+ *
+ * @param port Port
+ * @param pins Pin mask
+ */
+void gpio_set_output( Port port, uint8_t pins );
+
+/**
+ * @brief   Configure pins as digital inputs
+ *
+ * @param port Port
+ * @param pins Pin mask
+ */
+void gpio_set_input( Port port, uint8_t pins );
+
+/**
+ * @brief   Enable the weak pull down on pins
+ *
+ * @param port Port
+ * @param pins Pin mask
+ */
+void gpio_set_pull_down( Port port, uint8_t pins );
+
+/**
+ * @brief   Enable the weak pull up on pins
+ *
+ * @param port Port
+ * @param pins Pin mask
+ */
+void gpio_set_pull_up( Port port, uint8_t pins );
+
+/**
+ * @brief   Drive output pins without a read-modify-write
+ *
+ * @param gpio Port registers
+ * @param pins Pin mask
+ * @param high Non zero to drive the pins high
+ */
+static inline void gpio_write( struct gpio_regs * gpio, uint8_t pins, uint8_t high )
+{
+    gpio->DATA_BITS[pins] = high ? pins : 0U;
+}
+
+/**
+ * @brief   Read pin levels
+ *
+ * @param gpio Port registers
+ * @param pins Pin mask
+ * @return uint8_t Levels of the masked pins, other bits 0
+ */
+static inline uint8_t gpio_read( struct gpio_regs * gpio, uint8_t pins )
+{
+    return (uint8_t)gpio->DATA_BITS[pins];
+}
 
 #endif
\ No newline at end of file
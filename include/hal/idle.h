@@ -0,0 +1,111 @@
+#ifndef HAL_IDLE_H__
+#define HAL_IDLE_H__
+
+#include <stdint.h>
+
+#include "hal/timer.h"
+
+/*
+ * Event driven idle. The main loop calls idle_wait when it has nothing to
+ * do; the core sleeps with WFI until an ISR calls idle_signal or the timeout
+ * passes, and in deep sleep when the timeout is long enough and nothing
+ * blocks it. A timer counting PIOSC wakes the core, measures how long it
+ * slept and how long it took to wake, and keeps the DWT cycle counter and
+ * the timebase in step with the time spent asleep.
+ */
+
+// Wake timer, counting PIOSC
+#define IDLE_TIMER TIMER_INSTANCE_5
+#define IDLE_TICKS_PER_US 16U
+
+// Shortest wait worth deep sleep, the PLL relocks on the way out
+#define IDLE_DEEP_SLEEP_MIN_US 2000UL
+
+// Wait for idle_signal only
+#define IDLE_FOREVER 0xFFFFFFFFUL
+
+struct idle_stats
+{
+    // idle_wait calls that slept, by mode
+    uint32_t sleeps;
+    uint32_t deep_sleeps;
+    uint64_t sleep_us;
+    // From the wake timer expiring to the core running again
+    uint32_t last_wake_us;
+    uint32_t max_wake_us;
+    uint32_t max_deep_wake_us;
+    // Wakes slower than the latency budget
+    uint32_t budget_misses;
+};
+
+/**
+ * @brief   Take IDLE_TIMER as the wake timer. Until this is called idle_wait
+ *          returns straight away and callers fall back to spinning.
+ *
+ */
+void idle_init( void );
+
+/**
+ * @brief   Work is pending: end the current or next idle_wait. From ISRs or
+ *          the main loop
+ *
+ */
+void idle_signal( void );
+
+/**
+ * @brief   End the current or next idle_wait without signalling work, for a
+ *          caller sleeping on an event of its own. From ISRs
+ *
+ */
+void idle_wake( void );
+
+/**
+ * @brief   Sleep until idle_signal is called or the timeout passes. Other
+ *          interrupts are handled as they come and the core goes back to
+ *          sleep. Deep sleep is used when timeout_us is at least
+ *          IDLE_DEEP_SLEEP_MIN_US, nothing blocks it and its measured wake
+ *          latency is within the budget.
+ *
+ * @param timeout_us Longest sleep, IDLE_FOREVER for none
+ * @return uint8_t 1 if signalled, 0 on timeout or idle_wake
+ */
+uint8_t idle_wait( uint32_t timeout_us );
+
+/**
+ * @brief   Keep the core out of deep sleep, e.g. while a transfer runs from a
+ *          peripheral that isn't clocked there. Nests
+ *
+ */
+void idle_block_deep_sleep( void );
+
+/**
+ * @brief   Undo idle_block_deep_sleep
+ *
+ */
+void idle_allow_deep_sleep( void );
+
+/**
+ * @brief   Set the wake latency the application can tolerate. Deep sleep is
+ *          no longer used once a deep sleep wake has been slower, and slower
+ *          wakes are counted.
+ *
+ * @param us Budget, 0 for none
+ */
+void idle_set_latency_budget( uint32_t us );
+
+/**
+ * @brief   Go back to sleep straight after each ISR instead of returning to
+ *          the main loop, for designs where ISRs do all the work
+ *
+ * @param enable 1 to sleep on exit
+ */
+void idle_set_sleep_on_exit( uint8_t enable );
+
+/**
+ * @brief   Read idle statistics
+ *
+ * @param stats Statistics storage
+ */
+void idle_get_stats( struct idle_stats * stats );
+
+#endif
@@ -2,6 +2,11 @@
 #define HAL_PLL_H__
 
 #include "hal/tm4c123gh6pm.h"
+#include "hal/clock.h"
+
+// System clock set by pll_init(). Drivers use SystemCoreClock, which follows
+// clock_set_frequency()
+#define PLL_SYSTEM_CLOCK_HZ 80000000UL
 
 /**
  * @brief Initialise PLL to 80MHz
@@ -9,4 +14,20 @@
  */
 void pll_init( void );
 
+/**
+ * @brief Start the PLL towards 80MHz and return while it locks, running from
+ *        the 16MHz crystal meanwhile
+ * 
+ * @return enum clockret CLOCK_MOSC_TIMEOUT if the crystal didn't start, there
+ *                       is then nothing to wait for
+ */
+enum clockret pll_start( void );
+
+/**
+ * @brief Finish pll_start
+ * 
+ * @return enum clockret CLOCK_OK at 80MHz, else the oscillator fallback in use
+ */
+enum clockret pll_wait( void );
+
 #endif
\ No newline at end of file
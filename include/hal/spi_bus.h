@@ -0,0 +1,192 @@
+#ifndef HAL_SPI_BUS_H__
+#define HAL_SPI_BUS_H__
+
+#include <stdint.h>
+
+#include "hal/common.h"
+#include "hal/gpio.h"
+#include "hal/ssi.h"
+
+// Devices per bus
+#define SPI_BUS_MAX_DEVICES 4U
+// Pending transactions per bus, power of 2
+#define SPI_BUS_QUEUE_SIZE 8U
+
+enum spi_bus_ret
+{
+    SPI_BUS_OK,
+    SPI_BUS_QUEUE_FULL,
+    SPI_BUS_INVALID_CONFIG,
+    SPI_BUS_TRANSFER_FAILED,
+    // Called while the bus is running its queue
+    SPI_BUS_BUSY
+};
+
+enum spi_transaction_status
+{
+    SPI_TRANSACTION_IDLE,
+    SPI_TRANSACTION_QUEUED,
+    SPI_TRANSACTION_DONE,
+    SPI_TRANSACTION_FAILED
+};
+
+struct spi_device_config
+{
+    // Active low chip select
+    Port cs_port;
+    uint8_t cs_pin;
+    enum ssi_clock_polarity polarity;
+    enum ssi_data_capture_clk_phase phase;
+    enum ssi_datasize datasize;
+    // Device's maximum bit rate in Hz. When non zero prescale and scr are
+    // derived from it and the system clock, otherwise they are used as given
+    uint32_t bitrate;
+    // BR = SysClk / (prescale * (1 + scr)). Prescale must be even, 2 to 254
+    uint8_t prescale;
+    uint8_t scr;
+};
+
+struct spi_bus;
+
+struct spi_device
+{
+    struct spi_bus * bus;
+    struct gpio_regs * cs_gpio;
+    uint8_t cs_pin;
+    enum ssi_datasize datasize;
+    // Achieved bit rate in Hz
+    uint32_t bitrate;
+    // Requested bit rate, 0 for fixed prescale and scr, and the system clock
+    // the cached divisors were worked out for
+    uint32_t max_bitrate;
+    uint32_t clock_hz;
+    // Register values cached at registration, loaded on a device switch
+    uint32_t cr0;
+    uint32_t cpsr;
+};
+
+struct spi_transaction;
+
+/**
+ * @brief   Called from spi_bus_process once a transaction has run
+ *
+ */
+typedef void (*spi_transaction_callback)( struct spi_transaction * transaction );
+
+/**
+ * @brief   One chip select assertion. Owned by the caller and must stay valid
+ *          until its status is DONE or FAILED.
+ *
+ */
+struct spi_transaction
+{
+    struct spi_device * device;
+    const uint8_t * tx;
+    uint8_t * rx;
+    uint16_t length;
+    spi_transaction_callback callback;
+    void * context;
+    volatile enum spi_transaction_status status;
+};
+
+struct spi_bus_stats
+{
+    uint32_t transactions;
+    uint32_t bytes;
+    // Transactions that had to reload CR0/CPSR
+    uint32_t device_switches;
+    uint32_t queue_full;
+    // Cycles with a chip select asserted, and cycles since the stats were reset
+    uint64_t busy_cycles;
+    uint64_t window_cycles;
+};
+
+struct spi_bus
+{
+    struct ssi_handle * ssi;
+    struct spi_device devices[SPI_BUS_MAX_DEVICES];
+    uint8_t device_count;
+    struct spi_device * active_device;
+
+    struct spi_transaction * queue[SPI_BUS_QUEUE_SIZE];
+    volatile uint8_t queue_head;
+    volatile uint8_t queue_tail;
+    uint8_t processing;
+
+    struct spi_bus_stats stats;
+    uint32_t window_mark;
+};
+
+/**
+ * @brief   Initialise a bus on an SSI module. FSS is left to the devices'
+ *          chip select pins.
+ *
+ * @param bus Bus storage
+ * @param instance SSI module
+ * @param pins Pin mux option of the module
+ * @return enum spi_bus_ret
+ */
+enum spi_bus_ret spi_bus_init( struct spi_bus * bus, enum ssi_instance instance, enum ssi_pinmux pins );
+
+/**
+ * @brief   Register a device and configure its chip select pin
+ *
+ * @param bus Bus
+ * @param config Device settings
+ * @return struct spi_device* NULL if the bus is full or the config is invalid
+ */
+struct spi_device * spi_bus_add_device( struct spi_bus * bus, const struct spi_device_config * config );
+
+/**
+ * @brief   Queue a transaction. Safe from the main loop and from ISRs
+ *
+ * @param transaction Transaction with device, buffers and length filled in
+ * @return enum spi_bus_ret SPI_BUS_QUEUE_FULL if it couldn't be queued
+ */
+enum spi_bus_ret spi_bus_submit( struct spi_transaction * transaction );
+
+/**
+ * @brief   Run every queued transaction back to back, switching the SSI
+ *          configuration only when the device changes. Call from the main loop.
+ *
+ * @param bus Bus
+ * @return uint8_t Number of transactions run
+ */
+uint8_t spi_bus_process( struct spi_bus * bus );
+
+/**
+ * @brief   Run one transfer now, after anything already queued. Main loop
+ *          only, not from transaction callbacks or ISRs
+ *
+ * @param device Device
+ * @param tx Bytes to send, NULL to send SSI_READ_FILL
+ * @param rx Received bytes storage, NULL to discard
+ * @param length Number of bytes
+ * @return enum spi_bus_ret
+ */
+enum spi_bus_ret spi_bus_transfer( struct spi_device * device, const uint8_t * tx, uint8_t * rx, uint16_t length );
+
+/**
+ * @brief   Read bus statistics
+ *
+ * @param bus Bus
+ * @param stats Statistics storage
+ */
+void spi_bus_get_stats( struct spi_bus * bus, struct spi_bus_stats * stats );
+
+/**
+ * @brief   Clear bus statistics and start a new utilisation window
+ *
+ * @param bus Bus
+ */
+void spi_bus_reset_stats( struct spi_bus * bus );
+
+/**
+ * @brief   Share of the window a chip select was asserted
+ *
+ * @param bus Bus
+ * @return uint16_t Busy cycles per thousand
+ */
+uint16_t spi_bus_utilisation( struct spi_bus * bus );
+
+#endif
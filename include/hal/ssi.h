@@ -9,33 +9,429 @@ enum ssiret
 {
     SSI_OK,
     SSI_TX_FIFO_FULL,
-    SSI_RX_FIFO_EMPTY
+    SSI_RX_FIFO_EMPTY,
+    SSI_INVALID_CONFIG
 };
 
+// Byte clocked out while reading
+#define SSI_READ_FILL 0xFFU
+
+// Rate set by ssi0_init
+#define SSI0_DEFAULT_BITRATE 3000000UL
+
+enum ssi_instance
+{
+    SSI_INSTANCE_0,
+    SSI_INSTANCE_1,
+    SSI_INSTANCE_2,
+    SSI_INSTANCE_3,
+    SSI_INSTANCES
+};
+
+/**
+ * @brief   Pin options for each module. CLK, FSS, RX, TX in that order.
+ *          SSI1 and SSI3 can't both use port D. On the LaunchPad PD0/PD1 are
+ *          tied to PB6/PB7 through R9/R10, remove them to use SSI2 together
+ *          with SSI1 or SSI3 on port D.
+ *
+ */
+enum ssi_pinmux
+{
+    SSI_PINMUX_SSI0_PA2_PA5,    // PA2 PA3 PA4 PA5
+    SSI_PINMUX_SSI1_PF0_PF3,    // PF2 PF3 PF0 PF1
+    SSI_PINMUX_SSI1_PD0_PD3,    // PD0 PD1 PD2 PD3
+    SSI_PINMUX_SSI2_PB4_PB7,    // PB4 PB5 PB6 PB7
+    SSI_PINMUX_SSI3_PD0_PD3     // PD0 PD1 PD2 PD3
+};
+
+enum ssi_mode
+{
+    SSI_MODE_MASTER,
+    SSI_MODE_SLAVE,
+    // Slave that never drives its TX pin, for several slaves on one bus
+    SSI_MODE_SLAVE_OUTPUT_DISABLED
+};
+
+enum ssi_frame_format
+{
+    FREESCALE       =   (0U << 4U),
+    TEXASINST_SSF   =   (1U << 4U),
+    MICROWIRE       =   (2U << 4U)
+};
+
+enum ssi_clock_polarity
+{
+    STEADY_LOW  =   (0U << 6U),
+    // CLK pin pull up is enabled by ssi_init
+    STEADY_HIGH =   (1U << 6U)
+};
+
+enum ssi_data_capture_clk_phase
+{
+    FIRST_EDGE_TRANSITION   =   (0U << 7U),
+    SECOND_EDGE_TRANSITION  =   (1U << 7U)
+};
+
+enum ssi_datasize
+{
+    DATASIZE_4 = 0x03,
+    DATASIZE_5,
+    DATASIZE_6,
+    DATASIZE_7,
+    DATASIZE_8,
+    DATASIZE_9,
+    DATASIZE_10,
+    DATASIZE_11,
+    DATASIZE_12,
+    DATASIZE_13,
+    DATASIZE_14,
+    DATASIZE_15,
+    DATASIZE_16
+};
+
+/**
+ * @brief   SSI module register layout
+ *
+ */
+struct ssi_regs
+{
+    volatile uint32_t CR0;              // 0x000
+    volatile uint32_t CR1;              // 0x004
+    volatile uint32_t DR;               // 0x008
+    volatile uint32_t SR;               // 0x00C
+    volatile uint32_t CPSR;             // 0x010
+    volatile uint32_t IM;               // 0x014
+    volatile uint32_t RIS;              // 0x018
+    volatile uint32_t MIS;              // 0x01C
+    volatile uint32_t ICR;              // 0x020
+    volatile uint32_t DMACTL;           // 0x024
+    uint32_t RESERVED0[1000];           // 0x028
+    volatile uint32_t CC;               // 0xFC8
+};
+
+struct ssi_config
+{
+    enum ssi_pinmux pins;
+    enum ssi_mode mode;
+    enum ssi_frame_format frame_format;
+    enum ssi_clock_polarity polarity;
+    enum ssi_data_capture_clk_phase phase;
+    enum ssi_datasize datasize;
+    // Maximum bit rate in Hz. When non zero prescale and scr are derived from
+    // it and the system clock, again after every clock_set_frequency, otherwise
+    // they are used as given. In slave mode it is only checked against the
+    // SysClk / 12 limit
+    uint32_t bitrate;
+    // BR = SysClk / (prescale * (1 + scr)). Prescale must be even, 2 to 254
+    uint8_t prescale;
+    uint8_t scr;
+    // Leave FSS as a plain pin, chip select is driven by the caller
+    uint8_t software_fss;
+};
+
+// Frames buffered in each direction for interrupt driven transfers, power of 2
+#ifndef SSI_RING_SIZE
+#define SSI_RING_SIZE 64U
+#endif
+
+enum ssi_event
+{
+    // Every queued frame has been shifted out and its RX frame collected
+    SSI_EVENT_TX_COMPLETE,
+    // The RX FIFO overflowed before the ISR drained it
+    SSI_EVENT_RX_FIFO_OVERRUN,
+    // The RX ring was full, received frames were dropped
+    SSI_EVENT_RX_BUFFER_OVERRUN,
+    // A uDMA descriptor on the RX or TX channel finished
+    SSI_EVENT_DMA_RX_DONE,
+    SSI_EVENT_DMA_TX_DONE
+};
+
+struct ssi_handle;
+
+/**
+ * @brief   Called from the SSI interrupt
+ *
+ */
+typedef void (*ssi_callback)( struct ssi_handle * ssi, enum ssi_event event );
+
+struct ssi_ring
+{
+    uint16_t buffer[SSI_RING_SIZE];
+    volatile uint16_t head;
+    volatile uint16_t tail;
+};
+
+struct ssi_handle
+{
+    struct ssi_regs * regs;
+    enum ssi_instance instance;
+    // NVIC interrupt number
+    uint8_t irq;
+    // uDMA channels and their CHMAP encoding
+    uint8_t dma_rx_channel;
+    uint8_t dma_tx_channel;
+    uint8_t dma_encoding;
+    struct ssi_config config;
+    uint8_t initialised;
+
+    // Interrupt driven mode
+    struct ssi_ring tx;
+    struct ssi_ring rx;
+    ssi_callback callback;
+    // Keep received frames, otherwise they are discarded
+    uint8_t receive;
+    volatile uint8_t tx_active;
+    volatile uint32_t rx_dropped;
+
+    // Interrupt and DMA modes holding the core out of deep sleep
+    uint8_t deep_sleep_holds;
+};
+
+/**
+ * @brief   Get the handle of an SSI module
+ *
+ * @param instance Module
+ * @return struct ssi_handle*
+ */
+struct ssi_handle * ssi_get_handle( enum ssi_instance instance );
+
+/**
+ * @brief   Initialise an SSI module as master or slave
+ *
+ * @param ssi Module handle
+ * @param config Configuration, copied into the handle
+ * @return enum ssiret SSI_INVALID_CONFIG if the pins don't belong to the
+ *         module or the prescaler is out of range
+ */
+enum ssiret ssi_init( struct ssi_handle * ssi, const struct ssi_config * config );
+
+/**
+ * @brief   Wait for the module to go idle, stop it and release its clock and
+ *          port. ssi_init brings it back
+ *
+ * @param ssi Module handle
+ */
+void ssi_deinit( struct ssi_handle * ssi );
+
+/**
+ * @brief   Find the prescaler and serial clock rate giving the fastest bit
+ *          rate that doesn't exceed the requested one
+ *
+ * @param clock_hz SSI clock, the system clock
+ * @param bitrate Maximum bit rate in Hz
+ * @param prescale CPSDVSR storage
+ * @param scr SCR storage
+ * @return uint32_t Achieved bit rate in Hz, 0 if the rate is below the
+ *         slowest possible clock
+ */
+uint32_t ssi_calc_divisors( uint32_t clock_hz, uint32_t bitrate, uint8_t * prescale, uint8_t * scr );
+
+/**
+ * @brief   Change the bit rate of an initialised module from the current
+ *          system clock. Waits for the module to go idle first.
+ *
+ * @param ssi Module handle
+ * @param bitrate Maximum bit rate in Hz, e.g. the device's limit
+ * @param achieved Achieved bit rate storage, may be NULL
+ * @return enum ssiret SSI_INVALID_CONFIG if the rate can't be reached
+ */
+enum ssiret ssi_set_bitrate( struct ssi_handle * ssi, uint32_t bitrate, uint32_t * achieved );
+
+/**
+ * @brief   Bit rate the module is running at
+ *
+ * @param ssi Module handle
+ * @return uint32_t Bit rate in Hz
+ */
+uint32_t ssi_get_bitrate( struct ssi_handle * ssi );
+
+/**
+ * @brief   Write a frame to the TX FIFO and wait until it is shifted out.
+ *          The frame received meanwhile is discarded
+ *
+ * @param ssi Module handle
+ * @param frame Frame to write, datasize bits
+ * @return enum ssiret
+ */
+enum ssiret ssi_write( struct ssi_handle * ssi, uint16_t frame );
+
+/**
+ * @brief   Read a frame from the RX FIFO without waiting
+ *
+ * @param ssi Module handle
+ * @param frame Received frame storage pointer
+ * @return enum ssiret SSI_RX_FIFO_EMPTY if nothing was received
+ */
+enum ssiret ssi_read( struct ssi_handle * ssi, uint16_t * frame );
+
+/**
+ * @brief   Full duplex transfer streaming through the FIFO. Up to 8 frames are
+ *          kept in flight so the line never idles and the RX FIFO can't
+ *          overrun. Returns once the last frame is shifted out.
+ *          With DATASIZE_16 each frame carries two bytes, MSB first, so the
+ *          bytes go out in buffer order. Other sizes above 8 bits aren't
+ *          supported, sizes up to 8 bits send one byte per frame.
+ *
+ * @param ssi Module handle
+ * @param tx Bytes to send, NULL to send SSI_READ_FILL
+ * @param rx Received bytes storage, NULL to discard
+ * @param length Number of bytes, even for DATASIZE_16
+ * @return enum ssiret SSI_INVALID_CONFIG for an unsupported data size or length
+ */
+enum ssiret ssi_transfer( struct ssi_handle * ssi, const uint8_t * tx, uint8_t * rx, uint16_t length );
+
+/**
+ * @brief   Send a buffer, discarding received data. See ssi_transfer
+ *
+ * @param ssi Module handle
+ * @param tx Bytes to send
+ * @param length Number of bytes
+ * @return enum ssiret
+ */
+enum ssiret ssi_write_buf( struct ssi_handle * ssi, const uint8_t * tx, uint16_t length );
+
+/**
+ * @brief   Receive into a buffer while sending SSI_READ_FILL. See ssi_transfer
+ *
+ * @param ssi Module handle
+ * @param rx Received bytes storage
+ * @param length Number of bytes
+ * @return enum ssiret
+ */
+enum ssiret ssi_read_buf( struct ssi_handle * ssi, uint8_t * rx, uint16_t length );
+
+/**
+ * @brief   Wait until the TX FIFO is empty and the module is idle
+ *
+ * @param ssi Module handle
+ */
+void ssi_wait_idle( struct ssi_handle * ssi );
+
+/**
+ * @brief   Connect TX to RX inside the module, for self tests. The pins stay
+ *          configured but nothing external is received.
+ *
+ * @param ssi Initialised module handle
+ * @param enable 1 for loopback, 0 for normal operation
+ */
+void ssi_set_loopback( struct ssi_handle * ssi, uint8_t enable );
+
+/**
+ * @brief   Switch a module to interrupt driven transfers. TX frames are queued
+ *          in a ring and the ISR refills the FIFO each time it drops to half
+ *          empty, RX frames are drained on half full or receive timeout. The
+ *          CPU is free between refills. The module isn't clocked in deep
+ *          sleep, so the core stays out of it until ssi_irq_disable.
+ *
+ * @param ssi Initialised module handle
+ * @param callback Completion and overrun callback, may be NULL
+ * @param receive Keep received frames for ssi_irq_read, otherwise discard them
+ * @return enum ssiret
+ */
+enum ssiret ssi_irq_enable( struct ssi_handle * ssi, ssi_callback callback, uint8_t receive );
+
+/**
+ * @brief   Return a module to polled transfers, dropping queued frames
+ *
+ * @param ssi Module handle
+ */
+void ssi_irq_disable( struct ssi_handle * ssi );
+
+/**
+ * @brief   Queue frames for transmission without waiting
+ *
+ * @param ssi Module handle
+ * @param frames Frames to send
+ * @param count Number of frames
+ * @return uint16_t Number of frames queued, less than count if the ring filled
+ */
+uint16_t ssi_irq_write( struct ssi_handle * ssi, const uint16_t * frames, uint16_t count );
+
+/**
+ * @brief   Queue bytes for transmission without waiting
+ *
+ * @param ssi Module handle
+ * @param bytes Bytes to send
+ * @param count Number of bytes
+ * @return uint16_t Number of bytes queued, less than count if the ring filled
+ */
+uint16_t ssi_irq_write_bytes( struct ssi_handle * ssi, const uint8_t * bytes, uint16_t count );
+
+/**
+ * @brief   Take received frames out of the RX ring
+ *
+ * @param ssi Module handle
+ * @param frames Received frames storage
+ * @param max Storage size in frames
+ * @return uint16_t Number of frames read
+ */
+uint16_t ssi_irq_read( struct ssi_handle * ssi, uint16_t * frames, uint16_t max );
+
+/**
+ * @brief   Check for an interrupt driven transfer in progress
+ *
+ * @param ssi Module handle
+ * @return uint8_t 1 until the last queued frame is shifted out
+ */
+uint8_t ssi_irq_busy( struct ssi_handle * ssi );
+
+/**
+ * @brief   Hand the FIFOs to the uDMA controller. Channels are assigned here,
+ *          descriptors are set up by the caller on ssi->dma_rx_channel and
+ *          ssi->dma_tx_channel with the FIFO (&ssi->regs->DR) as the peripheral
+ *          end. Completions are reported as SSI_EVENT_DMA_RX_DONE/TX_DONE.
+ *          udma_init must have been called. The core stays out of deep sleep
+ *          until ssi_dma_disable.
+ *
+ * @param ssi Initialised module handle
+ * @param callback Completion callback, called from the SSI interrupt
+ * @param rx Enable RX DMA
+ * @param tx Enable TX DMA
+ * @return enum ssiret
+ */
+enum ssiret ssi_dma_enable( struct ssi_handle * ssi, ssi_callback callback, uint8_t rx, uint8_t tx );
+
+/**
+ * @brief   Stop both DMA channels and return the FIFOs to the CPU
+ *
+ * @param ssi Module handle
+ */
+void ssi_dma_disable( struct ssi_handle * ssi );
+
+/**
+ * @brief   SSI interrupt handlers, installed in the vector table
+ *
+ */
+void SSI0IntHandler( void );
+void SSI1IntHandler( void );
+void SSI2IntHandler( void );
+void SSI3IntHandler( void );
+
 /**
- * @brief   Initialise SSI0 to ~3Mbps
+ * @brief   Initialise SSI0 to ~3Mbps (SSI0_DEFAULT_BITRATE or the nearest below)
  *          CLK:                PA2
  *          Slave/Chip Select:  PA3
  *          MOSI:               PA5
- *          MISO:               PA4      
- * 
- * @return enum ssiret 
+ *          MISO:               PA4
+ *
+ * @return enum ssiret
  */
 enum ssiret ssi0_init( void );
 
 /**
  * @brief   Write a byte to SSI0 TX FIFO
- * 
+ *
  * @param byte Byte to write
- * @return enum ssiret 
+ * @return enum ssiret
  */
 enum ssiret ssi0_write( uint8_t byte );
 
 /**
  * @brief   Read a byte from SSI0 RX FIFO
- * 
+ *
  * @param byte Received byte storage pointer
- * @return enum ssiret 
+ * @return enum ssiret
  */
 enum ssiret ssi0_read( uint8_t * byte );
 
@@ -0,0 +1,81 @@
+#ifndef HAL_SSI_BENCH_H__
+#define HAL_SSI_BENCH_H__
+
+#include <stdint.h>
+
+#include "hal/ssi.h"
+#include "util/report.h"
+
+/*
+ * SSI throughput benchmark and loopback self test. The module runs in
+ * internal loopback (SSI_CR1_LBM) so no wiring is needed, and every transfer
+ * size is pushed through each driver path in turn. Cycles come from the DWT
+ * counter. CPU load is the share of those cycles the CPU was not free: the
+ * polled paths busy wait so they are always 100%, for the interrupt and DMA
+ * paths it is worked out from how often an idle loop ran meanwhile.
+ */
+
+enum ssi_bench_mode
+{
+    // ssi_write, one frame at a time, what ssi0_write does
+    SSI_BENCH_POLLED,
+    // ssi_transfer, FIFO kept full
+    SSI_BENCH_BULK,
+    // ssi_irq_write_bytes, refilled from the SSI interrupt
+    SSI_BENCH_IRQ,
+    // Basic mode uDMA on both channels
+    SSI_BENCH_DMA,
+    SSI_BENCH_MODES
+};
+
+// Transfer sizes tried, from 1 byte up to SSI_BENCH_MAX_LENGTH
+#define SSI_BENCH_SIZES 5U
+#define SSI_BENCH_MAX_LENGTH 1024U
+#define SSI_BENCH_RESULTS (SSI_BENCH_MODES * SSI_BENCH_SIZES)
+
+// A transfer that hasn't finished by then is reported as timed out
+#define SSI_BENCH_TIMEOUT_US 100000UL
+
+struct ssi_bench_result
+{
+    enum ssi_bench_mode mode;
+    uint16_t length;
+    // From the first register write to the last byte received
+    uint32_t cycles;
+    uint32_t bytes_per_second;
+    // Busy cycles per thousand, interrupts included
+    uint16_t cpu_load;
+    // Bytes received differently from what was sent. The polled path
+    // discards received bytes so it is never checked
+    uint16_t errors;
+    uint8_t timed_out;
+};
+
+// Writes one character of the report, e.g. uart0_write
+typedef report_put ssi_bench_put;
+
+/**
+ * @brief   Run every mode and size in loopback. The module is left
+ *          initialised, out of loopback and back in polled mode.
+ *          Initialises the DWT counter and the uDMA controller.
+ *
+ * @param instance SSI module
+ * @param pins Pin mux option of the module
+ * @param bitrate Bit rate in Hz
+ * @param results Results storage
+ * @param max Results storage size, SSI_BENCH_RESULTS for everything
+ * @return uint8_t Number of results
+ */
+uint8_t ssi_bench_run( enum ssi_instance instance, enum ssi_pinmux pins, uint32_t bitrate,
+                       struct ssi_bench_result * results, uint8_t max );
+
+/**
+ * @brief   Print results, one line each
+ *
+ * @param results Results from ssi_bench_run
+ * @param count Number of results
+ * @param put Character output
+ */
+void ssi_bench_report( const struct ssi_bench_result * results, uint8_t count, ssi_bench_put put );
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef HAL_SSI_STREAM_H__
+#define HAL_SSI_STREAM_H__
+
+#include <stdint.h>
+
+#include "hal/ssi.h"
+#include "hal/timer.h"
+#include "hal/udma.h"
+
+/*
+ * Continuous sampling to or from an external converter on an SSI master.
+ *
+ * A periodic timer paces the conversions: each timeout makes the uDMA
+ * controller write one frame to the SSI TX FIFO through the timer's channel.
+ * For input that frame is a fixed command word (the Microwire control byte,
+ * or the ADC's channel select) and the reply is moved by the SSI RX channel.
+ * For output the frames are the samples themselves. Both directions use two
+ * ping-pong blocks, so the CPU only runs once per block.
+ *
+ * Only timers with a uDMA channel can pace a stream, see timer_get_dma_channel.
+ */
+
+enum ssi_stream_ret
+{
+    SSI_STREAM_OK,
+    // Pins, timer or block size unusable, or the bit rate is too low for the
+    // sample rate
+    SSI_STREAM_INVALID_CONFIG
+};
+
+enum ssi_stream_direction
+{
+    // Converter to memory, ADCs
+    SSI_STREAM_INPUT,
+    // Memory to converter, DACs
+    SSI_STREAM_OUTPUT
+};
+
+struct ssi_stream;
+
+/**
+ * @brief   Called from interrupt context once per block. For input the block
+ *          holds new samples, for output it has been sent and should be refilled.
+ *          The block is handed back to the controller when this returns.
+ *
+ */
+typedef void (*ssi_stream_callback)( struct ssi_stream * stream, uint16_t * block, uint16_t samples );
+
+struct ssi_stream_config
+{
+    enum ssi_instance instance;
+    enum ssi_pinmux pins;
+    enum ssi_stream_direction direction;
+    // Wire format of the converter. Microwire sends an 8 bit command and
+    // receives datasize bits, so it is input only
+    enum ssi_frame_format frame_format;
+    enum ssi_datasize datasize;
+    // Freescale format only
+    enum ssi_clock_polarity polarity;
+    enum ssi_data_capture_clk_phase phase;
+    // Converter's maximum bit rate in Hz
+    uint32_t bitrate;
+    // Pacing timer and conversions per second
+    enum timer_instance timer;
+    uint32_t sample_rate;
+    // Input: frame sent to start each conversion
+    uint16_t command;
+    // Two blocks of block_samples each. Output blocks must be filled before
+    // ssi_stream_start
+    uint16_t * blocks[2];
+    uint16_t block_samples;
+    ssi_stream_callback callback;
+    // Passed back through stream->context
+    void * context;
+};
+
+struct ssi_stream
+{
+    struct ssi_handle * ssi;
+    enum ssi_stream_direction direction;
+    enum timer_instance timer;
+    uint8_t timer_channel;
+    uint16_t command;
+    uint16_t * blocks[2];
+    uint16_t block_samples;
+    ssi_stream_callback callback;
+    void * context;
+    // Block the controller finishes next
+    enum udma_select next;
+    // Achieved sample rate in Hz, and the one asked for, which the timer
+    // period is worked out from again when the system clock changes
+    uint32_t sample_rate;
+    uint32_t requested_rate;
+    volatile uint32_t blocks_done;
+    // Times both blocks finished before the callback returned and the
+    // stream stalled until it was restarted
+    volatile uint32_t overruns;
+    uint8_t running;
+};
+
+/**
+ * @brief   Configure the SSI module, pacing timer and uDMA channels. Initialises
+ *          the uDMA controller. One stream per SSI module and per timer.
+ *
+ * @param stream Stream storage, must stay valid while the stream runs
+ * @param config Stream settings
+ * @return enum ssi_stream_ret
+ */
+enum ssi_stream_ret ssi_stream_init( struct ssi_stream * stream, const struct ssi_stream_config * config );
+
+/**
+ * @brief   Arm both blocks and start the timer. The core stays out of deep
+ *          sleep until ssi_stream_stop
+ *
+ * @param stream Initialised stream
+ */
+void ssi_stream_start( struct ssi_stream * stream );
+
+/**
+ * @brief   Stop the timer and both uDMA channels. Samples of a partly
+ *          finished block are dropped.
+ *
+ * @param stream Stream
+ */
+void ssi_stream_stop( struct ssi_stream * stream );
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef HAL_TIMER_H__
+#define HAL_TIMER_H__
+
+#include <stdint.h>
+
+#include "tm4c123gh6pm.h"
+
+enum timerret
+{
+    TIMER_OK,
+    TIMER_INVALID_CONFIG
+};
+
+// 16/32-bit general purpose timers, used as 32-bit Timer A
+enum timer_instance
+{
+    TIMER_INSTANCE_0,
+    TIMER_INSTANCE_1,
+    TIMER_INSTANCE_2,
+    TIMER_INSTANCE_3,
+    TIMER_INSTANCE_4,
+    TIMER_INSTANCE_5,
+    TIMER_INSTANCES
+};
+
+// Returned by timer_get_dma_channel for timers without a uDMA channel here
+#define TIMER_NO_DMA_CHANNEL 0xFFU
+
+/**
+ * @brief   GPTM register layout
+ *
+ */
+struct timer_regs
+{
+    volatile uint32_t CFG;              // 0x000
+    volatile uint32_t TAMR;             // 0x004
+    volatile uint32_t TBMR;             // 0x008
+    volatile uint32_t CTL;              // 0x00C
+    volatile uint32_t SYNC;             // 0x010
+    uint32_t RESERVED0[1];              // 0x014
+    volatile uint32_t IMR;              // 0x018
+    volatile uint32_t RIS;              // 0x01C
+    volatile uint32_t MIS;              // 0x020
+    volatile uint32_t ICR;              // 0x024
+    volatile uint32_t TAILR;            // 0x028
+    volatile uint32_t TBILR;            // 0x02C
+    volatile uint32_t TAMATCHR;         // 0x030
+    volatile uint32_t TBMATCHR;         // 0x034
+    volatile uint32_t TAPR;             // 0x038
+    volatile uint32_t TBPR;             // 0x03C
+    volatile uint32_t TAPMR;            // 0x040
+    volatile uint32_t TBPMR;            // 0x044
+    volatile uint32_t TAR;              // 0x048
+    volatile uint32_t TBR;              // 0x04C
+    volatile uint32_t TAV;              // 0x050
+    volatile uint32_t TBV;              // 0x054
+    volatile uint32_t RTCPD;            // 0x058
+    volatile uint32_t TAPS;             // 0x05C
+    volatile uint32_t TBPS;             // 0x060
+    volatile uint32_t TAPV;             // 0x064
+    volatile uint32_t TBPV;             // 0x068
+    uint32_t RESERVED1[981];            // 0x06C
+    volatile uint32_t PP;               // 0xFC0
+    uint32_t RESERVED2[1];              // 0xFC4
+    volatile uint32_t CC;               // 0xFC8
+};
+
+// CC: count the alternate clock, PIOSC out of reset, instead of the system clock
+#define TIMER_CC_ALTCLK 0x00000001U
+
+/**
+ * @brief   Called from the Timer A interrupt, after the timeout flag has been
+ *          cleared. uDMA completions on the timer's channel arrive here too.
+ *
+ */
+typedef void (*timer_callback)( enum timer_instance instance );
+
+/**
+ * @brief   Get the registers of a timer
+ *
+ * @param instance Timer
+ * @return struct timer_regs*
+ */
+struct timer_regs * timer_get_regs( enum timer_instance instance );
+
+/**
+ * @brief   Configure a timer as a 32-bit periodic down counter, stopped.
+ *          A timeout every period system clock cycles requests a uDMA burst
+ *          on the timer's channel.
+ *
+ * @param instance Timer
+ * @param period Cycles between timeouts, 2 or more
+ * @return enum timerret
+ */
+enum timerret timer_init_periodic( enum timer_instance instance, uint32_t period );
+
+/**
+ * @brief   Configure a timer as a 32-bit one-shot down counter, stopped. It
+ *          times out once, period cycles after timer_start, and stops.
+ *
+ * @param instance Timer
+ * @param period Cycles to the timeout, 2 or more
+ * @return enum timerret
+ */
+enum timerret timer_init_oneshot( enum timer_instance instance, uint32_t period );
+
+/**
+ * @brief   Change the period of a periodic timer. A running timer picks it up
+ *          at its next timeout.
+ *
+ * @param instance Timer
+ * @param period Cycles between timeouts, 2 or more
+ * @return enum timerret
+ */
+enum timerret timer_set_period( enum timer_instance instance, uint32_t period );
+
+/**
+ * @brief   Set the period of a periodic timer from a timeout rate. The rate
+ *          is kept across system clock changes; timer_set_period and
+ *          timer_init_periodic go back to a fixed period in cycles.
+ *
+ * @param instance Timer
+ * @param hz Timeouts per second, up to SystemCoreClock / 2
+ * @return enum timerret
+ */
+enum timerret timer_set_rate( enum timer_instance instance, uint32_t hz );
+
+/**
+ * @brief   Start counting, stalled while the debugger halts the core
+ *
+ * @param instance Timer
+ */
+void timer_start( enum timer_instance instance );
+
+/**
+ * @brief   Stop counting
+ *
+ * @param instance Timer
+ */
+void timer_stop( enum timer_instance instance );
+
+/**
+ * @brief   Count PIOSC instead of the system clock, so the timer keeps its
+ *          rate across clock changes and in deep sleep. Call while stopped;
+ *          periods are then in PIOSC cycles and timer_set_rate doesn't apply.
+ *
+ * @param instance Timer
+ * @param enable 1 for PIOSC, 0 for the system clock
+ */
+void timer_set_alt_clock( enum timer_instance instance, uint8_t enable );
+
+/**
+ * @brief   Stop a timer and release its clock. timer_init_periodic brings it
+ *          back
+ *
+ * @param instance Timer
+ */
+void timer_deinit( enum timer_instance instance );
+
+/**
+ * @brief   Set the interrupt callback and enable the timer's NVIC interrupt.
+ *          The timeout interrupt itself is left masked, enable it through
+ *          IMR if timeouts should interrupt.
+ *
+ * @param instance Timer
+ * @param callback Callback, NULL to disable the NVIC interrupt
+ */
+void timer_set_callback( enum timer_instance instance, timer_callback callback );
+
+/**
+ * @brief   uDMA channel serving Timer A timeouts
+ *
+ * @param instance Timer
+ * @param encoding CHMAP encoding storage
+ * @return uint8_t Channel, TIMER_NO_DMA_CHANNEL if none is mapped
+ */
+uint8_t timer_get_dma_channel( enum timer_instance instance, uint8_t * encoding );
+
+/**
+ * @brief   Timer A interrupt handlers, installed in the vector table
+ *
+ */
+void Timer0AIntHandler( void );
+void Timer1AIntHandler( void );
+void Timer2AIntHandler( void );
+void Timer3AIntHandler( void );
+void Timer4AIntHandler( void );
+void Timer5AIntHandler( void );
+
+#endif
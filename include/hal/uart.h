@@ -0,0 +1,51 @@
+#ifndef HAL_UART_H__
+#define HAL_UART_H__
+
+#include <stdint.h>
+
+#include "tm4c123gh6pm.h"
+
+enum uartret
+{
+    UART_OK,
+    UART_TX_FIFO_FULL,
+    UART_RX_FIFO_EMPTY,
+    UART_RX_ERROR
+};
+
+/**
+ * @brief   Initialise UART0 8N1 with FIFOs enabled
+ *          RX:     PA0
+ *          TX:     PA1
+ * 
+ * @param baud Baud rate, e.g. 115200
+ * @return enum uartret 
+ */
+enum uartret uart0_init( uint32_t baud );
+
+/**
+ * @brief   Write a byte to the UART0 TX FIFO, waiting for space
+ * 
+ * @param byte Byte to write
+ * @return enum uartret 
+ */
+enum uartret uart0_write( uint8_t byte );
+
+/**
+ * @brief   Write a byte to the UART0 TX FIFO without waiting
+ * 
+ * @param byte Byte to write
+ * @return enum uartret UART_TX_FIFO_FULL if the byte was not queued
+ */
+enum uartret uart0_try_write( uint8_t byte );
+
+/**
+ * @brief   Read a byte from the UART0 RX FIFO without waiting
+ * 
+ * @param byte Received byte storage pointer
+ * @return enum uartret UART_RX_FIFO_EMPTY if nothing was received,
+ *         UART_RX_ERROR if the byte had a framing/parity/overrun error
+ */
+enum uartret uart0_read( uint8_t * byte );
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef HAL_UDMA_H__
+#define HAL_UDMA_H__
+
+#include <stdint.h>
+
+#include "tm4c123gh6pm.h"
+
+#define UDMA_CHANNELS 32U
+// Items moved by one descriptor
+#define UDMA_MAX_TRANSFER 1024U
+// Channel with no peripheral behind it, for memory to memory transfers
+#define UDMA_CHANNEL_SOFTWARE 30U
+// A scatter-gather list is copied by one transfer of 4 words per task
+#define UDMA_MAX_TASKS (UDMA_MAX_TRANSFER / 4U)
+
+enum udmaret
+{
+    UDMA_OK,
+    UDMA_INVALID_CHANNEL,
+    UDMA_INVALID_SIZE,
+    UDMA_BUSY
+};
+
+enum udma_select
+{
+    UDMA_PRIMARY,
+    UDMA_ALTERNATE
+};
+
+/**
+ * @brief   Channel control structure entry, as read by the controller. Also
+ *          the layout of a scatter-gather task.
+ *
+ */
+struct udma_descriptor
+{
+    volatile void * src_end;
+    volatile void * dst_end;
+    volatile uint32_t control;
+    uint32_t reserved;
+};
+
+/**
+ * @brief   Called from the uDMA software interrupt when a channel completes
+ *
+ */
+typedef void (*udma_callback)( uint8_t channel );
+
+/**
+ * @brief   Called from the uDMA error interrupt. The controller has already
+ *          disabled the channel that caused the bus error.
+ *
+ */
+typedef void (*udma_error_callback)( void );
+
+// Control word for byte transfers from a peripheral FIFO into a buffer
+#define UDMA_PERIPHERAL_TO_MEMORY_8 \
+        (UDMA_CHCTL_DSTINC_8 | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_8)
+
+// Control word for byte transfers from a buffer into a peripheral FIFO
+#define UDMA_MEMORY_TO_PERIPHERAL_8 \
+        (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_SRCSIZE_8)
+
+// Control word for writing the same byte to a peripheral register
+#define UDMA_FIXED_TO_PERIPHERAL_8 \
+        (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_8)
+
+// Halfword versions, for frames wider than 8 bits
+#define UDMA_PERIPHERAL_TO_MEMORY_16 \
+        (UDMA_CHCTL_DSTINC_16 | UDMA_CHCTL_DSTSIZE_16 | UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_16)
+#define UDMA_MEMORY_TO_PERIPHERAL_16 \
+        (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_16 | UDMA_CHCTL_SRCINC_16 | UDMA_CHCTL_SRCSIZE_16)
+
+// Control word for writing the same halfword to a peripheral register
+#define UDMA_FIXED_TO_PERIPHERAL_16 \
+        (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_16 | UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_16)
+
+// Control word for word copies between buffers, UDMA_CHCTL_XFERMODE_AUTO for
+// software channels
+#define UDMA_MEMORY_TO_MEMORY_32 \
+        (UDMA_CHCTL_DSTINC_32 | UDMA_CHCTL_DSTSIZE_32 | UDMA_CHCTL_SRCINC_32 | UDMA_CHCTL_SRCSIZE_32)
+
+/**
+ * @brief   Enable the uDMA controller, clear the control table and point the
+ *          controller at it. Enables the error interrupt. Only the first
+ *          call does anything, so every driver using DMA can call it.
+ *
+ */
+void udma_init( void );
+
+/**
+ * @brief   Select the peripheral a channel serves and reset its attributes:
+ *          single and burst requests, primary descriptor, default priority
+ *
+ * @param channel Channel 0:31
+ * @param encoding CHMAP encoding, see the datasheet channel assignment table
+ * @return enum udmaret
+ */
+enum udmaret udma_assign_channel( uint8_t channel, uint8_t encoding );
+
+/**
+ * @brief   Ignore single requests on a channel. Needed for peripherals that
+ *          only raise burst requests, such as the GPTM.
+ *
+ * @param channel Channel 0:31
+ */
+void udma_set_burst_only( uint8_t channel );
+
+/**
+ * @brief   Serve a channel ahead of default priority channels, e.g. an RX
+ *          channel that must not let its FIFO overrun
+ *
+ * @param channel Channel 0:31
+ */
+void udma_set_high_priority( uint8_t channel );
+
+/**
+ * @brief   Fill in a descriptor. The end pointers are worked out from the
+ *          increments in control. For ping-pong, fill in both descriptors
+ *          with UDMA_CHCTL_XFERMODE_PINGPONG and refill each as it completes.
+ *
+ * @param channel Channel 0:31
+ * @param select Primary or alternate descriptor
+ * @param control Increment, size and arbitration bits plus UDMA_CHCTL_XFERMODE_*
+ * @param src Source start
+ * @param dst Destination start
+ * @param count Items to move, 1:UDMA_MAX_TRANSFER
+ * @return enum udmaret
+ */
+enum udmaret udma_set_transfer( uint8_t channel, enum udma_select select, uint32_t control,
+                                volatile void * src, volatile void * dst, uint16_t count );
+
+/**
+ * @brief   Fill in a scatter-gather task. The mode is set by
+ *          udma_set_scatter_gather.
+ *
+ * @param task Task list entry
+ * @param control Increment, size and arbitration bits
+ * @param src Source start
+ * @param dst Destination start
+ * @param count Items to move, 1:UDMA_MAX_TRANSFER
+ * @return enum udmaret
+ */
+enum udmaret udma_set_task( struct udma_descriptor * task, uint32_t control,
+                            volatile void * src, volatile void * dst, uint16_t count );
+
+/**
+ * @brief   Point a channel's primary descriptor at a task list. Each task
+ *          is copied into the alternate descriptor and run in turn; the
+ *          last one completes the channel. The list must stay in place
+ *          until then.
+ *
+ * @param channel Channel 0:31
+ * @param tasks Task list, modes are rewritten
+ * @param count Tasks, 1:UDMA_MAX_TASKS
+ * @param peripheral 0 to run the whole list on one request (memory to
+ *                   memory), 1 to run each task on the peripheral's requests
+ * @return enum udmaret
+ */
+enum udmaret udma_set_scatter_gather( uint8_t channel, struct udma_descriptor * tasks, uint16_t count,
+                                      uint8_t peripheral );
+
+/**
+ * @brief   Start servicing requests on a channel
+ *
+ * @param channel Channel 0:31
+ */
+void udma_enable( uint8_t channel );
+
+/**
+ * @brief   Stop a channel
+ *
+ * @param channel Channel 0:31
+ */
+void udma_disable( uint8_t channel );
+
+/**
+ * @brief   Check whether a channel is enabled. The controller disables a
+ *          channel once it reaches a stop descriptor.
+ *
+ * @param channel Channel 0:31
+ * @return uint8_t 1 if enabled
+ */
+uint8_t udma_is_enabled( uint8_t channel );
+
+/**
+ * @brief   Transfer mode of a descriptor. UDMA_CHCTL_XFERMODE_STOP once the
+ *          controller has finished with it.
+ *
+ * @param channel Channel 0:31
+ * @param select Primary or alternate descriptor
+ * @return uint32_t UDMA_CHCTL_XFERMODE_*
+ */
+uint32_t udma_get_mode( uint8_t channel, enum udma_select select );
+
+/**
+ * @brief   Items a descriptor still has to move
+ *
+ * @param channel Channel 0:31
+ * @param select Primary or alternate descriptor
+ * @return uint16_t Items left
+ */
+uint16_t udma_get_remaining( uint8_t channel, enum udma_select select );
+
+/**
+ * @brief   Request a transfer from software, for channels without a
+ *          peripheral or to start an AUTO transfer
+ *
+ * @param channel Channel 0:31
+ */
+void udma_request( uint8_t channel );
+
+/**
+ * @brief   Check and clear a channel's completion flag. For peripheral
+ *          channels completion is signalled on the peripheral's interrupt.
+ *
+ * @param channel Channel 0:31
+ * @return uint8_t 1 if the channel completed since the last call
+ */
+uint8_t udma_take_interrupt( uint8_t channel );
+
+/**
+ * @brief   Set the completion callback of a software requested channel and
+ *          enable the uDMA software interrupt. Peripheral channels complete
+ *          on the peripheral's interrupt, use udma_take_interrupt there.
+ *
+ * @param channel Channel 0:31
+ * @param callback Callback, NULL to poll with udma_is_enabled instead
+ */
+void udma_set_callback( uint8_t channel, udma_callback callback );
+
+/**
+ * @brief   Set the bus error callback
+ *
+ * @param callback Callback, NULL for none
+ */
+void udma_set_error_callback( udma_error_callback callback );
+
+/**
+ * @brief   Bus errors seen since udma_init
+ *
+ * @return uint32_t Errors
+ */
+uint32_t udma_get_error_count( void );
+
+void UDMAIntHandler( void );
+void UDMAErrorIntHandler( void );
+
+#endif
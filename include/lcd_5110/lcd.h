@@ -6,18 +6,60 @@
 #include "hal/gpio.h"
 #include "hal/ssi.h"
 
+// Screen geometry. Each bank is a row of COLUMNS bytes, 8 pixels tall
+#define LCD_5110_COLUMNS 84U
+#define LCD_5110_BANKS 6U
+#define LCD_5110_BUFFER_SIZE (LCD_5110_COLUMNS * LCD_5110_BANKS)
+
+// Largest UI state kept with the displayed frame across a warm reset
+#define LCD_5110_UI_STATE_SIZE 32U
+
+// PCD8544 serial interface limit
+#define LCD_5110_MAX_BITRATE 4000000UL
+
+// Glyph columns plus one blank padding column either side
+#define LCD_5110_GLYPH_WIDTH 5U
+#define LCD_5110_CHAR_WIDTH (LCD_5110_GLYPH_WIDTH + 2U)
+
 enum lcd_5110_font
 {
     LCD_5110_FONT_COURSE = 0,
     LCD_5110_FONT_MINE = 1,
 };
 
+/**
+ * @brief   Supplies the glyphs of a font that isn't built in, e.g. from
+ *          external flash. The returned columns only need to stay valid until
+ *          the next lookup.
+ * 
+ */
+typedef const char *(*lcd_glyph_source)(enum lcd_5110_font font, char character);
+
 enum lcd_5110_text_mode
 {
     LCD_5110_TEXT_MODE_NORMAL = 0x00U,
     LCD_5110_TEXT_MODE_INVERSE = 0
 };
 
+#ifdef LCD_5110_TRACE
+/**
+ * @brief   Provided by the application when built with LCD_5110_TRACE.
+ *          Called for every byte sent to the panel, e.g. to capture the stream
+ *          for the host PCD8544 model in tools/pcd8544_model
+ * 
+ * @param is_data 1 when D/C' selects display data, 0 for a command
+ * @param byte Byte sent
+ */
+void lcd_trace_byte(uint8_t is_data, uint8_t byte);
+
+/**
+ * @brief   Provided by the application when built with LCD_5110_TRACE.
+ *          Called after lcd_display or lcd_display_dirty has pushed a frame
+ * 
+ */
+void lcd_trace_frame(void);
+#endif
+
 /**
  * @brief   Initialiase LCD to use SSI0
  * 
@@ -30,6 +72,70 @@ void lcd_init(void);
  */
 void lcd_display(void);
 
+/**
+ * @brief   Push only the regions of the screen buffer that changed since the
+ *          last lcd_display or lcd_display_dirty
+ * 
+ */
+void lcd_display_dirty(void);
+
+/**
+ * @brief   Push one span of a bank of the screen buffer now, e.g. as soon as
+ *          it has been loaded. It counts as shown for a warm reset
+ * 
+ * @param bank Bank 0:5
+ * @param start_x First column
+ * @param end_x Last column, inclusive
+ */
+void lcd_display_span(uint8_t bank, uint8_t start_x, uint8_t end_x);
+
+/**
+ * @brief   Mark a span of columns in a bank as changed so lcd_display_dirty sends it
+ * 
+ * @param bank Bank 0:5
+ * @param start_x First changed column
+ * @param end_x Last changed column, inclusive
+ */
+void lcd_mark_dirty(uint8_t bank, uint8_t start_x, uint8_t end_x);
+
+/**
+ * @brief   Send display data straight to the panel at its current address,
+ *          as set by lcd_nb_set_cursor. The screen buffer is not changed.
+ * 
+ * @param data Column bytes, LSB at the top
+ * @param length Number of bytes
+ */
+void lcd_write_data(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief   Direct access to the bank ordered screen buffer, LCD_5110_BUFFER_SIZE bytes.
+ *          Callers writing to it must mark what they changed with lcd_mark_dirty.
+ * 
+ * @return uint8_t* Screen buffer
+ */
+uint8_t *lcd_get_screen_buffer(void);
+
+/**
+ * @brief   Keep application state with each displayed frame, e.g. what the
+ *          screen is showing and animation positions. Every lcd_display and
+ *          lcd_display_dirty takes a copy along with the frame, so after a
+ *          warm reset the state matches what the panel shows.
+ * 
+ * @param state State to copy at each display, NULL to stop
+ * @param size Bytes, up to LCD_5110_UI_STATE_SIZE
+ */
+void lcd_set_ui_state(const void *state, uint8_t size);
+
+/**
+ * @brief   Get the UI state saved with the frame lcd_init restored after a
+ *          warm reset
+ * 
+ * @param state State storage
+ * @param size Bytes expected, must match the size it was saved with
+ * @return uint8_t 1 if restored, 0 after a cold start
+ */
+uint8_t lcd_get_ui_state(void *state, uint8_t size);
+
 /**
  * @brief   Write a single pixel to te buffer at the current pixel cursor 
  * 
@@ -74,6 +180,37 @@ void lcd_nb_set_cursor(uint8_t column, uint8_t screen_bank);
  */
 void lcd_write_byte(uint8_t byte);
 
+/**
+ * @brief   Column data of a character in a font
+ * 
+ * @param font Font to use
+ * @param character Character to look up
+ * @return const char* FONT_WIDTH (5) column bytes, LSB at the top
+ */
+const char *lcd_get_glyph(enum lcd_5110_font font, char character);
+
+/**
+ * @brief   Take a font's glyphs from a source instead of the built in table
+ * 
+ * @param font Font to replace
+ * @param source Glyph lookup, NULL to go back to the built in table
+ */
+void lcd_set_glyph_source(enum lcd_5110_font font, lcd_glyph_source source);
+
+/**
+ * @brief   Select the font used by the character and string writers
+ * 
+ * @param font Font to use
+ */
+void lcd_set_font(enum lcd_5110_font font);
+
+/**
+ * @brief   Write a padded character to the screen buffer at the pixel cursor
+ * 
+ * @param character Character to write
+ */
+void lcd_write_char(char character);
+
 /**
  * @brief   Write a string to the screen buffer
  *          String will wrap around to the x=0 if it's too long
@@ -0,0 +1,101 @@
+#ifndef LCD_5110_BENCH_H__
+#define LCD_5110_BENCH_H__
+
+#include <stdint.h>
+
+#include "util/report.h"
+
+/*
+ * Flash against SRAM execution of the LCD_HOT screen buffer functions. With
+ * LCD_BENCH defined lcd.c builds each of them twice from the same body, once
+ * in flash and once in .ramfunc, and the benchmark runs both on the screen
+ * buffer, leaving it cleared. Cycles come from the DWT counter, the best of
+ * LCD_BENCH_REPEATS runs so an interrupt doesn't skew a result. Use it at the
+ * clock the product runs at: below 40MHz flash has no wait states.
+ */
+
+enum lcd_bench_loop
+{
+    // lcd_buffer_checksum over the frame
+    LCD_BENCH_CHECKSUM,
+    // lcd_clear_screen_buffer
+    LCD_BENCH_CLEAR,
+    // A row of lcd_write_byte on a bank boundary, as for text
+    LCD_BENCH_WRITE_ALIGNED,
+    // A row of lcd_write_byte off a bank boundary, a bit at a time
+    LCD_BENCH_WRITE_UNALIGNED,
+    LCD_BENCH_LOOPS
+};
+
+#define LCD_BENCH_REPEATS 8U
+
+struct lcd_bench_result
+{
+    enum lcd_bench_loop loop;
+    uint32_t flash_cycles;
+    uint32_t sram_cycles;
+};
+
+// lcd_printf load: a screen of fields redrawn at a display rate, against a
+// CPU budget in hundredths of a percent
+#define LCD_BENCH_PRINT_FIELDS 10U
+#define LCD_BENCH_PRINT_HZ 50U
+#define LCD_BENCH_PRINT_BUDGET 500U
+
+struct lcd_bench_print_result
+{
+    // Best time to print every field once
+    uint32_t cycles;
+    // CPU load at LCD_BENCH_PRINT_HZ, hundredths of a percent
+    uint32_t cpu_load;
+};
+
+// Writes one character of the report, e.g. uart0_write
+typedef report_put lcd_bench_put;
+
+/**
+ * @brief   Copies of the LCD_HOT functions, built by lcd.c with LCD_BENCH
+ *
+ */
+uint32_t lcd_bench_checksum_flash(void);
+uint32_t lcd_bench_checksum_sram(void);
+void lcd_bench_write_byte_flash(uint8_t byte);
+void lcd_bench_write_byte_sram(uint8_t byte);
+void lcd_bench_clear_flash(void);
+void lcd_bench_clear_sram(void);
+
+/**
+ * @brief   Run every function from flash and from SRAM. Initialises the DWT
+ *          counter
+ *
+ * @param results Results storage, LCD_BENCH_LOOPS entries
+ */
+void lcd_bench_run(struct lcd_bench_result *results);
+
+/**
+ * @brief   Time LCD_BENCH_PRINT_FIELDS lcd_printf_at fields of mixed
+ *          conversions and work out the CPU load of redrawing them at
+ *          LCD_BENCH_PRINT_HZ. Leaves the screen buffer cleared
+ *
+ * @param result Result storage
+ */
+void lcd_bench_print_run(struct lcd_bench_print_result *result);
+
+/**
+ * @brief   Print the lcd_printf load and whether it is within
+ *          LCD_BENCH_PRINT_BUDGET
+ *
+ * @param result Result from lcd_bench_print_run
+ * @param put Character output
+ */
+void lcd_bench_print_report(const struct lcd_bench_print_result *result, lcd_bench_put put);
+
+/**
+ * @brief   Print results, one line each
+ *
+ * @param results Results from lcd_bench_run
+ * @param put Character output
+ */
+void lcd_bench_report(const struct lcd_bench_result *results, lcd_bench_put put);
+
+#endif
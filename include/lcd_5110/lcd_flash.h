@@ -0,0 +1,74 @@
+#ifndef LCD_5110_FLASH_H__
+#define LCD_5110_FLASH_H__
+
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+#include "spi_nor/spi_nor.h"
+
+// Glyphs kept in SRAM, power of 2
+#define LCD_FLASH_GLYPH_SLOTS 32U
+
+// Fonts in flash use the built in layout: LCD_5110_GLYPH_WIDTH bytes per
+// character, LCD_FLASH_FONT_CHARACTERS characters from ' '
+#define LCD_FLASH_FONT_CHARACTERS 97U
+
+struct lcd_flash_stats
+{
+    uint32_t glyph_hits;
+    uint32_t glyph_misses;
+    // Flash reads that failed, drawn as blanks
+    uint32_t read_errors;
+};
+
+/**
+ * @brief   Use a flash device for fonts and images. Drops cached glyphs.
+ *
+ * @param nor Initialised flash device
+ */
+void lcd_flash_attach(struct spi_nor *nor);
+
+/**
+ * @brief   Take a font's glyphs from flash, through the SRAM glyph cache
+ *
+ * @param font Font to replace
+ * @param address Flash address of the glyph for ' '
+ * @return enum spi_nor_ret SPI_NOR_OUT_OF_RANGE if the font doesn't fit the part
+ */
+enum spi_nor_ret lcd_flash_set_font(enum lcd_5110_font font, uint32_t address);
+
+/**
+ * @brief   DMA a bank ordered image from flash into the screen buffer and mark
+ *          it dirty. Images are width bytes per bank, LSB at the top.
+ *
+ * @param address Flash address of the image
+ * @param x First column
+ * @param bank First bank
+ * @param width Columns
+ * @param banks Banks
+ * @return enum spi_nor_ret SPI_NOR_OUT_OF_RANGE if it doesn't fit the screen
+ */
+enum spi_nor_ret lcd_flash_load_image(uint32_t address, uint8_t x, uint8_t bank, uint8_t width, uint8_t banks);
+
+/**
+ * @brief   As lcd_flash_load_image, but each bank is sent to the panel as soon
+ *          as it lands while the next one is read, so the image appears at the
+ *          panel's bus speed. No lcd_display needed for the image.
+ *
+ * @param address Flash address of the image
+ * @param x First column
+ * @param bank First bank
+ * @param width Columns
+ * @param banks Banks
+ * @return enum spi_nor_ret
+ */
+enum spi_nor_ret lcd_flash_show_image(uint32_t address, uint8_t x, uint8_t bank, uint8_t width, uint8_t banks);
+
+/**
+ * @brief   Read glyph cache statistics
+ *
+ * @param stats Statistics storage
+ */
+void lcd_flash_get_stats(struct lcd_flash_stats *stats);
+
+#endif
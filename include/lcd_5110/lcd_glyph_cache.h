@@ -0,0 +1,69 @@
+#ifndef LCD_5110_GLYPH_CACHE_H__
+#define LCD_5110_GLYPH_CACHE_H__
+
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+
+// SRAM set aside for pre-rendered labels
+#define LCD_GLYPH_CACHE_ARENA_SIZE 512U
+// Maximum number of labels cached at once
+#define LCD_GLYPH_CACHE_ENTRIES 16U
+
+struct lcd_glyph_cache_stats
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    // Labels too large for the arena, drawn without caching
+    uint32_t uncached;
+    // Arena bytes currently holding bitmaps
+    uint16_t arena_used;
+    uint8_t entries;
+};
+
+/**
+ * @brief   Draw a static label into the screen buffer using the glyph-run cache.
+ *          The first draw rasterises the string once into a bank ordered bitmap,
+ *          later draws with the same string pointer, font, y bit offset and
+ *          inversion are a single blit. Only the label's own columns are drawn.
+ *
+ *          Labels are keyed by pointer, so the string contents must not change
+ *          while cached. Call lcd_glyph_cache_invalidate if they do.
+ *
+ * @param x Column to start writing from
+ * @param y Row to start writing from, any pixel row
+ * @param font Font to render with
+ * @param inverse Invert the label
+ * @param string Label text
+ */
+void lcd_glyph_cache_draw(uint8_t x, uint8_t y, enum lcd_5110_font font, uint8_t inverse, const char *string);
+
+/**
+ * @brief   Drop every cached bitmap of a string
+ *
+ * @param string Label text pointer used when drawing
+ */
+void lcd_glyph_cache_invalidate(const char *string);
+
+/**
+ * @brief   Drop all cached bitmaps
+ *
+ */
+void lcd_glyph_cache_clear(void);
+
+/**
+ * @brief   Read cache statistics
+ *
+ * @param stats Statistics storage
+ */
+void lcd_glyph_cache_get_stats(struct lcd_glyph_cache_stats *stats);
+
+/**
+ * @brief   Cache hit rate since the last clear
+ *
+ * @return uint16_t Hits per thousand lookups
+ */
+uint16_t lcd_glyph_cache_hit_rate(void);
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef LCD_5110_PRINT_H__
+#define LCD_5110_PRINT_H__
+
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+
+// Fractional bits used by the %q conversion of lcd_printf (Q16.16)
+#define LCD_PRINT_Q_BITS 16U
+
+/**
+ * @brief   Print an unsigned integer to the screen buffer at the pixel cursor
+ *
+ * @param value Value to print
+ * @param width Minimum field width in characters
+ * @param pad Padding character, ' ' or '0'
+ */
+void lcd_print_uint(uint32_t value, uint8_t width, char pad);
+
+/**
+ * @brief   Print a signed integer to the screen buffer at the pixel cursor.
+ *          With '0' padding the sign is printed before the zeros.
+ *
+ * @param value Value to print
+ * @param width Minimum field width in characters, including the sign
+ * @param pad Padding character, ' ' or '0'
+ */
+void lcd_print_int(int32_t value, uint8_t width, char pad);
+
+/**
+ * @brief   Print an unsigned integer as hexadecimal to the screen buffer
+ *
+ * @param value Value to print
+ * @param width Minimum field width in characters
+ * @param pad Padding character, ' ' or '0'
+ * @param upper Use upper case digits A-F
+ */
+void lcd_print_hex(uint32_t value, uint8_t width, char pad, uint8_t upper);
+
+/**
+ * @brief   Print a signed fixed-point value to the screen buffer, rounded to
+ *          the requested number of decimals
+ *
+ * @param value Fixed-point value
+ * @param frac_bits Number of fractional bits in value (0 - 31)
+ * @param decimals Decimal places to print (0 - 9)
+ * @param width Minimum field width in characters, including sign and point
+ * @param pad Padding character, ' ' or '0'
+ */
+void lcd_print_fixed(int32_t value, uint8_t frac_bits, uint8_t decimals, uint8_t width, char pad);
+
+/**
+ * @brief   Minimal formatted print straight into the screen buffer.
+ *          Glyphs are streamed as they are produced, no string is built.
+ *          Supports %[0][width][.precision] followed by:
+ *              d, i    signed integer
+ *              u       unsigned integer
+ *              x, X    hexadecimal
+ *              q       Q16.16 fixed-point, precision = decimals (default 2)
+ *              c       character
+ *              s       string
+ *              %       literal '%'
+ *          Characters the font can't show, e.g. '\n', print as '?'.
+ *
+ * @param format Format string
+ * @param ... Arguments
+ */
+void lcd_printf(const char *format, ...);
+
+/**
+ * @brief   Set the pixel cursor then print formatted text
+ *
+ * @param x Column to start writing from
+ * @param y Row to start writing from
+ * @param format Format string, see lcd_printf
+ * @param ... Arguments
+ */
+void lcd_printf_at(uint8_t x, uint8_t y, const char *format, ...);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef LCD_5110_REMOTE_H__
+#define LCD_5110_REMOTE_H__
+
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+
+/*
+ * Remote framebuffer protocol over UART0
+ *
+ * Every message is framed as:
+ *      0xA5 0x5A TYPE SEQ LEN_LO LEN_HI PAYLOAD[LEN] CRC8
+ * CRC8 (polynomial 0x07) covers TYPE through the end of PAYLOAD.
+ *
+ * KEYFRAME payload is the raw LCD_5110_BUFFER_SIZE byte screen buffer.
+ * DELTA payload is the frame XORed with the previous frame, run length coded:
+ *      0x00 - 0x7F     skip (n + 1) unchanged bytes
+ *      0x80 - 0xFF     (n & 0x7F) + 1 XOR bytes follow
+ * A delta must have SEQ one greater than the frame it applies to.
+ *
+ * Both directions use a window of one frame: the sender waits for the ACK
+ * carrying its SEQ before sending another frame. A NAK asks the sender to
+ * resynchronise with a keyframe.
+ */
+
+#define LCD_REMOTE_BAUD 115200UL
+
+enum lcd_remote_type
+{
+    LCD_REMOTE_KEYFRAME = 0x01,
+    LCD_REMOTE_DELTA = 0x02,
+    LCD_REMOTE_ACK = 0x03,
+    LCD_REMOTE_NAK = 0x04
+};
+
+enum lcd_remote_status
+{
+    LCD_REMOTE_OK,
+    // Waiting for the peer to acknowledge the previous frame
+    LCD_REMOTE_BUSY,
+    // Screen buffer matches the last frame sent
+    LCD_REMOTE_NO_CHANGE,
+    // A received frame was applied to the screen buffer
+    LCD_REMOTE_FRAME_APPLIED,
+    LCD_REMOTE_IDLE
+};
+
+/**
+ * @brief   Initialise UART0 and the protocol state.
+ *          The first frame sent will be a keyframe. Keeps the core out of
+ *          deep sleep, where UART0 would miss received bytes.
+ *
+ */
+void lcd_remote_init(void);
+
+/**
+ * @brief   Mirror the current screen buffer to the host.
+ *          Sends a delta against the last acknowledged frame, or a keyframe
+ *          after init or a NAK. A frame not acknowledged within its wire
+ *          time, the ACK's and a 20ms host margin is taken as lost and the
+ *          next one is a keyframe, however often this is called meanwhile.
+ *
+ * @return enum lcd_remote_status LCD_REMOTE_BUSY while the previous frame is unacknowledged
+ */
+enum lcd_remote_status lcd_remote_send_frame(void);
+
+/**
+ * @brief   Process received bytes. Host frames are staged as they arrive and
+ *          applied to the screen buffer once their CRC and sequence check
+ *          out, with the changed columns marked dirty, so follow a
+ *          LCD_REMOTE_FRAME_APPLIED with lcd_display_dirty().
+ *
+ * @return enum lcd_remote_status
+ */
+enum lcd_remote_status lcd_remote_poll(void);
+
+/**
+ * @brief   Force the next mirrored frame to be a keyframe
+ *
+ */
+void lcd_remote_resync(void);
+
+#endif
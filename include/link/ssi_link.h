@@ -0,0 +1,135 @@
+#ifndef LINK_SSI_LINK_H__
+#define LINK_SSI_LINK_H__
+
+#include <stdint.h>
+
+#include "hal/common.h"
+#include "hal/ssi.h"
+
+/*
+ * Board to board packet link over SSI.
+ *
+ * Every frame on the wire is SSI_LINK_FRAME_SIZE bytes:
+ *      A5 5A SEQ LEN payload[SSI_LINK_PAYLOAD_MAX] CRC16(hi) CRC16(lo)
+ * LEN is the number of payload bytes used, the rest is padding. The CRC is
+ * CRC-16/CCITT over SEQ, LEN and the whole payload field.
+ *
+ * The slave receives with uDMA into two ping-pong blocks of one frame each
+ * and unpacks frames in the SSI interrupt. It drives READY high while it has
+ * room for at least two more packets; the master only starts a frame while
+ * READY is high. SPI mode 1 (SPO 0, SPH 1) keeps FSS low across a frame.
+ *
+ * Wiring: CLK, FSS and MOSI master to slave, READY slave to master. MISO is
+ * not used, the slave leaves it undriven.
+ */
+
+#define SSI_LINK_FRAME_SIZE 256U
+#define SSI_LINK_HEADER_SIZE 4U
+#define SSI_LINK_CRC_SIZE 2U
+#define SSI_LINK_PAYLOAD_MAX (SSI_LINK_FRAME_SIZE - SSI_LINK_HEADER_SIZE - SSI_LINK_CRC_SIZE)
+
+// Received packets buffered on the slave
+#define SSI_LINK_RX_SLOTS 4U
+
+// The slave side must stay below SysClk / 12, 6.67Mbps at 80MHz
+#define SSI_LINK_DEFAULT_BITRATE 6000000UL
+
+enum ssi_link_ret
+{
+    SSI_LINK_OK,
+    // The slave has no room, try again later
+    SSI_LINK_NOT_READY,
+    SSI_LINK_TOO_LONG,
+    SSI_LINK_NO_PACKET,
+    SSI_LINK_INVALID_CONFIG
+};
+
+struct ssi_link_stats
+{
+    // Master: frames sent
+    uint32_t tx_packets;
+    uint32_t tx_payload_bytes;
+    // Slave: frames received with a good CRC
+    uint32_t rx_packets;
+    uint32_t rx_payload_bytes;
+    // Master: sends refused because READY was low
+    uint32_t not_ready;
+    // Slave: frames failing the CRC
+    uint32_t crc_errors;
+    // Slave: frames missing according to SEQ
+    uint32_t sequence_gaps;
+    // Slave: frames dropped with no free slot, or blocks lost to a late ISR
+    uint32_t overruns;
+    // Slave: DMA restarts after frames stopped lining up with blocks
+    uint32_t resyncs;
+};
+
+/**
+ * @brief   Set up the sending side
+ *
+ * @param instance SSI module
+ * @param pins Pin mux option of the module
+ * @param bitrate Link bit rate in Hz, SSI_LINK_DEFAULT_BITRATE or lower
+ * @param ready_port Port of the READY input
+ * @param ready_pin READY pin mask
+ * @return enum ssi_link_ret
+ */
+enum ssi_link_ret ssi_link_master_init( enum ssi_instance instance, enum ssi_pinmux pins, uint32_t bitrate,
+                                        Port ready_port, uint8_t ready_pin );
+
+/**
+ * @brief   Send one packet as a frame if the slave is ready. Returns once the
+ *          frame is on the wire.
+ *
+ * @param payload Packet bytes
+ * @param length Number of bytes, up to SSI_LINK_PAYLOAD_MAX
+ * @return enum ssi_link_ret SSI_LINK_NOT_READY if READY is low
+ */
+enum ssi_link_ret ssi_link_send( const uint8_t * payload, uint8_t length );
+
+/**
+ * @brief   Check whether the slave can take a packet
+ *
+ * @return uint8_t 1 if READY is high
+ */
+uint8_t ssi_link_ready( void );
+
+/**
+ * @brief   Set up the receiving side and raise READY. Initialises the uDMA
+ *          controller. A frame can start at any time, so the core no longer
+ *          enters deep sleep.
+ *
+ * @param instance SSI module
+ * @param pins Pin mux option of the module
+ * @param ready_port Port of the READY output
+ * @param ready_pin READY pin mask
+ * @return enum ssi_link_ret
+ */
+enum ssi_link_ret ssi_link_slave_init( enum ssi_instance instance, enum ssi_pinmux pins,
+                                       Port ready_port, uint8_t ready_pin );
+
+/**
+ * @brief   Take the oldest received packet
+ *
+ * @param payload Storage for SSI_LINK_PAYLOAD_MAX bytes
+ * @param length Packet length storage
+ * @return enum ssi_link_ret SSI_LINK_NO_PACKET if nothing is waiting
+ */
+enum ssi_link_ret ssi_link_receive( uint8_t * payload, uint8_t * length );
+
+/**
+ * @brief   Slave housekeeping, call from the main loop. Realigns DMA blocks
+ *          with frames once the bus is quiet after a misaligned frame.
+ *
+ */
+void ssi_link_slave_poll( void );
+
+/**
+ * @brief   Read link statistics. A board running both sides keeps the
+ *          counts of each apart
+ *
+ * @param stats Statistics storage
+ */
+void ssi_link_get_stats( struct ssi_link_stats * stats );
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef SPI_NOR_SPI_NOR_H__
+#define SPI_NOR_SPI_NOR_H__
+
+#include <stdint.h>
+
+#include "hal/common.h"
+#include "hal/gpio.h"
+#include "hal/ssi.h"
+
+/*
+ * Serial NOR flash with the common 25-series command set (W25Q, MX25L, ...),
+ * 3 byte addressing, SPI mode 0. Chip select is a GPIO so it stays low across
+ * a whole command.
+ */
+
+#define SPI_NOR_PAGE_SIZE 256U
+#define SPI_NOR_SECTOR_SIZE 4096U
+
+// Fastest rate the SSI master reaches at 80MHz, below the fast read limit of
+// every 25-series part
+#define SPI_NOR_DEFAULT_BITRATE 20000000UL
+
+// Worst case busy times from typical datasheets
+#define SPI_NOR_PAGE_PROGRAM_TIMEOUT_US 5000UL
+#define SPI_NOR_SECTOR_ERASE_TIMEOUT_US 500000UL
+
+enum spi_nor_ret
+{
+    SPI_NOR_OK,
+    SPI_NOR_INVALID_CONFIG,
+    // No part answered the JEDEC ID read
+    SPI_NOR_NOT_FOUND,
+    SPI_NOR_OUT_OF_RANGE,
+    // The part stayed busy past the program or erase timeout
+    SPI_NOR_TIMEOUT,
+    // A DMA read is still running
+    SPI_NOR_BUSY
+};
+
+struct spi_nor_config
+{
+    enum ssi_instance instance;
+    enum ssi_pinmux pins;
+    // Active low chip select, the module's FSS pin can be used
+    Port cs_port;
+    uint8_t cs_pin;
+    // Part's maximum bit rate in Hz
+    uint32_t bitrate;
+};
+
+struct spi_nor;
+
+/**
+ * @brief   Called from the SSI interrupt when a DMA read has finished
+ *
+ */
+typedef void (*spi_nor_callback)( struct spi_nor * nor );
+
+struct spi_nor
+{
+    struct ssi_handle * ssi;
+    struct gpio_regs * cs_gpio;
+    uint8_t cs_pin;
+    // Manufacturer, memory type, capacity
+    uint32_t jedec_id;
+    // Bytes
+    uint32_t size;
+
+    // DMA read in progress
+    volatile uint8_t dma_busy;
+    uint8_t * dma_dst;
+    uint32_t dma_remaining;
+    spi_nor_callback dma_callback;
+};
+
+/**
+ * @brief   Set up the SSI module and chip select, wake the part and identify
+ *          it. Initialises the uDMA controller.
+ *
+ * @param nor Device storage, must stay valid while DMA reads run
+ * @param config Device settings
+ * @return enum spi_nor_ret SPI_NOR_NOT_FOUND if the ID read returns nothing
+ */
+enum spi_nor_ret spi_nor_init( struct spi_nor * nor, const struct spi_nor_config * config );
+
+/**
+ * @brief   Fast read, polled
+ *
+ * @param nor Device
+ * @param address First byte
+ * @param data Storage for length bytes
+ * @param length Number of bytes
+ * @return enum spi_nor_ret
+ */
+enum spi_nor_ret spi_nor_read( struct spi_nor * nor, uint32_t address, uint8_t * data, uint32_t length );
+
+/**
+ * @brief   Start a fast read whose data phase runs on uDMA and return. The
+ *          chip select stays low, and the core out of deep sleep, until the
+ *          last byte has landed.
+ *
+ * @param nor Device
+ * @param address First byte
+ * @param data Storage for length bytes, untouched by the CPU until done
+ * @param length Number of bytes
+ * @param callback Completion callback from the SSI interrupt, may be NULL
+ * @return enum spi_nor_ret SPI_NOR_BUSY if a DMA read is still running
+ */
+enum spi_nor_ret spi_nor_read_dma( struct spi_nor * nor, uint32_t address, uint8_t * data, uint32_t length,
+                                   spi_nor_callback callback );
+
+/**
+ * @brief   Check for a DMA read in progress
+ *
+ * @param nor Device
+ * @return uint8_t 1 while the read runs
+ */
+uint8_t spi_nor_dma_busy( struct spi_nor * nor );
+
+/**
+ * @brief   Wait for a DMA read to finish
+ *
+ * @param nor Device
+ */
+void spi_nor_dma_wait( struct spi_nor * nor );
+
+/**
+ * @brief   Program bytes, split at page boundaries. The bytes must have been
+ *          erased, programming only clears bits.
+ *
+ * @param nor Device
+ * @param address First byte
+ * @param data Bytes to program
+ * @param length Number of bytes
+ * @return enum spi_nor_ret
+ */
+enum spi_nor_ret spi_nor_program( struct spi_nor * nor, uint32_t address, const uint8_t * data, uint32_t length );
+
+/**
+ * @brief   Erase the 4KB sector holding an address to 0xFF
+ *
+ * @param nor Device
+ * @param address Any address in the sector
+ * @return enum spi_nor_ret
+ */
+enum spi_nor_ret spi_nor_erase_sector( struct spi_nor * nor, uint32_t address );
+
+#endif
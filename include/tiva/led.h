@@ -32,7 +32,7 @@ void led_on( enum led led );
 void led_off( enum led led );
 
 /**
- * @brief   Flash an LED with a delay of 0.125s (125ms)
+ * @brief   Flash an LED with a delay of 0.125s (125ms), sleeping in between
  * 
  * @param led LED to flash
  * @param flashes How many times to flash the LED
@@ -48,4 +48,14 @@ void led_flash( enum led led, uint8_t flashes );
  */
 void led_flash_multi( enum led led, enum led led2, uint8_t flashes );
 
+/**
+ * @brief   Flash an LED with a delay of 0.125s (125ms) in the background,
+ *          stepped from a delay timer interrupt
+ * 
+ * @param led LED to flash
+ * @param flashes How many times to flash the LED
+ * @return uint8_t 1 if started, 0 if a blink is running or no timer is free
+ */
+uint8_t led_blink( enum led led, uint8_t flashes );
+
 #endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef UI_ANIM_H__
+#define UI_ANIM_H__
+
+#include <stdint.h>
+
+// Q16.16 fixed-point 1.0
+#define ANIM_Q16_ONE 65536L
+
+#define ANIM_MAX_TWEENS 8U
+
+enum anim_easing
+{
+    ANIM_EASE_LINEAR,
+    ANIM_EASE_IN_QUAD,
+    ANIM_EASE_OUT_QUAD,
+    ANIM_EASE_IN_OUT_CUBIC,
+    // Holds 'from' until the end then jumps to 'to'. Use for inversion/visibility
+    ANIM_EASE_STEP
+};
+
+enum anim_flag
+{
+    ANIM_FLAG_NONE = 0x00U,
+    // Restart when finished
+    ANIM_FLAG_LOOP = 0x01U,
+    // Swap from and to on every loop, e.g. blinking inversion with ANIM_EASE_STEP
+    ANIM_FLAG_PINGPONG = 0x02U
+};
+
+/**
+ * @brief   Evaluate an easing curve
+ *
+ * @param easing Curve
+ * @param t Progress in Q16.16, 0 to ANIM_Q16_ONE
+ * @return int32_t Eased progress in Q16.16
+ */
+int32_t anim_ease(enum anim_easing easing, int32_t t);
+
+/**
+ * @brief   Animate a property from one value to another.
+ *          The property is written on every anim_update until the tween ends.
+ *          Properties are plain integers so positions, values and inversion
+ *          flags (0/1 with ANIM_EASE_STEP) all animate the same way.
+ *
+ * @param property Property to animate. Must outlive the tween
+ * @param from Start value
+ * @param to End value
+ * @param duration_ms Duration of one run
+ * @param easing Curve
+ * @param flags enum anim_flag bits
+ * @return int8_t Tween handle, -1 if all ANIM_MAX_TWEENS slots are in use
+ */
+int8_t anim_start(int16_t *property, int16_t from, int16_t to, uint16_t duration_ms,
+                  enum anim_easing easing, uint8_t flags);
+
+/**
+ * @brief   Stop a tween, leaving the property at its current value
+ *
+ * @param handle Handle from anim_start
+ */
+void anim_stop(int8_t handle);
+
+/**
+ * @brief   Stop every tween that drives a property
+ *
+ * @param property Animated property
+ */
+void anim_stop_property(int16_t *property);
+
+/**
+ * @brief   Advance every running tween and write the animated properties
+ *
+ * @param elapsed_us Time since the last update, e.g. from frame_pacer_begin
+ * @return uint8_t Number of tweens still running
+ */
+uint8_t anim_update(uint32_t elapsed_us);
+
+/**
+ * @brief   Check whether a tween is still running
+ *
+ * @param handle Handle from anim_start
+ * @return uint8_t 1 if running
+ */
+uint8_t anim_is_running(int8_t handle);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef UI_FRAME_PACER_H__
+#define UI_FRAME_PACER_H__
+
+#include <stdint.h>
+
+struct frame_pacer_stats
+{
+    // Frames rendered since the last reset
+    uint32_t frames;
+    // Frame slots skipped because rendering overran
+    uint32_t dropped;
+    // Time between frame_pacer_begin and frame_pacer_end
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+    // Target frame period. period_us - avg_us is the headroom
+    uint32_t period_us;
+};
+
+/**
+ * @brief   Start pacing frames at a fixed rate on the timebase, which keeps
+ *          time across clock changes
+ *
+ * @param fps Target frames per second
+ */
+void frame_pacer_init(uint16_t fps);
+
+/**
+ * @brief   Wait for the next frame slot, asleep in idle_wait once idle_init
+ *          has been called. If the previous frame overran one or more slots
+ *          they are dropped and counted rather than rendered late.
+ *
+ * @return uint32_t Microseconds since the previous frame began, for anim_update
+ */
+uint32_t frame_pacer_begin(void);
+
+/**
+ * @brief   Mark the end of render and push for the current frame
+ *
+ */
+void frame_pacer_end(void);
+
+/**
+ * @brief   Read frame time statistics
+ *
+ * @param stats Statistics storage
+ */
+void frame_pacer_get_stats(struct frame_pacer_stats *stats);
+
+/**
+ * @brief   Clear frame time statistics
+ *
+ */
+void frame_pacer_reset_stats(void);
+
+#endif
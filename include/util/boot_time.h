@@ -0,0 +1,42 @@
+#ifndef UTIL_BOOT_TIME_H__
+#define UTIL_BOOT_TIME_H__
+
+#include <stdint.h>
+
+/*
+ * Boot timing from the timebase, started first thing in ResetISR and clocked
+ * from PIOSC / 4 so it keeps time across the switch to the PLL. Stages before
+ * timebase_init must be reached in the first 4 seconds after reset.
+ */
+
+enum boot_stage
+{
+    // Start of main, after .data and .bss are set up
+    BOOT_STAGE_MAIN,
+    // System clock at its final frequency, or its fallback
+    BOOT_STAGE_CLOCK,
+    // Drivers brought up, as soon as lcd_init returns. Usually before
+    // BOOT_STAGE_CLOCK, as the LCD comes up while the PLL locks
+    BOOT_STAGE_PERIPHERALS,
+    // First application frame on the panel
+    BOOT_STAGE_FIRST_FRAME,
+    BOOT_STAGES
+};
+
+/**
+ * @brief   Record the time a stage was reached. Only the first call per stage
+ *          counts, so it can sit in a loop
+ *
+ * @param stage Stage
+ */
+void boot_time_mark( enum boot_stage stage );
+
+/**
+ * @brief   Time from reset to a stage
+ *
+ * @param stage Stage
+ * @return uint32_t Microseconds, 0 if not reached
+ */
+uint32_t boot_time_get( enum boot_stage stage );
+
+#endif
@@ -8,11 +8,20 @@ extern uint8_t common_reverse_bits_lookup[];
 #define REVERSE_BYTE_BITS(value) \
         ((common_reverse_bits_lookup[value & 0x0F] << 4U) | common_reverse_bits_lookup[value >> 4U])
 
+// Place a variable in .noinit. It is neither zeroed nor initialised at reset
+// so it must be validated before use
+#define NOINIT __attribute__((section(".noinit")))
+
+// Run a function from SRAM, copied there by ResetISR. Flash needs wait states
+// above 40MHz; SRAM doesn't, but its fetches share the bus with data. Never
+// inlined into flash code. SRAM is out of BL range of flash: calls that see
+// the attribute use a long call, the linker adds veneers for the rest.
+// Place functions by measurement, see lcd_5110/lcd_bench.h
+#define RAMFUNC __attribute__((section(".ramfunc"), long_call, noinline))
+
 #define SET_BIT_VALUE(source, value, position) \
                                 (source = ((source & ~(1U << position)) | (value << position)))
 
-void delay(volatile unsigned long halfsecs);
-
 uint8_t reverse_bits( uint8_t byte );
 
 #endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef UTIL_CRC16_H__
+#define UTIL_CRC16_H__
+
+#include <stdint.h>
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, MSB first, no final XOR
+#define CRC16_INIT 0xFFFFU
+
+/**
+ * @brief   Add bytes to a running CRC-16/CCITT. Table driven, one lookup per byte
+ *
+ * @param crc CRC so far, CRC16_INIT to start
+ * @param data Bytes
+ * @param length Number of bytes
+ * @return uint16_t Updated CRC
+ */
+uint16_t crc16_update( uint16_t crc, const uint8_t * data, uint16_t length );
+
+/**
+ * @brief   Add one byte to a running CRC-16/CCITT
+ *
+ * @param crc CRC so far
+ * @param byte Byte
+ * @return uint16_t Updated CRC
+ */
+uint16_t crc16_update_byte( uint16_t crc, uint8_t byte );
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef UTIL_CRITICAL_H__
+#define UTIL_CRITICAL_H__
+
+#include <stdint.h>
+
+/**
+ * @brief   Mask interrupts, nesting safely
+ *
+ * @return uint32_t Previous PRIMASK, pass to critical_exit
+ */
+static inline uint32_t critical_enter( void )
+{
+    uint32_t primask;
+    __asm volatile ( "mrs %0, primask\n"
+                     "cpsid i\n" : "=r" (primask) : : "memory" );
+    return primask;
+}
+
+/**
+ * @brief   Restore the interrupt mask saved by critical_enter
+ *
+ * @param primask Value returned by critical_enter
+ */
+static inline void critical_exit( uint32_t primask )
+{
+    __asm volatile ( "msr primask, %0\n" : : "r" (primask) : "memory" );
+}
+
+#endif
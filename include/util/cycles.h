@@ -0,0 +1,46 @@
+#ifndef UTIL_CYCLES_H__
+#define UTIL_CYCLES_H__
+
+#include <stdint.h>
+
+#include "hal/clock.h"
+
+// Data Watchpoint and Trace unit, not covered by tm4c123gh6pm.h
+#define DWT_CTRL_R              (*((volatile unsigned long *)0xE0001000))
+#define DWT_CYCCNT_R            (*((volatile unsigned long *)0xE0001004))
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Enable cycle counter
+
+// Trace enable in the Debug Exception and Monitor Control Register (NVIC_DBG_INT_R)
+#define NVIC_DBG_INT_TRCENA     0x01000000
+
+#define CYCLES_PER_US (SystemCoreClock / 1000000UL)
+
+/**
+ * @brief   Enable the DWT cycle counter
+ * 
+ */
+void cycles_init( void );
+
+/**
+ * @brief   Current core cycle count. Wraps every 2^32 cycles (~53s at 80MHz)
+ *          so compare counts by subtraction.
+ * 
+ * @return uint32_t Cycle count
+ */
+static inline uint32_t cycles_now( void )
+{
+    return DWT_CYCCNT_R;
+}
+
+/**
+ * @brief   Convert a cycle count to microseconds
+ * 
+ * @param cycles Cycle count
+ * @return uint32_t Microseconds
+ */
+static inline uint32_t cycles_to_us( uint32_t cycles )
+{
+    return cycles / CYCLES_PER_US;
+}
+
+#endif
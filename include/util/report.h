@@ -0,0 +1,42 @@
+#ifndef UTIL_REPORT_H__
+#define UTIL_REPORT_H__
+
+#include <stdint.h>
+
+/*
+ * Plain text reports through a character output, for the benchmarks. No
+ * printf so nothing from newlib is pulled in.
+ */
+
+/**
+ * @brief   Writes one character of a report, e.g. uart0_write
+ *
+ */
+typedef void (*report_put)( char character );
+
+/**
+ * @brief   Write a string, padded with spaces on the right to a width
+ *
+ * @param put Character output
+ * @param string String
+ * @param width Minimum width, 0 for none
+ */
+void report_put_string( report_put put, const char * string, uint8_t width );
+
+/**
+ * @brief   Write an unsigned decimal, padded with spaces on the left
+ *
+ * @param put Character output
+ * @param value Value
+ * @param width Minimum width, 0 for none
+ */
+void report_put_uint( report_put put, uint32_t value, uint8_t width );
+
+/**
+ * @brief   Write a carriage return and line feed
+ *
+ * @param put Character output
+ */
+void report_put_line_end( report_put put );
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef UTIL_TIMEBASE_H__
+#define UTIL_TIMEBASE_H__
+
+#include <stdint.h>
+
+/*
+ * Monotonic timebase on SysTick. SysTick counts PIOSC / 4 so time is kept
+ * across clock switches, and an interrupt every tick extends it to 64 bits.
+ * Timestamps read the counter between ticks, a resolution of 0.25us. It is
+ * started free running in ResetISR; until timebase_init it covers the first
+ * 4 seconds after reset. Deep sleep suspends it, idle credits the time slept.
+ */
+
+#define TIMEBASE_CLOCKS_PER_US 4U
+#define TIMEBASE_CLOCK_HZ (TIMEBASE_CLOCKS_PER_US * 1000000UL)
+
+#define TIMEBASE_DEFAULT_TICK_HZ 1000U
+
+enum timebaseret
+{
+    TIMEBASE_OK,
+    TIMEBASE_INVALID_CONFIG
+};
+
+/**
+ * @brief   Start SysTick free running. Called from ResetISR, touches no
+ *          variables
+ *
+ */
+void timebase_start( void );
+
+/**
+ * @brief   Start the tick interrupt. Time carries on from reset
+ *
+ * @param tick_hz Tick rate, dividing TIMEBASE_CLOCK_HZ evenly
+ * @return enum timebaseret
+ */
+enum timebaseret timebase_init( uint32_t tick_hz );
+
+/**
+ * @brief   Time since reset. From ISRs too
+ *
+ * @return uint64_t Microseconds
+ */
+uint64_t timebase_now_us( void );
+
+/**
+ * @brief   Time since reset
+ *
+ * @return uint64_t Milliseconds
+ */
+uint64_t timebase_now_ms( void );
+
+/**
+ * @brief   Deadline a timeout from now
+ *
+ * @param timeout_us Timeout
+ * @return uint64_t Deadline, for timebase_expired and timebase_remaining_us
+ */
+uint64_t timebase_deadline( uint32_t timeout_us );
+
+/**
+ * @brief   Check a deadline has passed
+ *
+ * @param deadline From timebase_deadline
+ * @return uint8_t 1 if passed
+ */
+uint8_t timebase_expired( uint64_t deadline );
+
+/**
+ * @brief   Time left to a deadline
+ *
+ * @param deadline From timebase_deadline
+ * @return uint32_t Microseconds, 0 once passed
+ */
+uint32_t timebase_remaining_us( uint64_t deadline );
+
+/**
+ * @brief   Wait, sleeping through idle_wait once idle is set up. A signal
+ *          that comes in meanwhile is left for the main loop
+ *
+ * @param us Microseconds
+ */
+void timebase_delay_us( uint32_t us );
+
+void timebase_delay_ms( uint32_t ms );
+
+/**
+ * @brief   Stop SysTick for a deep sleep, where it would wake the core every
+ *          tick. Time reads as when suspended until timebase_resume
+ *
+ */
+void timebase_suspend( void );
+
+/**
+ * @brief   Restart SysTick after timebase_suspend
+ *
+ * @param slept_us Time suspended, added to the uptime
+ */
+void timebase_resume( uint64_t slept_us );
+
+#endif
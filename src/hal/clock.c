@@ -0,0 +1,430 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock.h"
+#include "util/critical.h"
+#include "util/cycles.h"
+
+// Listed as reserved in the DIV400 divisor table
+#define CLOCK_PLL_DIVISOR_RESERVED 7U
+
+struct clock_setting
+{
+    enum clock_source source;
+    uint8_t divisor;
+    uint32_t hz;
+};
+
+uint32_t SystemCoreClock = CLOCK_RESET_HZ;
+
+static enum clock_source clock_source = CLOCK_SOURCE_PIOSC;
+static clock_notifier clock_notifiers[CLOCK_MAX_NOTIFIERS] = {0};
+static struct clock_stats clock_stats = {0};
+
+// Switch left waiting for the PLL by clock_start_frequency
+static struct clock_setting clock_pending;
+static uint8_t clock_lock_pending = 0;
+static uint32_t clock_bypass_start = 0;
+static uint32_t clock_lock_start = 0;
+static uint32_t clock_bypass_cycles = 0;
+
+static uint32_t clock_source_hz( enum clock_source source )
+{
+    switch ( source )
+    {
+        case CLOCK_SOURCE_PLL:
+            return CLOCK_PLL_HZ;
+        case CLOCK_SOURCE_MOSC:
+            return CLOCK_XTAL_HZ;
+        case CLOCK_SOURCE_PIOSC:
+        default:
+            return CLOCK_PIOSC_HZ;
+    }
+}
+
+static uint8_t clock_valid_setting( const struct clock_setting * setting )
+{
+    if ( setting->source == CLOCK_SOURCE_PLL )
+    {
+        if ( setting->divisor < CLOCK_PLL_DIVISOR_MIN || setting->divisor > CLOCK_PLL_DIVISOR_MAX ||
+             setting->divisor == CLOCK_PLL_DIVISOR_RESERVED )
+        {
+            return 0;
+        }
+    }
+    else if ( setting->divisor == 0 || setting->divisor > CLOCK_OSC_DIVISOR_MAX )
+    {
+        return 0;
+    }
+
+    return setting->hz >= CLOCK_MIN_HZ && setting->hz <= CLOCK_MAX_HZ;
+}
+
+static uint8_t clock_find_setting( uint32_t hz, struct clock_setting * setting )
+{
+    if ( hz < CLOCK_MIN_HZ || hz > CLOCK_MAX_HZ )
+    {
+        return 0;
+    }
+
+    // The PLL draws several mA, leave it off when the crystal divides exactly
+    if ( (CLOCK_XTAL_HZ % hz) == 0 )
+    {
+        setting->source = CLOCK_SOURCE_MOSC;
+        setting->divisor = (uint8_t)(CLOCK_XTAL_HZ / hz);
+        setting->hz = hz;
+        return 1;
+    }
+
+    uint32_t divisor = (CLOCK_PLL_HZ + hz - 1U) / hz;
+
+    if ( divisor < CLOCK_PLL_DIVISOR_MIN )
+    {
+        divisor = CLOCK_PLL_DIVISOR_MIN;
+    }
+    if ( divisor == CLOCK_PLL_DIVISOR_RESERVED )
+    {
+        divisor++;
+    }
+
+    if ( divisor <= CLOCK_PLL_DIVISOR_MAX )
+    {
+        setting->source = CLOCK_SOURCE_PLL;
+        setting->divisor = (uint8_t)divisor;
+        setting->hz = CLOCK_PLL_HZ / divisor;
+        return 1;
+    }
+
+    // Below 3.125MHz, rounded down from the crystal
+    divisor = (CLOCK_XTAL_HZ + hz - 1U) / hz;
+    setting->source = CLOCK_SOURCE_MOSC;
+    setting->divisor = (uint8_t)divisor;
+    setting->hz = CLOCK_XTAL_HZ / divisor;
+
+    return clock_valid_setting( setting );
+}
+
+/**
+ * @brief   Wait for a raw interrupt status flag while running bypassed at 16MHz
+ *
+ * @return uint8_t 0 on timeout
+ */
+static uint8_t clock_wait( uint32_t flag, uint32_t start, uint32_t timeout_us )
+{
+    while ( !(SYSCTL_RIS_R & flag) )
+    {
+        if ( (cycles_now() - start) >= timeout_us * (CLOCK_XTAL_HZ / 1000000UL) )
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief   Start programming the clock tree. The core runs undivided from the
+ *          oscillator, 16MHz either way, until the PLL is locked, so the
+ *          dividers can change without a glitch.
+ *
+ * @param target Setting to switch to
+ * @param running Set to what the core runs from on return
+ * @return enum clockret CLOCK_MOSC_TIMEOUT if the crystal didn't start, running
+ *                       from PIOSC
+ */
+static enum clockret clock_begin( const struct clock_setting * target, struct clock_setting * running )
+{
+    uint32_t divisor = target->divisor - 1U;
+
+    // The timeouts need the cycle counter, which may not be running yet at boot
+    if ( !(DWT_CTRL_R & DWT_CTRL_CYCCNTENA) )
+    {
+        cycles_init();
+    }
+
+    SYSCTL_RCC2_R |= SYSCTL_RCC2_USERCC2 | SYSCTL_RCC2_BYPASS2;
+    SYSCTL_RCC_R &= ~SYSCTL_RCC_USESYSDIV;
+    clock_bypass_start = cycles_now();
+
+    if ( target->source != CLOCK_SOURCE_PIOSC && (SYSCTL_RCC_R & SYSCTL_RCC_MOSCDIS) )
+    {
+        // Main oscillator on, and settled before anything runs from it
+        SYSCTL_MISC_R = SYSCTL_MISC_MOSCPUPMIS;
+        SYSCTL_RCC_R &= ~SYSCTL_RCC_MOSCDIS;
+
+        if ( !clock_wait( SYSCTL_RIS_MOSCPUPRIS, cycles_now(), CLOCK_MOSC_TIMEOUT_US ) )
+        {
+            // No crystal, stay on the internal oscillator
+            SYSCTL_RCC_R |= SYSCTL_RCC_MOSCDIS;
+            SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~SYSCTL_RCC2_OSCSRC2_M) | SYSCTL_RCC2_OSCSRC2_IO;
+
+            running->source = CLOCK_SOURCE_PIOSC;
+            running->divisor = 1U;
+            running->hz = CLOCK_PIOSC_HZ;
+            clock_bypass_cycles = cycles_now() - clock_bypass_start;
+            return CLOCK_MOSC_TIMEOUT;
+        }
+    }
+
+    SYSCTL_RCC_R = (SYSCTL_RCC_R & ~SYSCTL_RCC_XTAL_M) | SYSCTL_RCC_XTAL_16MHZ;
+    SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~SYSCTL_RCC2_OSCSRC2_M) |
+                    ((target->source == CLOCK_SOURCE_PIOSC) ? SYSCTL_RCC2_OSCSRC2_IO : SYSCTL_RCC2_OSCSRC2_MO);
+
+    if ( target->source != CLOCK_SOURCE_PLL )
+    {
+        SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~(SYSCTL_RCC2_DIV400 | SYSCTL_RCC2_SYSDIV2_M | SYSCTL_RCC2_SYSDIV2LSB)) |
+                        (divisor << SYSCTL_RCC2_SYSDIV2_S) | SYSCTL_RCC2_PWRDN2;
+        SYSCTL_RCC_R |= SYSCTL_RCC_USESYSDIV;
+
+        if ( target->source == CLOCK_SOURCE_PIOSC )
+        {
+            SYSCTL_RCC_R |= SYSCTL_RCC_MOSCDIS;
+        }
+
+        *running = *target;
+        clock_bypass_cycles = cycles_now() - clock_bypass_start;
+        return CLOCK_OK;
+    }
+
+    // Power up the PLL and forget any earlier lock
+    SYSCTL_MISC_R = SYSCTL_MISC_PLLLMIS;
+    SYSCTL_RCC2_R &= ~SYSCTL_RCC2_PWRDN2;
+    clock_lock_start = cycles_now();
+
+    // With DIV400 the divisor is 7 bits, SYSDIV2LSB appended below SYSDIV2.
+    // Unused until USESYSDIV is set again
+    SYSCTL_RCC2_R = (SYSCTL_RCC2_R & ~(SYSCTL_RCC2_SYSDIV2_M | SYSCTL_RCC2_SYSDIV2LSB)) | SYSCTL_RCC2_DIV400 |
+                    ((divisor >> 1U) << SYSCTL_RCC2_SYSDIV2_S) | ((divisor & 1U) ? SYSCTL_RCC2_SYSDIV2LSB : 0);
+
+    running->source = CLOCK_SOURCE_MOSC;
+    running->divisor = 1U;
+    running->hz = CLOCK_XTAL_HZ;
+    clock_lock_pending = 1;
+
+    return CLOCK_OK;
+}
+
+/**
+ * @brief   Wait for the PLL started by clock_begin and switch to it
+ *
+ * @param target Setting passed to clock_begin
+ * @param running Set to what the core runs from on return
+ * @return enum clockret CLOCK_PLL_TIMEOUT if it didn't lock, running from the
+ *                       crystal with the PLL powered down
+ */
+static enum clockret clock_finish( const struct clock_setting * target, struct clock_setting * running )
+{
+    clock_lock_pending = 0;
+
+    if ( !clock_wait( SYSCTL_RIS_PLLLRIS, clock_lock_start, CLOCK_PLL_TIMEOUT_US ) )
+    {
+        SYSCTL_RCC2_R |= SYSCTL_RCC2_PWRDN2;
+        clock_bypass_cycles = cycles_now() - clock_bypass_start;
+        return CLOCK_PLL_TIMEOUT;
+    }
+
+    clock_bypass_cycles = cycles_now() - clock_bypass_start;
+    SYSCTL_RCC_R |= SYSCTL_RCC_USESYSDIV;
+    SYSCTL_RCC2_R &= ~SYSCTL_RCC2_BYPASS2;
+
+    *running = *target;
+
+    return CLOCK_OK;
+}
+
+static void clock_notify( enum clock_event event, uint32_t hz )
+{
+    for ( uint8_t i = 0; i < CLOCK_MAX_NOTIFIERS; i++ )
+    {
+        if ( clock_notifiers[i] )
+        {
+            clock_notifiers[i]( event, hz );
+        }
+    }
+}
+
+static void clock_set_running( const struct clock_setting * running )
+{
+    SystemCoreClock = running->hz;
+    clock_source = running->source;
+}
+
+static enum clockret clock_switch( const struct clock_setting * setting )
+{
+    struct clock_setting running;
+
+    // A switch started by clock_start_frequency goes first
+    clock_finish_frequency();
+
+    uint32_t old_hz = SystemCoreClock;
+    uint32_t start = cycles_now();
+
+    clock_notify( CLOCK_PRE_CHANGE, setting->hz );
+
+    uint32_t primask = critical_enter();
+
+    uint32_t switch_start = cycles_now();
+    enum clockret status = clock_begin( setting, &running );
+    if ( clock_lock_pending )
+    {
+        status = clock_finish( setting, &running );
+    }
+    uint32_t switch_end = cycles_now();
+
+    clock_set_running( &running );
+    clock_notify( CLOCK_POST_CHANGE, running.hz );
+
+    critical_exit( primask );
+
+    uint32_t end = cycles_now();
+
+    // The counter ran at the old clock, the oscillator and then the new clock
+    uint32_t old_cycles = (switch_start - start) + (switch_end - switch_start - clock_bypass_cycles);
+    uint32_t latency_us = (old_cycles / (old_hz / 1000000UL)) +
+                          (clock_bypass_cycles / (CLOCK_XTAL_HZ / 1000000UL)) +
+                          ((end - switch_end) / (running.hz / 1000000UL));
+
+    clock_stats.switches++;
+    clock_stats.last_latency_us = latency_us;
+    if ( latency_us > clock_stats.max_latency_us )
+    {
+        clock_stats.max_latency_us = latency_us;
+    }
+
+    return status;
+}
+
+uint32_t clock_get_achievable( uint32_t hz )
+{
+    struct clock_setting setting;
+
+    return clock_find_setting( hz, &setting ) ? setting.hz : 0;
+}
+
+enum clockret clock_set_frequency( uint32_t hz )
+{
+    struct clock_setting setting;
+
+    if ( !clock_find_setting( hz, &setting ) )
+    {
+        return CLOCK_INVALID_FREQUENCY;
+    }
+
+    return clock_switch( &setting );
+}
+
+enum clockret clock_start_frequency( uint32_t hz )
+{
+    struct clock_setting running;
+
+    clock_finish_frequency();
+
+    if ( !clock_find_setting( hz, &clock_pending ) )
+    {
+        return CLOCK_INVALID_FREQUENCY;
+    }
+
+    clock_notify( CLOCK_PRE_CHANGE, clock_pending.hz );
+
+    uint32_t primask = critical_enter();
+
+    enum clockret status = clock_begin( &clock_pending, &running );
+    clock_set_running( &running );
+
+    // Only the oscillator sources are done already
+    if ( !clock_lock_pending )
+    {
+        clock_notify( CLOCK_POST_CHANGE, running.hz );
+    }
+
+    critical_exit( primask );
+
+    return status;
+}
+
+enum clockret clock_finish_frequency( void )
+{
+    struct clock_setting running;
+
+    if ( !clock_lock_pending )
+    {
+        return CLOCK_OK;
+    }
+
+    uint32_t primask = critical_enter();
+
+    enum clockret status = clock_finish( &clock_pending, &running );
+    clock_set_running( &running );
+    clock_notify( CLOCK_POST_CHANGE, running.hz );
+
+    critical_exit( primask );
+
+    return status;
+}
+
+uint8_t clock_is_locked( void )
+{
+    return (!clock_lock_pending || (SYSCTL_RIS_R & SYSCTL_RIS_PLLLRIS)) ? 1U : 0U;
+}
+
+enum clockret clock_set_source( enum clock_source source, uint8_t divisor )
+{
+    struct clock_setting setting =
+    {
+        .source = source,
+        .divisor = divisor,
+        .hz = divisor ? (clock_source_hz( source ) / divisor) : 0
+    };
+
+    if ( !clock_valid_setting( &setting ) )
+    {
+        return CLOCK_INVALID_FREQUENCY;
+    }
+
+    return clock_switch( &setting );
+}
+
+enum clock_source clock_get_source( void )
+{
+    return clock_source;
+}
+
+void clock_get_stats( struct clock_stats * stats )
+{
+    *stats = clock_stats;
+}
+
+enum clockret clock_register_notifier( clock_notifier notifier )
+{
+    uint8_t free = CLOCK_MAX_NOTIFIERS;
+
+    for ( uint8_t i = 0; i < CLOCK_MAX_NOTIFIERS; i++ )
+    {
+        if ( clock_notifiers[i] == notifier )
+        {
+            return CLOCK_OK;
+        }
+        if ( !clock_notifiers[i] && free == CLOCK_MAX_NOTIFIERS )
+        {
+            free = i;
+        }
+    }
+
+    if ( free == CLOCK_MAX_NOTIFIERS )
+    {
+        return CLOCK_NOTIFIERS_FULL;
+    }
+    clock_notifiers[free] = notifier;
+
+    return CLOCK_OK;
+}
+
+void clock_unregister_notifier( clock_notifier notifier )
+{
+    for ( uint8_t i = 0; i < CLOCK_MAX_NOTIFIERS; i++ )
+    {
+        if ( clock_notifiers[i] == notifier )
+        {
+            clock_notifiers[i] = 0;
+        }
+    }
+}
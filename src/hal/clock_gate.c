@@ -0,0 +1,128 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock_gate.h"
+#include "util/critical.h"
+
+// Each bank of gate registers starts at RCGCWD, one word per class
+#define CLOCK_GATE_RUN_BANK 0x000U
+#define CLOCK_GATE_SLEEP_BANK 0x100U
+#define CLOCK_GATE_DEEP_SLEEP_BANK 0x200U
+#define CLOCK_GATE_READY_BANK 0x400U
+
+#define CLOCK_GATE_MODES 3U
+
+// Register offsets of each class within a bank
+static const uint8_t clock_gate_offsets[CLOCK_GATE_CLASSES] =
+{
+    [CLOCK_GATE_TIMER] = 0x04U,
+    [CLOCK_GATE_GPIO] = 0x08U,
+    [CLOCK_GATE_DMA] = 0x0CU,
+    [CLOCK_GATE_UART] = 0x18U,
+    [CLOCK_GATE_SSI] = 0x1CU,
+    [CLOCK_GATE_I2C] = 0x20U,
+    [CLOCK_GATE_ADC] = 0x38U,
+    [CLOCK_GATE_WTIMER] = 0x5CU
+};
+
+static const uint16_t clock_gate_banks[CLOCK_GATE_MODES] =
+{
+    CLOCK_GATE_RUN_BANK,
+    CLOCK_GATE_SLEEP_BANK,
+    CLOCK_GATE_DEEP_SLEEP_BANK
+};
+
+static uint8_t clock_gate_counts[CLOCK_GATE_CLASSES][CLOCK_GATE_MODULES][CLOCK_GATE_MODES] = {0};
+
+static volatile uint32_t * clock_gate_reg( enum clock_gate_class gate, uint16_t bank )
+{
+    return (volatile uint32_t *)((uintptr_t)&SYSCTL_RCGCWD_R + bank + clock_gate_offsets[gate]);
+}
+
+void clock_gate_init( void )
+{
+    SYSCTL_RCC_R |= SYSCTL_RCC_ACG;
+}
+
+void clock_gate_enable( enum clock_gate_class gate, uint32_t modules, uint8_t modes )
+{
+    modes |= CLOCK_GATE_RUN;
+
+    uint32_t primask = critical_enter();
+
+    for ( uint8_t mode = 0; mode < CLOCK_GATE_MODES; mode++ )
+    {
+        uint32_t open = 0;
+
+        if ( !(modes & (1U << mode)) )
+        {
+            continue;
+        }
+
+        for ( uint8_t module = 0; module < CLOCK_GATE_MODULES; module++ )
+        {
+            uint8_t * count = &clock_gate_counts[gate][module][mode];
+
+            // Saturated counts never close, the safe way to be wrong
+            if ( (modules & (1UL << module)) && *count < UINT8_MAX && (*count)++ == 0 )
+            {
+                open |= 1UL << module;
+            }
+        }
+
+        if ( open )
+        {
+            *clock_gate_reg( gate, clock_gate_banks[mode] ) |= open;
+        }
+    }
+
+    critical_exit( primask );
+
+    // Wait until the modules are ready, all in one go
+    while ( (*clock_gate_reg( gate, CLOCK_GATE_READY_BANK ) & modules) != modules );
+}
+
+void clock_gate_disable( enum clock_gate_class gate, uint32_t modules, uint8_t modes )
+{
+    modes |= CLOCK_GATE_RUN;
+
+    uint32_t primask = critical_enter();
+
+    for ( uint8_t mode = 0; mode < CLOCK_GATE_MODES; mode++ )
+    {
+        uint32_t close = 0;
+
+        if ( !(modes & (1U << mode)) )
+        {
+            continue;
+        }
+
+        for ( uint8_t module = 0; module < CLOCK_GATE_MODULES; module++ )
+        {
+            uint8_t * count = &clock_gate_counts[gate][module][mode];
+
+            if ( (modules & (1UL << module)) && *count && *count < UINT8_MAX && --(*count) == 0 )
+            {
+                close |= 1UL << module;
+            }
+        }
+
+        if ( close )
+        {
+            *clock_gate_reg( gate, clock_gate_banks[mode] ) &= ~close;
+        }
+    }
+
+    critical_exit( primask );
+}
+
+uint8_t clock_gate_get_count( enum clock_gate_class gate, uint8_t module, enum clock_gate_mode mode )
+{
+    uint8_t index = (uint8_t)__builtin_ctz( (uint32_t)mode );
+
+    if ( gate >= CLOCK_GATE_CLASSES || module >= CLOCK_GATE_MODULES || index >= CLOCK_GATE_MODES )
+    {
+        return 0;
+    }
+    return clock_gate_counts[gate][module][index];
+}
@@ -0,0 +1,216 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock_gate.h"
+#include "hal/delay.h"
+#include "hal/idle.h"
+#include "hal/timer.h"
+#include "util/critical.h"
+#include "util/timebase.h"
+
+// Longest shot of the 32-bit timer, longer delays run in halves of it
+#define DELAY_MAX_SHOT 0x100000000ULL
+// Shortest load the timer takes
+#define DELAY_MIN_SHOT 2U
+// Longest delay before the tick count overflows
+#define DELAY_MAX_NS (UINT64_MAX / DELAY_TICKS_PER_US)
+
+struct delay_slot
+{
+    delay_callback callback;
+    void * context;
+    // Ticks still to run after the current shot
+    volatile uint64_t ticks_left;
+    volatile uint8_t active;
+    uint8_t initialised;
+};
+
+static struct delay_slot delay_slots[DELAY_TIMERS];
+
+static enum timer_instance delay_timer( uint8_t id )
+{
+    return (enum timer_instance)(DELAY_FIRST_TIMER + id);
+}
+
+static void delay_arm( uint8_t id )
+{
+    struct delay_slot * slot = &delay_slots[id];
+
+    // Half a shot leaves more than DELAY_MIN_SHOT for the next
+    uint64_t shot = (slot->ticks_left > DELAY_MAX_SHOT) ? (DELAY_MAX_SHOT / 2U) : slot->ticks_left;
+    slot->ticks_left -= shot;
+
+    // Stopped, the count loads straight away
+    timer_get_regs( delay_timer( id ) )->TAILR = (uint32_t)(shot - 1U);
+    timer_start( delay_timer( id ) );
+}
+
+static void delay_expired( enum timer_instance instance )
+{
+    uint8_t id = (uint8_t)(instance - DELAY_FIRST_TIMER);
+    struct delay_slot * slot = &delay_slots[id];
+
+    // Cancelled after the timeout was raised
+    if ( !slot->active )
+    {
+        return;
+    }
+
+    if ( slot->ticks_left )
+    {
+        delay_arm( id );
+        return;
+    }
+
+    slot->active = 0;
+    if ( slot->callback )
+    {
+        slot->callback( slot->context );
+    }
+}
+
+static void delay_slot_init( uint8_t id )
+{
+    enum timer_instance instance = delay_timer( id );
+
+    timer_init_oneshot( instance, DELAY_MIN_SHOT );
+    timer_set_alt_clock( instance, 1 );
+
+    // Also clocked in deep sleep, where a sleeping delay may end
+    clock_gate_enable( CLOCK_GATE_TIMER, 1U << instance, CLOCK_GATE_DEEP_SLEEP );
+
+    timer_get_regs( instance )->IMR |= TIMER_IMR_TATOIM;
+    timer_set_callback( instance, delay_expired );
+
+    delay_slots[id].initialised = 1;
+}
+
+enum delayret delay_start( uint64_t ns, delay_callback callback, void * context, uint8_t * id )
+{
+    if ( ns > DELAY_MAX_NS )
+    {
+        return DELAY_INVALID_CONFIG;
+    }
+
+    uint64_t ticks = ((ns * DELAY_TICKS_PER_US) + 999U) / 1000U;
+    uint8_t slot_id;
+
+    if ( ticks < DELAY_MIN_SHOT )
+    {
+        ticks = DELAY_MIN_SHOT;
+    }
+
+    uint32_t primask = critical_enter();
+
+    for ( slot_id = 0; slot_id < DELAY_TIMERS; slot_id++ )
+    {
+        if ( !delay_slots[slot_id].active )
+        {
+            break;
+        }
+    }
+    if ( slot_id == DELAY_TIMERS )
+    {
+        critical_exit( primask );
+        return DELAY_BUSY;
+    }
+
+    struct delay_slot * slot = &delay_slots[slot_id];
+
+    if ( !slot->initialised )
+    {
+        delay_slot_init( slot_id );
+    }
+
+    slot->callback = callback;
+    slot->context = context;
+    slot->ticks_left = ticks;
+    slot->active = 1;
+    delay_arm( slot_id );
+
+    critical_exit( primask );
+
+    if ( id )
+    {
+        *id = slot_id;
+    }
+
+    return DELAY_OK;
+}
+
+void delay_cancel( uint8_t id )
+{
+    if ( id >= DELAY_TIMERS )
+    {
+        return;
+    }
+
+    uint32_t primask = critical_enter();
+
+    delay_slots[id].active = 0;
+    timer_stop( delay_timer( id ) );
+    timer_get_regs( delay_timer( id ) )->ICR = TIMER_ICR_TATOCINT;
+
+    critical_exit( primask );
+}
+
+uint64_t delay_remaining_ns( uint8_t id )
+{
+    if ( id >= DELAY_TIMERS )
+    {
+        return 0;
+    }
+
+    uint32_t primask = critical_enter();
+
+    uint64_t ticks = delay_slots[id].active ?
+                     (delay_slots[id].ticks_left + timer_get_regs( delay_timer( id ) )->TAV) : 0;
+
+    critical_exit( primask );
+
+    return (ticks * 1000U) / DELAY_TICKS_PER_US;
+}
+
+static void delay_wake( void * context )
+{
+    *(volatile uint8_t *)context = 1;
+    idle_wake();
+}
+
+void delay_sleep_ns( uint64_t ns )
+{
+    volatile uint8_t done = 0;
+    uint8_t signalled = 0;
+    uint8_t id;
+
+    if ( delay_start( ns, delay_wake, (void *)&done, &id ) != DELAY_OK )
+    {
+        // No timer free, to the microsecond instead
+        uint64_t us = (ns + 999U) / 1000U;
+        timebase_delay_us( (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us );
+        return;
+    }
+
+    while ( !done )
+    {
+        // The delay's own interrupt ends the wait, the timeout is a backstop
+        uint64_t us = (delay_remaining_ns( id ) / 1000U) + 1U;
+        signalled |= idle_wait( (us >= IDLE_FOREVER) ? (IDLE_FOREVER - 1U) : (uint32_t)us );
+    }
+
+    // Meant for the main loop, leave it for its idle_wait
+    if ( signalled )
+    {
+        idle_signal();
+    }
+}
+
+void delay_sleep_us( uint32_t us )
+{
+    delay_sleep_ns( (uint64_t)us * 1000U );
+}
+
+void delay_sleep_ms( uint32_t ms )
+{
+    delay_sleep_ns( (uint64_t)ms * 1000000U );
+}
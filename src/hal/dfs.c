@@ -0,0 +1,211 @@
+#include <stdint.h>
+
+#include "hal/dfs.h"
+#include "hal/clock.h"
+#include "util/cycles.h"
+
+#define DFS_LEVEL_UA(mhz, pll) (DFS_BASE_UA + ((mhz) * DFS_UA_PER_MHZ) + ((pll) ? DFS_PLL_UA : 0U))
+
+static const struct dfs_level dfs_default_levels[] =
+{
+    { CLOCK_SOURCE_PIOSC, 4U, DFS_LEVEL_UA( 4U, 0 ) },
+    { CLOCK_SOURCE_MOSC, 1U, DFS_LEVEL_UA( 16U, 0 ) },
+    { CLOCK_SOURCE_PLL, 10U, DFS_LEVEL_UA( 40U, 1 ) },
+    { CLOCK_SOURCE_PLL, 5U, DFS_LEVEL_UA( 80U, 1 ) }
+};
+
+static struct dfs_level dfs_levels[DFS_MAX_LEVELS];
+static uint8_t dfs_count = 0;
+static uint8_t dfs_level = 0;
+
+// Cycle count time and energy were last accounted up to
+static uint32_t dfs_mark = 0;
+static uint64_t dfs_time_us = 0;
+static uint64_t dfs_energy_nj = 0;
+// Energy below 1nJ carried over, in uA * mV * us
+static uint64_t dfs_energy_rem = 0;
+static uint64_t dfs_residency_us[DFS_MAX_LEVELS];
+
+// When the backlog last changed between empty and not
+static uint64_t dfs_since_us = 0;
+static uint8_t dfs_busy = 0;
+
+/**
+ * @brief   Charge the time since the last mark to the current level
+ *
+ */
+static void dfs_account( void )
+{
+    uint32_t per_us = SystemCoreClock / 1000000UL;
+    uint32_t us = (cycles_now() - dfs_mark) / per_us;
+
+    // Leftover cycles stay for the next call
+    dfs_mark += us * per_us;
+    dfs_time_us += us;
+    dfs_residency_us[dfs_level] += us;
+
+    dfs_energy_rem += (uint64_t)dfs_levels[dfs_level].current_ua * DFS_SUPPLY_MV * us;
+    dfs_energy_nj += dfs_energy_rem / 1000000UL;
+    dfs_energy_rem %= 1000000UL;
+}
+
+/**
+ * @brief   Close the old level's account before the clock changes, restart
+ *          counting after. The switch itself goes uncharged
+ *
+ */
+static void dfs_clock_changed( enum clock_event event, uint32_t hz )
+{
+    (void)hz;
+
+    if ( event == CLOCK_PRE_CHANGE )
+    {
+        dfs_account();
+    }
+    else
+    {
+        dfs_mark = cycles_now();
+    }
+}
+
+static enum dfsret dfs_switch( uint8_t level )
+{
+    if ( level >= dfs_count )
+    {
+        return DFS_INVALID_CONFIG;
+    }
+    if ( level == dfs_level )
+    {
+        return DFS_OK;
+    }
+
+    // The notifier charges up to here to the old level
+    if ( clock_set_source( dfs_levels[level].source, dfs_levels[level].divisor ) != CLOCK_OK )
+    {
+        return DFS_INVALID_CONFIG;
+    }
+    dfs_level = level;
+
+    return DFS_OK;
+}
+
+enum dfsret dfs_init( const struct dfs_level * levels, uint8_t count )
+{
+    if ( !levels )
+    {
+        levels = dfs_default_levels;
+        count = sizeof( dfs_default_levels ) / sizeof( dfs_default_levels[0] );
+    }
+    if ( count == 0 || count > DFS_MAX_LEVELS )
+    {
+        return DFS_INVALID_CONFIG;
+    }
+
+    for ( uint8_t i = 0; i < count; i++ )
+    {
+        dfs_levels[i] = levels[i];
+        dfs_residency_us[i] = 0;
+    }
+
+    cycles_init();
+
+    dfs_count = count;
+    dfs_time_us = 0;
+    dfs_energy_nj = 0;
+    dfs_energy_rem = 0;
+    dfs_since_us = 0;
+    dfs_busy = 0;
+
+    dfs_level = count - 1U;
+    dfs_mark = cycles_now();
+    clock_register_notifier( dfs_clock_changed );
+
+    if ( clock_set_source( dfs_levels[dfs_level].source, dfs_levels[dfs_level].divisor ) != CLOCK_OK )
+    {
+        dfs_count = 0;
+        return DFS_INVALID_CONFIG;
+    }
+
+    return DFS_OK;
+}
+
+void dfs_update( uint16_t backlog )
+{
+    if ( dfs_count == 0 )
+    {
+        return;
+    }
+
+    dfs_account();
+
+    uint8_t busy = (backlog > 0) ? 1U : 0U;
+    if ( busy != dfs_busy )
+    {
+        dfs_busy = busy;
+        dfs_since_us = dfs_time_us;
+    }
+
+    if ( backlog >= DFS_BACKLOG_HIGH )
+    {
+        dfs_switch( dfs_count - 1U );
+    }
+    else if ( busy && (dfs_time_us - dfs_since_us) >= DFS_UP_HOLD_US )
+    {
+        if ( dfs_level + 1U < dfs_count )
+        {
+            dfs_switch( dfs_level + 1U );
+        }
+        dfs_since_us = dfs_time_us;
+    }
+    else if ( !busy && (dfs_time_us - dfs_since_us) >= DFS_DOWN_HOLD_US )
+    {
+        if ( dfs_level > 0 )
+        {
+            dfs_switch( dfs_level - 1U );
+        }
+        dfs_since_us = dfs_time_us;
+    }
+}
+
+enum dfsret dfs_set_level( uint8_t level )
+{
+    enum dfsret status = dfs_switch( level );
+
+    dfs_since_us = dfs_time_us;
+
+    return status;
+}
+
+uint8_t dfs_get_level( void )
+{
+    return dfs_level;
+}
+
+void dfs_task_begin( struct dfs_task * task )
+{
+    dfs_account();
+
+    task->start_nj = dfs_energy_nj;
+    task->start_us = dfs_time_us;
+}
+
+void dfs_task_end( struct dfs_task * task )
+{
+    dfs_account();
+
+    task->energy_nj = (uint32_t)(dfs_energy_nj - task->start_nj);
+    task->time_us = (uint32_t)(dfs_time_us - task->start_us);
+}
+
+void dfs_get_stats( struct dfs_stats * stats )
+{
+    dfs_account();
+
+    stats->level = dfs_level;
+    for ( uint8_t i = 0; i < DFS_MAX_LEVELS; i++ )
+    {
+        stats->residency_us[i] = dfs_residency_us[i];
+    }
+    stats->energy_nj = dfs_energy_nj;
+    clock_get_stats( &stats->clock );
+}
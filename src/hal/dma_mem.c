@@ -0,0 +1,340 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/dma_mem.h"
+#include "hal/udma.h"
+#include "util/critical.h"
+#include "util/cycles.h"
+
+#define DMA_MEM_QUEUE_MASK (DMA_MEM_QUEUE_SIZE - 1U)
+
+#if (DMA_MEM_QUEUE_SIZE & DMA_MEM_QUEUE_MASK) != 0
+#error "DMA_MEM_QUEUE_SIZE must be a power of 2"
+#endif
+
+#define DMA_MEM_CHANNEL UDMA_CHANNEL_SOFTWARE
+// The software channel has no peripheral, encoding 0 leaves it that way
+#define DMA_MEM_ENCODING 0U
+
+// Rearbitrate every 8 items so peripheral channels aren't held off by a long
+// copy
+#define DMA_MEM_ARBSIZE UDMA_CHCTL_ARBSIZE_8
+
+// Largest calibration copy, in bytes
+#define DMA_MEM_CALIBRATE_MAX 512U
+#define DMA_MEM_CALIBRATE_MIN 8U
+
+static struct dma_mem_request * dma_mem_queue[DMA_MEM_QUEUE_SIZE];
+static volatile uint8_t dma_mem_head = 0;
+static volatile uint8_t dma_mem_tail = 0;
+
+static uint32_t dma_mem_threshold = DMA_MEM_DEFAULT_THRESHOLD;
+static struct dma_mem_stats dma_mem_stats = {0};
+
+// Source word for the fill being run, the controller reads it for every item
+static volatile uint32_t dma_mem_fill;
+
+static uint32_t dma_mem_control( enum dma_mem_width width, uint8_t fill )
+{
+    uint32_t control;
+
+    switch ( width )
+    {
+        case DMA_MEM_WIDTH_8:
+            control = UDMA_CHCTL_DSTINC_8 | UDMA_CHCTL_DSTSIZE_8 |
+                      (fill ? UDMA_CHCTL_SRCINC_NONE : UDMA_CHCTL_SRCINC_8) | UDMA_CHCTL_SRCSIZE_8;
+            break;
+        case DMA_MEM_WIDTH_16:
+            control = UDMA_CHCTL_DSTINC_16 | UDMA_CHCTL_DSTSIZE_16 |
+                      (fill ? UDMA_CHCTL_SRCINC_NONE : UDMA_CHCTL_SRCINC_16) | UDMA_CHCTL_SRCSIZE_16;
+            break;
+        case DMA_MEM_WIDTH_32:
+        default:
+            control = UDMA_CHCTL_DSTINC_32 | UDMA_CHCTL_DSTSIZE_32 |
+                      (fill ? UDMA_CHCTL_SRCINC_NONE : UDMA_CHCTL_SRCINC_32) | UDMA_CHCTL_SRCSIZE_32;
+            break;
+    }
+
+    return control | DMA_MEM_ARBSIZE | UDMA_CHCTL_XFERMODE_AUTO;
+}
+
+/**
+ * @brief   Hand the next chunk of a request to the controller
+ *
+ */
+static void dma_mem_start_chunk( struct dma_mem_request * request )
+{
+    uint32_t offset = request->started * request->width;
+    uint32_t count = request->count - request->started;
+    const volatile void * src;
+
+    if ( count > UDMA_MAX_TRANSFER )
+    {
+        count = UDMA_MAX_TRANSFER;
+    }
+
+    if ( request->src )
+    {
+        src = (const uint8_t *)request->src + offset;
+    }
+    else
+    {
+        dma_mem_fill = request->value;
+        src = &dma_mem_fill;
+    }
+
+    udma_set_transfer( DMA_MEM_CHANNEL, UDMA_PRIMARY, dma_mem_control( request->width, !request->src ),
+                       (volatile void *)src, (uint8_t *)request->dst + offset, (uint16_t)count );
+    request->started += count;
+
+    udma_enable( DMA_MEM_CHANNEL );
+    udma_request( DMA_MEM_CHANNEL );
+}
+
+/**
+ * @brief   Software channel completion: next chunk, or finish the request and
+ *          start the next one
+ *
+ */
+static void dma_mem_complete( uint8_t channel )
+{
+    (void)channel;
+
+    if ( dma_mem_head == dma_mem_tail )
+    {
+        return;
+    }
+
+    struct dma_mem_request * request = dma_mem_queue[dma_mem_tail & DMA_MEM_QUEUE_MASK];
+
+    if ( request->started < request->count )
+    {
+        dma_mem_start_chunk( request );
+        return;
+    }
+
+    dma_mem_tail++;
+    request->status = DMA_MEM_DONE;
+
+    if ( dma_mem_head != dma_mem_tail )
+    {
+        dma_mem_start_chunk( dma_mem_queue[dma_mem_tail & DMA_MEM_QUEUE_MASK] );
+    }
+
+    if ( request->callback )
+    {
+        request->callback( request );
+    }
+}
+
+static void dma_mem_cpu( struct dma_mem_request * request )
+{
+    uint32_t count = request->count;
+
+    switch ( request->width )
+    {
+        case DMA_MEM_WIDTH_8:
+        {
+            uint8_t * dst = request->dst;
+            const uint8_t * src = request->src;
+            for ( uint32_t i = 0; i < count; i++ )
+            {
+                dst[i] = src ? src[i] : (uint8_t)request->value;
+            }
+            break;
+        }
+        case DMA_MEM_WIDTH_16:
+        {
+            uint16_t * dst = request->dst;
+            const uint16_t * src = request->src;
+            for ( uint32_t i = 0; i < count; i++ )
+            {
+                dst[i] = src ? src[i] : (uint16_t)request->value;
+            }
+            break;
+        }
+        case DMA_MEM_WIDTH_32:
+        default:
+        {
+            uint32_t * dst = request->dst;
+            const uint32_t * src = request->src;
+            for ( uint32_t i = 0; i < count; i++ )
+            {
+                dst[i] = src ? src[i] : request->value;
+            }
+            break;
+        }
+    }
+}
+
+void dma_mem_init( void )
+{
+    udma_assign_channel( DMA_MEM_CHANNEL, DMA_MEM_ENCODING );
+    udma_set_callback( DMA_MEM_CHANNEL, dma_mem_complete );
+
+    dma_mem_head = 0;
+    dma_mem_tail = 0;
+}
+
+enum dma_mem_ret dma_mem_submit( struct dma_mem_request * request )
+{
+    enum dma_mem_ret status = DMA_MEM_OK;
+
+    if ( !request->dst || request->count == 0 ||
+         (request->width != DMA_MEM_WIDTH_8 && request->width != DMA_MEM_WIDTH_16 &&
+          request->width != DMA_MEM_WIDTH_32) )
+    {
+        return DMA_MEM_INVALID_CONFIG;
+    }
+
+    request->started = 0;
+
+    uint32_t primask = critical_enter();
+
+    // Small requests are cheaper done here than set up
+    if ( (request->count * request->width) < dma_mem_threshold )
+    {
+        dma_mem_stats.cpu_requests++;
+        critical_exit( primask );
+
+        dma_mem_cpu( request );
+        request->status = DMA_MEM_DONE;
+        if ( request->callback )
+        {
+            request->callback( request );
+        }
+        return DMA_MEM_OK;
+    }
+
+    if ( (uint8_t)(dma_mem_head - dma_mem_tail) >= DMA_MEM_QUEUE_SIZE )
+    {
+        dma_mem_stats.queue_full++;
+        status = DMA_MEM_QUEUE_FULL;
+    }
+    else
+    {
+        request->status = DMA_MEM_QUEUED;
+        dma_mem_queue[dma_mem_head & DMA_MEM_QUEUE_MASK] = request;
+        dma_mem_stats.dma_requests++;
+        dma_mem_stats.dma_bytes += request->count * request->width;
+
+        // Chained behind a running request, started from its completion
+        if ( dma_mem_head++ == dma_mem_tail )
+        {
+            dma_mem_start_chunk( request );
+        }
+    }
+
+    critical_exit( primask );
+
+    return status;
+}
+
+uint8_t dma_mem_busy( void )
+{
+    return (dma_mem_head != dma_mem_tail) ? 1U : 0U;
+}
+
+void dma_mem_wait( struct dma_mem_request * request )
+{
+    while ( request->status == DMA_MEM_QUEUED );
+}
+
+static enum dma_mem_ret dma_mem_run( struct dma_mem_request * request )
+{
+    enum dma_mem_ret status;
+
+    while ( (status = dma_mem_submit( request )) == DMA_MEM_QUEUE_FULL );
+
+    if ( status == DMA_MEM_OK )
+    {
+        dma_mem_wait( request );
+    }
+    return status;
+}
+
+enum dma_mem_ret dma_mem_copy( void * dst, const void * src, uint32_t count, enum dma_mem_width width )
+{
+    struct dma_mem_request request =
+    {
+        .dst = dst,
+        .src = src,
+        .count = count,
+        .width = width
+    };
+
+    if ( !src )
+    {
+        return DMA_MEM_INVALID_CONFIG;
+    }
+    return dma_mem_run( &request );
+}
+
+enum dma_mem_ret dma_mem_set( void * dst, uint32_t value, uint32_t count, enum dma_mem_width width )
+{
+    struct dma_mem_request request =
+    {
+        .dst = dst,
+        .value = value,
+        .count = count,
+        .width = width
+    };
+
+    return dma_mem_run( &request );
+}
+
+void dma_mem_set_threshold( uint32_t bytes )
+{
+    dma_mem_threshold = bytes;
+}
+
+uint32_t dma_mem_get_threshold( void )
+{
+    return dma_mem_threshold;
+}
+
+uint32_t dma_mem_calibrate( void )
+{
+    static uint32_t src[DMA_MEM_CALIBRATE_MAX / sizeof( uint32_t )];
+    static uint32_t dst[DMA_MEM_CALIBRATE_MAX / sizeof( uint32_t )];
+    // DMA never won, keep every size measured on the CPU
+    uint32_t threshold = DMA_MEM_CALIBRATE_MAX + 1U;
+
+    for ( uint32_t bytes = DMA_MEM_CALIBRATE_MIN; bytes <= DMA_MEM_CALIBRATE_MAX; bytes *= 2U )
+    {
+        struct dma_mem_request request =
+        {
+            .dst = dst,
+            .src = src,
+            .count = bytes / sizeof( uint32_t ),
+            .width = DMA_MEM_WIDTH_32
+        };
+
+        uint32_t start = cycles_now();
+        dma_mem_cpu( &request );
+        uint32_t cpu_cycles = cycles_now() - start;
+
+        // Submit to completion callback, everything the CPU would wait for
+        dma_mem_threshold = 0;
+        start = cycles_now();
+        dma_mem_run( &request );
+        uint32_t dma_cycles = cycles_now() - start;
+
+        if ( dma_cycles <= cpu_cycles )
+        {
+            threshold = bytes;
+            break;
+        }
+    }
+
+    dma_mem_threshold = threshold;
+
+    return threshold;
+}
+
+void dma_mem_get_stats( struct dma_mem_stats * stats )
+{
+    uint32_t primask = critical_enter();
+    *stats = dma_mem_stats;
+    critical_exit( primask );
+}
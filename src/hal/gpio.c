@@ -0,0 +1,111 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/common.h"
+#include "hal/clock_gate.h"
+#include "hal/gpio.h"
+
+// Port A on the AHB aperture, ports are 4KB apart
+#define GPIO_AHB_BASE 0x40058000U
+#define GPIO_AHB_STRIDE 0x1000U
+
+// 4 bits of PCTL per pin
+#define GPIO_PCTL_BITS 4U
+
+static uint8_t gpio_port_index( Port port )
+{
+    return (uint8_t)__builtin_ctz( (uint32_t)port );
+}
+
+struct gpio_regs * gpio_get_port( Port port )
+{
+    return (struct gpio_regs *)(uintptr_t)(GPIO_AHB_BASE + (gpio_port_index( port ) * GPIO_AHB_STRIDE));
+}
+
+void gpio_enable_port( Port port )
+{
+    // Enable High Performance Bus
+    SYSCTL_GPIOHBCTL_R |= port;
+
+    // Clocked in sleep too so pin interrupts can wake the core
+    clock_gate_enable( CLOCK_GATE_GPIO, port, CLOCK_GATE_SLEEP );
+}
+
+void gpio_disable_port( Port port )
+{
+    clock_gate_disable( CLOCK_GATE_GPIO, port, CLOCK_GATE_SLEEP );
+}
+
+void gpio_set_alternate( Port port, uint8_t pins, uint8_t function )
+{
+    struct gpio_regs * gpio = gpio_get_port( port );
+    uint32_t pctl_mask = 0;
+    uint32_t pctl = 0;
+
+    for ( uint8_t pin = 0; pin < 8U; pin++ )
+    {
+        if ( pins & (1U << pin) )
+        {
+            pctl_mask |= 0xFU << (pin * GPIO_PCTL_BITS);
+            pctl |= (uint32_t)function << (pin * GPIO_PCTL_BITS);
+        }
+    }
+
+    // Unlock and commit the pins, needed for PF0 and PD7
+    gpio->LOCK = GPIO_LOCK_KEY;
+    gpio->CR |= pins;
+    gpio->LOCK = 0;
+
+    gpio->AFSEL |= pins;
+    gpio->PCTL = (gpio->PCTL & ~pctl_mask) | pctl;
+
+    // Disable Analog Mode
+    gpio->AMSEL &= ~pins;
+
+    // Digital Enable
+    gpio->DEN |= pins;
+}
+
+void gpio_set_output( Port port, uint8_t pins )
+{
+    struct gpio_regs * gpio = gpio_get_port( port );
+
+    gpio->LOCK = GPIO_LOCK_KEY;
+    gpio->CR |= pins;
+    gpio->LOCK = 0;
+
+    gpio->AFSEL &= ~pins;
+    gpio->AMSEL &= ~pins;
+    gpio->DIR |= pins;
+    gpio->DEN |= pins;
+}
+
+void gpio_set_input( Port port, uint8_t pins )
+{
+    struct gpio_regs * gpio = gpio_get_port( port );
+
+    gpio->LOCK = GPIO_LOCK_KEY;
+    gpio->CR |= pins;
+    gpio->LOCK = 0;
+
+    gpio->AFSEL &= ~pins;
+    gpio->AMSEL &= ~pins;
+    gpio->DIR &= ~pins;
+    gpio->DEN |= pins;
+}
+
+void gpio_set_pull_down( Port port, uint8_t pins )
+{
+    struct gpio_regs * gpio = gpio_get_port( port );
+
+    gpio->PUR &= ~pins;
+    gpio->PDR |= pins;
+}
+
+void gpio_set_pull_up( Port port, uint8_t pins )
+{
+    struct gpio_regs * gpio = gpio_get_port( port );
+
+    gpio->PDR &= ~pins;
+    gpio->PUR |= pins;
+}
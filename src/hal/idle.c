@@ -0,0 +1,229 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock.h"
+#include "hal/clock_gate.h"
+#include "hal/idle.h"
+#include "hal/timer.h"
+#include "util/critical.h"
+#include "util/cycles.h"
+#include "util/timebase.h"
+
+// Longest the 32 bit wake timer can be set for
+#define IDLE_MAX_TICKS 0xFFFFFFFFUL
+
+static volatile uint8_t idle_pending = 0;
+// Ends idle_wait without pending work
+static volatile uint8_t idle_woken = 0;
+// Wake timer expiries since idle_wait armed it
+static volatile uint32_t idle_expiries = 0;
+
+static uint8_t idle_initialised = 0;
+static uint8_t idle_deep_blocks = 0;
+static uint32_t idle_budget_us = 0;
+static struct idle_stats idle_stats = {0};
+
+static void idle_timer_expired( enum timer_instance instance )
+{
+    (void)instance;
+
+    idle_expiries++;
+}
+
+static void idle_record_wake( uint32_t us, uint8_t deep )
+{
+    idle_stats.last_wake_us = us;
+    if ( us > idle_stats.max_wake_us )
+    {
+        idle_stats.max_wake_us = us;
+    }
+    if ( deep && us > idle_stats.max_deep_wake_us )
+    {
+        idle_stats.max_deep_wake_us = us;
+    }
+    if ( idle_budget_us && us > idle_budget_us )
+    {
+        idle_stats.budget_misses++;
+    }
+}
+
+static uint8_t idle_take_signal( void )
+{
+    uint32_t primask = critical_enter();
+
+    uint8_t signalled = idle_pending;
+    idle_pending = 0;
+    idle_woken = 0;
+
+    critical_exit( primask );
+
+    return signalled;
+}
+
+void idle_init( void )
+{
+    if ( idle_initialised )
+    {
+        return;
+    }
+
+    struct timer_regs * timer = timer_get_regs( IDLE_TIMER );
+
+    timer_init_periodic( IDLE_TIMER, IDLE_MAX_TICKS );
+    timer_set_alt_clock( IDLE_TIMER, 1 );
+
+    // Also clocked in deep sleep, it is what wakes the core
+    clock_gate_enable( CLOCK_GATE_TIMER, 1U << IDLE_TIMER, CLOCK_GATE_DEEP_SLEEP );
+
+    timer->IMR |= TIMER_IMR_TATOIM;
+    timer_set_callback( IDLE_TIMER, idle_timer_expired );
+
+    // Deep sleep runs from PIOSC undivided, which keeps the wake timer counting
+    SYSCTL_DSLPCLKCFG_R = SYSCTL_DSLPCLKCFG_O_IO;
+
+    idle_initialised = 1;
+}
+
+void idle_signal( void )
+{
+    idle_pending = 1;
+}
+
+void idle_wake( void )
+{
+    idle_woken = 1;
+}
+
+uint8_t idle_wait( uint32_t timeout_us )
+{
+    if ( !idle_initialised || timeout_us == 0 )
+    {
+        return idle_take_signal();
+    }
+
+    struct timer_regs * timer = timer_get_regs( IDLE_TIMER );
+    uint32_t ticks = (timeout_us >= (IDLE_MAX_TICKS / IDLE_TICKS_PER_US)) ? IDLE_MAX_TICKS :
+                     (timeout_us * IDLE_TICKS_PER_US);
+    uint8_t deep = (timeout_us >= IDLE_DEEP_SLEEP_MIN_US) && !idle_deep_blocks &&
+                   (!idle_budget_us || idle_stats.max_deep_wake_us <= idle_budget_us);
+    uint8_t slept = 0;
+
+    uint32_t primask = critical_enter();
+
+    timer->TAILR = ticks - 1U;
+    timer->ICR = TIMER_ICR_TATOCINT;
+    idle_expiries = 0;
+    uint32_t start = cycles_now();
+    timer_start( IDLE_TIMER );
+
+    if ( deep )
+    {
+        // The tick would wake the core every millisecond
+        timebase_suspend();
+        NVIC_SYS_CTRL_R |= NVIC_SYS_CTRL_SLEEPDEEP;
+    }
+    else
+    {
+        NVIC_SYS_CTRL_R &= ~NVIC_SYS_CTRL_SLEEPDEEP;
+    }
+
+    // Interrupts stay masked around WFI so a signal can't slip in between the
+    // check and the sleep; a pending interrupt still wakes the core
+    while ( !idle_pending && !idle_woken && (!idle_expiries || timeout_us == IDLE_FOREVER) )
+    {
+        __asm volatile ( "wfi" );
+        slept = 1;
+
+        // Woken by the timer, which carried on counting down from the reload
+        if ( timer->RIS & TIMER_RIS_TATORIS )
+        {
+            idle_record_wake( (timer->TAILR - timer->TAV) / IDLE_TICKS_PER_US, deep );
+        }
+
+        // Run the interrupt that woke the core
+        critical_exit( primask );
+        primask = critical_enter();
+    }
+
+    uint32_t remaining = timer->TAV;
+    uint32_t expiries = idle_expiries + ((timer->RIS & TIMER_RIS_TATORIS) ? 1U : 0U);
+    timer_stop( IDLE_TIMER );
+    NVIC_SYS_CTRL_R &= ~NVIC_SYS_CTRL_SLEEPDEEP;
+
+    uint64_t elapsed = ((uint64_t)expiries * ((uint64_t)timer->TAILR + 1U)) + (timer->TAILR - remaining);
+    if ( deep )
+    {
+        timebase_resume( elapsed / IDLE_TICKS_PER_US );
+    }
+
+    if ( slept )
+    {
+        // The cycle counter stops while the core sleeps, make up the difference
+        // so everything timed by it keeps time
+        uint64_t wall = (elapsed * SystemCoreClock) / CLOCK_PIOSC_HZ;
+        uint32_t counted = cycles_now() - start;
+        if ( wall > counted )
+        {
+            DWT_CYCCNT_R += (uint32_t)(wall - counted);
+        }
+
+        if ( deep )
+        {
+            idle_stats.deep_sleeps++;
+        }
+        else
+        {
+            idle_stats.sleeps++;
+        }
+        idle_stats.sleep_us += elapsed / IDLE_TICKS_PER_US;
+    }
+
+    uint8_t signalled = idle_pending;
+    idle_pending = 0;
+    idle_woken = 0;
+
+    critical_exit( primask );
+
+    return signalled;
+}
+
+void idle_block_deep_sleep( void )
+{
+    uint32_t primask = critical_enter();
+    idle_deep_blocks++;
+    critical_exit( primask );
+}
+
+void idle_allow_deep_sleep( void )
+{
+    uint32_t primask = critical_enter();
+    if ( idle_deep_blocks )
+    {
+        idle_deep_blocks--;
+    }
+    critical_exit( primask );
+}
+
+void idle_set_latency_budget( uint32_t us )
+{
+    idle_budget_us = us;
+}
+
+void idle_set_sleep_on_exit( uint8_t enable )
+{
+    if ( enable )
+    {
+        NVIC_SYS_CTRL_R |= NVIC_SYS_CTRL_SLEEPEXIT;
+    }
+    else
+    {
+        NVIC_SYS_CTRL_R &= ~NVIC_SYS_CTRL_SLEEPEXIT;
+    }
+}
+
+void idle_get_stats( struct idle_stats * stats )
+{
+    uint32_t primask = critical_enter();
+    *stats = idle_stats;
+    critical_exit( primask );
+}
@@ -0,0 +1,282 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/common.h"
+#include "hal/gpio.h"
+#include "hal/clock.h"
+#include "hal/ssi.h"
+#include "hal/spi_bus.h"
+#include "util/critical.h"
+#include "util/cycles.h"
+
+#define SPI_BUS_QUEUE_MASK (SPI_BUS_QUEUE_SIZE - 1U)
+
+#if (SPI_BUS_QUEUE_SIZE & SPI_BUS_QUEUE_MASK) != 0
+#error "SPI_BUS_QUEUE_SIZE must be a power of 2"
+#endif
+
+#define SPI_PRESCALE_MIN 2U
+#define SPI_PRESCALE_MAX 254U
+
+enum spi_bus_ret spi_bus_init( struct spi_bus * bus, enum ssi_instance instance, enum ssi_pinmux pins )
+{
+    // Slowest clock until the first device is selected
+    const struct ssi_config config =
+    {
+        .pins = pins,
+        .frame_format = FREESCALE,
+        .polarity = STEADY_LOW,
+        .phase = FIRST_EDGE_TRANSITION,
+        .datasize = DATASIZE_8,
+        .prescale = SPI_PRESCALE_MAX,
+        .scr = 0,
+        .software_fss = 1
+    };
+
+    bus->ssi = ssi_get_handle( instance );
+    if ( !bus->ssi || ssi_init( bus->ssi, &config ) != SSI_OK )
+    {
+        return SPI_BUS_INVALID_CONFIG;
+    }
+
+    bus->device_count = 0;
+    bus->active_device = 0;
+    bus->queue_head = 0;
+    bus->queue_tail = 0;
+    bus->processing = 0;
+
+    cycles_init();
+    spi_bus_reset_stats( bus );
+
+    return SPI_BUS_OK;
+}
+
+struct spi_device * spi_bus_add_device( struct spi_bus * bus, const struct spi_device_config * config )
+{
+    uint8_t prescale = config->prescale;
+    uint8_t scr = config->scr;
+
+    if ( config->bitrate &&
+         !ssi_calc_divisors( SystemCoreClock, config->bitrate, &prescale, &scr ) )
+    {
+        return 0;
+    }
+
+    if ( bus->device_count >= SPI_BUS_MAX_DEVICES ||
+         prescale < SPI_PRESCALE_MIN || prescale > SPI_PRESCALE_MAX ||
+         (prescale & 1U) ||
+         config->datasize < DATASIZE_4 || config->datasize > DATASIZE_16 )
+    {
+        return 0;
+    }
+
+    struct spi_device * device = &bus->devices[bus->device_count++];
+
+    device->bus = bus;
+    device->cs_gpio = gpio_get_port( config->cs_port );
+    device->cs_pin = config->cs_pin;
+    device->datasize = config->datasize;
+    device->bitrate = SystemCoreClock / (prescale * (1U + scr));
+    device->max_bitrate = config->bitrate;
+    device->clock_hz = SystemCoreClock;
+    device->cpsr = prescale;
+    device->cr0 = ((uint32_t)scr << SSI_CR0_SCR_S) | config->phase | config->polarity |
+                  FREESCALE | config->datasize;
+
+    // Deselected before the pin starts driving
+    gpio_enable_port( config->cs_port );
+    gpio_write( device->cs_gpio, device->cs_pin, 1 );
+    gpio_set_output( config->cs_port, config->cs_pin );
+
+    return device;
+}
+
+enum spi_bus_ret spi_bus_submit( struct spi_transaction * transaction )
+{
+    struct spi_bus * bus = transaction->device->bus;
+    enum spi_bus_ret status = SPI_BUS_OK;
+
+    uint32_t primask = critical_enter();
+
+    if ( (uint8_t)(bus->queue_head - bus->queue_tail) >= SPI_BUS_QUEUE_SIZE )
+    {
+        bus->stats.queue_full++;
+        status = SPI_BUS_QUEUE_FULL;
+    }
+    else
+    {
+        transaction->status = SPI_TRANSACTION_QUEUED;
+        bus->queue[bus->queue_head & SPI_BUS_QUEUE_MASK] = transaction;
+        bus->queue_head++;
+    }
+
+    critical_exit( primask );
+
+    return status;
+}
+
+/**
+ * @brief   Work a device's divisors out again after a system clock change
+ *
+ */
+static void spi_bus_update_clock( struct spi_device * device )
+{
+    uint32_t cpsr = device->cpsr;
+    uint32_t scr = (device->cr0 & SSI_CR0_SCR_M) >> SSI_CR0_SCR_S;
+
+    if ( device->max_bitrate )
+    {
+        uint8_t prescale;
+        uint8_t new_scr;
+
+        if ( ssi_calc_divisors( SystemCoreClock, device->max_bitrate, &prescale, &new_scr ) )
+        {
+            cpsr = prescale;
+            scr = new_scr;
+        }
+    }
+
+    device->cpsr = cpsr;
+    device->cr0 = (device->cr0 & ~SSI_CR0_SCR_M) | (scr << SSI_CR0_SCR_S);
+    device->bitrate = SystemCoreClock / (cpsr * (1U + scr));
+    device->clock_hz = SystemCoreClock;
+}
+
+/**
+ * @brief   Load a device's cached settings, only when it isn't already loaded
+ *
+ */
+static void spi_bus_select_device( struct spi_bus * bus, struct spi_device * device )
+{
+    struct ssi_regs * regs = bus->ssi->regs;
+
+    if ( device->clock_hz != SystemCoreClock )
+    {
+        spi_bus_update_clock( device );
+        bus->active_device = 0;
+    }
+
+    if ( bus->active_device == device )
+    {
+        return;
+    }
+
+    // CR0 and CPSR may only change with the module disabled
+    regs->CR1 &= ~SSI_CR1_SSE;
+    regs->CPSR = device->cpsr;
+    regs->CR0 = device->cr0;
+    regs->CR1 |= SSI_CR1_SSE;
+
+    // ssi_transfer packs frames by the handle's datasize
+    bus->ssi->config.datasize = device->datasize;
+
+    bus->active_device = device;
+    bus->stats.device_switches++;
+}
+
+static void spi_bus_update_window( struct spi_bus * bus )
+{
+    uint32_t now = cycles_now();
+    bus->stats.window_cycles += (uint32_t)(now - bus->window_mark);
+    bus->window_mark = now;
+}
+
+uint8_t spi_bus_process( struct spi_bus * bus )
+{
+    uint8_t count = 0;
+
+    if ( bus->processing )
+    {
+        return 0;
+    }
+    bus->processing = 1;
+
+    while ( bus->queue_tail != bus->queue_head )
+    {
+        struct spi_transaction * transaction = bus->queue[bus->queue_tail & SPI_BUS_QUEUE_MASK];
+        struct spi_device * device = transaction->device;
+
+        spi_bus_select_device( bus, device );
+
+        uint32_t start = cycles_now();
+        gpio_write( device->cs_gpio, device->cs_pin, 0 );
+        enum ssiret status = ssi_transfer( bus->ssi, transaction->tx, transaction->rx, transaction->length );
+        gpio_write( device->cs_gpio, device->cs_pin, 1 );
+        bus->stats.busy_cycles += (uint32_t)(cycles_now() - start);
+
+        bus->stats.transactions++;
+        bus->stats.bytes += transaction->length;
+
+        // Free the slot before the callback so it can queue a follow up
+        bus->queue_tail++;
+        transaction->status = (status == SSI_OK) ? SPI_TRANSACTION_DONE : SPI_TRANSACTION_FAILED;
+        if ( transaction->callback )
+        {
+            transaction->callback( transaction );
+        }
+        count++;
+    }
+
+    spi_bus_update_window( bus );
+    bus->processing = 0;
+
+    return count;
+}
+
+enum spi_bus_ret spi_bus_transfer( struct spi_device * device, const uint8_t * tx, uint8_t * rx, uint16_t length )
+{
+    struct spi_transaction transaction =
+    {
+        .device = device,
+        .tx = tx,
+        .rx = rx,
+        .length = length,
+        .callback = 0,
+        .context = 0,
+        .status = SPI_TRANSACTION_IDLE
+    };
+
+    // From a callback the outer spi_bus_process would never get back to it
+    if ( device->bus->processing )
+    {
+        return SPI_BUS_BUSY;
+    }
+
+    while ( spi_bus_submit( &transaction ) == SPI_BUS_QUEUE_FULL )
+    {
+        spi_bus_process( device->bus );
+    }
+    while ( transaction.status == SPI_TRANSACTION_QUEUED )
+    {
+        spi_bus_process( device->bus );
+    }
+
+    return (transaction.status == SPI_TRANSACTION_DONE) ? SPI_BUS_OK : SPI_BUS_TRANSFER_FAILED;
+}
+
+void spi_bus_get_stats( struct spi_bus * bus, struct spi_bus_stats * stats )
+{
+    spi_bus_update_window( bus );
+    *stats = bus->stats;
+}
+
+void spi_bus_reset_stats( struct spi_bus * bus )
+{
+    bus->stats.transactions = 0;
+    bus->stats.bytes = 0;
+    bus->stats.device_switches = 0;
+    bus->stats.queue_full = 0;
+    bus->stats.busy_cycles = 0;
+    bus->stats.window_cycles = 0;
+    bus->window_mark = cycles_now();
+}
+
+uint16_t spi_bus_utilisation( struct spi_bus * bus )
+{
+    spi_bus_update_window( bus );
+    if ( bus->stats.window_cycles == 0 )
+    {
+        return 0;
+    }
+    return (uint16_t)((bus->stats.busy_cycles * 1000U) / bus->stats.window_cycles);
+}
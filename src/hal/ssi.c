@@ -2,151 +2,843 @@
 
 #include "hal/tm4c123gh6pm.h"
 #include "hal/common.h"
+#include "hal/gpio.h"
+#include "hal/clock.h"
+#include "hal/clock_gate.h"
+#include "hal/idle.h"
 #include "hal/ssi.h"
+#include "hal/udma.h"
 
-enum ssi_pin
+#define SSI0_BASE 0x40008000U
+// Modules are 4KB apart
+#define SSI_STRIDE 0x1000U
+
+// Modes that keep the core out of deep sleep, in deep_sleep_holds
+#define SSI_HOLD_IRQ 0x01U
+#define SSI_HOLD_DMA 0x02U
+
+// TX and RX FIFOs are 8 frames deep
+#define SSI_FIFO_DEPTH 8U
+
+#define SSI_PRESCALE_MIN 2U
+#define SSI_PRESCALE_MAX 254U
+// SCR is 8 bits, divides by 1 + SCR
+#define SSI_SCR_DIVIDE_MAX 256U
+// Fastest SSIClk in master mode (40ns cycle)
+#define SSI_MASTER_MAX_BITRATE 25000000UL
+// A slave needs SysClk >= 12 * SSIClk
+#define SSI_SLAVE_CLOCK_RATIO 12U
+
+// NVIC interrupt numbers
+#define SSI0_IRQ 7U
+#define SSI1_IRQ 34U
+#define SSI2_IRQ 57U
+#define SSI3_IRQ 58U
+
+#define SSI_RING_MASK (SSI_RING_SIZE - 1U)
+
+#if (SSI_RING_SIZE & SSI_RING_MASK) != 0
+#error "SSI_RING_SIZE must be a power of 2"
+#endif
+
+// uDMA channels, RX then TX, and their CHMAP encoding
+#define SSI0_DMA_RX 10U
+#define SSI0_DMA_TX 11U
+#define SSI0_DMA_ENCODING 0U
+#define SSI1_DMA_RX 24U
+#define SSI1_DMA_TX 25U
+#define SSI1_DMA_ENCODING 0U
+#define SSI2_DMA_RX 12U
+#define SSI2_DMA_TX 13U
+#define SSI2_DMA_ENCODING 2U
+#define SSI3_DMA_RX 14U
+#define SSI3_DMA_TX 15U
+#define SSI3_DMA_ENCODING 2U
+
+struct ssi_pinmux_def
 {
-    // SSI0 Port A
-    SSI0_CLK = PIN_2,
-    SSI0_FSS = PIN_3,
-    SSI0_RX  = PIN_4,
-    SSI0_TX  = PIN_5
+    enum ssi_instance instance;
+    Port port;
+    uint8_t clk;
+    uint8_t fss;
+    uint8_t rx;
+    uint8_t tx;
+    // PCTL value
+    uint8_t function;
 };
 
-enum ssi_frame_format
+// Indexed by enum ssi_pinmux
+static const struct ssi_pinmux_def ssi_pinmux_defs[] =
 {
-    FREESCALE       =   (0U << 4U),
-    TEXASINST_SSF   =   (1U << 4U),
-    MICROWIRE       =   (2U << 4U)
+    { SSI_INSTANCE_0, PORT_A, PIN_2, PIN_3, PIN_4, PIN_5, 2U },
+    { SSI_INSTANCE_1, PORT_F, PIN_2, PIN_3, PIN_0, PIN_1, 2U },
+    { SSI_INSTANCE_1, PORT_D, PIN_0, PIN_1, PIN_2, PIN_3, 2U },
+    { SSI_INSTANCE_2, PORT_B, PIN_4, PIN_5, PIN_6, PIN_7, 2U },
+    { SSI_INSTANCE_3, PORT_D, PIN_0, PIN_1, PIN_2, PIN_3, 1U }
 };
 
-enum ssi_clock_polarity
+#define SSI_PINMUXES (sizeof(ssi_pinmux_defs) / sizeof(ssi_pinmux_defs[0]))
+
+static struct ssi_handle ssi_handles[SSI_INSTANCES] =
 {
-    STEADY_LOW  =   (0U << 6U),
-    // Must Enable Pull Up for CLK Pin
-    STEADY_HIGH =   (1U << 6U)
+    {
+        .regs = (struct ssi_regs *)(SSI0_BASE + (0U * SSI_STRIDE)), .instance = SSI_INSTANCE_0, .irq = SSI0_IRQ,
+        .dma_rx_channel = SSI0_DMA_RX, .dma_tx_channel = SSI0_DMA_TX, .dma_encoding = SSI0_DMA_ENCODING
+    },
+    {
+        .regs = (struct ssi_regs *)(SSI0_BASE + (1U * SSI_STRIDE)), .instance = SSI_INSTANCE_1, .irq = SSI1_IRQ,
+        .dma_rx_channel = SSI1_DMA_RX, .dma_tx_channel = SSI1_DMA_TX, .dma_encoding = SSI1_DMA_ENCODING
+    },
+    {
+        .regs = (struct ssi_regs *)(SSI0_BASE + (2U * SSI_STRIDE)), .instance = SSI_INSTANCE_2, .irq = SSI2_IRQ,
+        .dma_rx_channel = SSI2_DMA_RX, .dma_tx_channel = SSI2_DMA_TX, .dma_encoding = SSI2_DMA_ENCODING
+    },
+    {
+        .regs = (struct ssi_regs *)(SSI0_BASE + (3U * SSI_STRIDE)), .instance = SSI_INSTANCE_3, .irq = SSI3_IRQ,
+        .dma_rx_channel = SSI3_DMA_RX, .dma_tx_channel = SSI3_DMA_TX, .dma_encoding = SSI3_DMA_ENCODING
+    }
 };
 
-enum ssi_data_capture_clk_phase
+struct ssi_handle * ssi_get_handle( enum ssi_instance instance )
 {
-    FIRST_EDGE_TRANSITION   =   (0U << 7U),
-    SECOND_EDGE_TRANSITION  =   (1U << 7U)
-};
+    if ( instance >= SSI_INSTANCES )
+    {
+        return 0;
+    }
+    return &ssi_handles[instance];
+}
 
-enum ssi_datasize
-{
-    DATASIZE_4 = 0x03,
-    DATASIZE_5,
-    DATASIZE_6,
-    DATASIZE_7,
-    DATASIZE_8,
-    DATASIZE_9,
-    DATASIZE_10,
-    DATASIZE_11,
-    DATASIZE_12,
-    DATASIZE_13,
-    DATASIZE_14,
-    DATASIZE_15,
-    DATASIZE_16
-};
+static uint32_t ssi_clock_hz( void )
+{
+    return SystemCoreClock;
+}
 
-enum ssiret ssi0_init( void )
+/**
+ * @brief   Keep masters at their configured bit rate across clock changes.
+ *          Modules configured by prescale and scr are left as they are.
+ *
+ */
+static void ssi_clock_changed( enum clock_event event, uint32_t hz )
+{
+    (void)hz;
+
+    for ( uint8_t i = 0; i < SSI_INSTANCES; i++ )
+    {
+        struct ssi_handle * ssi = &ssi_handles[i];
+
+        if ( !ssi->initialised || ssi->config.mode != SSI_MODE_MASTER || !ssi->config.bitrate )
+        {
+            continue;
+        }
+
+        if ( event == CLOCK_PRE_CHANGE )
+        {
+            // Don't stretch a frame across the switch
+            ssi_wait_idle( ssi );
+        }
+        else
+        {
+            ssi_set_bitrate( ssi, ssi->config.bitrate, 0 );
+        }
+    }
+}
+
+uint32_t ssi_calc_divisors( uint32_t clock_hz, uint32_t bitrate, uint8_t * prescale, uint8_t * scr )
 {
-    // Enable SSI0 Module Clcok
-    SYSCTL_RCGCSSI_R |= SYSCTL_RCGCSSI_R0; 
+    uint32_t best = 0;
 
-    // Enable Clock for Port A
-    SYSCTL_RCGCGPIO_R |= PORT_A;
+    if ( bitrate == 0 )
+    {
+        return 0;
+    }
+    if ( bitrate > SSI_MASTER_MAX_BITRATE )
+    {
+        bitrate = SSI_MASTER_MAX_BITRATE;
+    }
+
+    // Smallest total divisor that keeps the rate at or below the request
+    uint32_t target = (clock_hz + bitrate - 1U) / bitrate;
 
-    // Enable High Performance Bus
-    SYSCTL_GPIOHBCTL_R |= PORT_A;
+    for ( uint32_t cpsdvsr = SSI_PRESCALE_MIN; cpsdvsr <= SSI_PRESCALE_MAX; cpsdvsr += 2U )
+    {
+        uint32_t divide = (target + cpsdvsr - 1U) / cpsdvsr;
+        if ( divide == 0 )
+        {
+            divide = 1;
+        }
+        if ( divide > SSI_SCR_DIVIDE_MAX )
+        {
+            continue;
+        }
 
-    // Pull Up Enable
-    // GPIO_PORTA_AHB_PUR_R |= SSI0_CLK;
+        uint32_t total = cpsdvsr * divide;
+        if ( best == 0 || total < best )
+        {
+            best = total;
+            *prescale = (uint8_t)cpsdvsr;
+            *scr = (uint8_t)(divide - 1U);
+        }
+        if ( total == target )
+        {
+            break;
+        }
+    }
 
-    // Don't rely on defaults. Unlock Pins and set AFSEL/PCTL/DIR
-    // Unlock all CR
-	GPIO_PORTA_AHB_LOCK_R = GPIO_LOCK_KEY;
+    return best ? (clock_hz / best) : 0;
+}
 
-    // Enable Alternate function on PA2,3,4,5
-    GPIO_PORTA_AHB_AFSEL_R |= SSI0_CLK | SSI0_FSS | SSI0_RX | SSI0_TX;           
+enum ssiret ssi_init( struct ssi_handle * ssi, const struct ssi_config * in_config )
+{
+    struct ssi_config derived = *in_config;
+    const struct ssi_config * config = &derived;
 
-    // SSI0 Mux, 0x02 for Pins 2, 3, 4, 5
-    GPIO_PORTA_AHB_PCTL_R |= (2U << 8U) | (2U << 12U) | (2U << 16U) | (2U << 20U);
+    if ( in_config->mode != SSI_MODE_MASTER )
+    {
+        // The master provides the clock, the prescaler only has to be legal
+        if ( in_config->bitrate > (ssi_clock_hz() / SSI_SLAVE_CLOCK_RATIO) )
+        {
+            return SSI_INVALID_CONFIG;
+        }
+        derived.prescale = SSI_PRESCALE_MIN;
+        derived.scr = 0;
+    }
+    else if ( in_config->bitrate &&
+              !ssi_calc_divisors( ssi_clock_hz(), in_config->bitrate, &derived.prescale, &derived.scr ) )
+    {
+        return SSI_INVALID_CONFIG;
+    }
 
-    // Disable Analog Mode
-    GPIO_PORTA_AHB_AMSEL_R &= ~(SSI0_CLK | SSI0_FSS | SSI0_RX | SSI0_TX);
+    if ( (unsigned)config->pins >= SSI_PINMUXES ||
+         ssi_pinmux_defs[config->pins].instance != ssi->instance ||
+         config->prescale < SSI_PRESCALE_MIN || config->prescale > SSI_PRESCALE_MAX ||
+         (config->prescale & 1U) ||
+         config->datasize < DATASIZE_4 || config->datasize > DATASIZE_16 )
+    {
+        return SSI_INVALID_CONFIG;
+    }
 
-	// Save programmed pins
-	GPIO_PORTA_AHB_CR_R |= 0xFF;
+    const struct ssi_pinmux_def * pins = &ssi_pinmux_defs[config->pins];
+    struct ssi_regs * regs = ssi->regs;
+    uint32_t module = 1U << ssi->instance;
+    uint8_t pin_mask = pins->clk | pins->rx | pins->tx;
 
-    // Lock CR
-    GPIO_PORTA_AHB_LOCK_R = 0;
+    if ( !config->software_fss )
+    {
+        pin_mask |= pins->fss;
+    }
 
-    // Digital Enable
-    GPIO_PORTA_AHB_DEN_R |= SSI0_CLK | SSI0_FSS | SSI0_RX | SSI0_TX;
+    // Enable SSI Module Clock, once per module, and wait until ready. Kept in
+    // sleep so DMA and interrupt transfers carry on
+    if ( !ssi->initialised )
+    {
+        clock_gate_enable( CLOCK_GATE_SSI, module, CLOCK_GATE_SLEEP );
+        gpio_enable_port( pins->port );
+    }
+    else if ( ssi_pinmux_defs[ssi->config.pins].port != pins->port )
+    {
+        gpio_enable_port( pins->port );
+        gpio_disable_port( ssi_pinmux_defs[ssi->config.pins].port );
+    }
+    gpio_set_alternate( pins->port, pin_mask, pins->function );
 
-    // Wait until 0x01 before proceeding - SSI Module Ready
-    while ( (SYSCTL_PRSSI_R & SYSCTL_PRSSI_R0) != 0x01 );
+    if ( config->polarity == STEADY_HIGH )
+    {
+        // Hold CLK high between frames
+        gpio_set_pull_up( pins->port, pins->clk );
+    }
 
     // Ensure SSI Module is Disabled
-    SSI0_CR1_R &= ~SSI_CR1_SSE;
+    regs->CR1 &= ~SSI_CR1_SSE;
 
-    // Master Mode
-    SSI0_CR1_R &= ~SSI_CR1_MS;
+    // Master or Slave Mode, only changed while disabled
+    regs->CR1 &= ~(SSI_CR1_MS | SSI_CR1_SOD);
+    if ( config->mode == SSI_MODE_SLAVE )
+    {
+        regs->CR1 |= SSI_CR1_MS;
+    }
+    else if ( config->mode == SSI_MODE_SLAVE_OUTPUT_DISABLED )
+    {
+        regs->CR1 |= SSI_CR1_MS | SSI_CR1_SOD;
+    }
 
     // Select Clock Source, System Clock
-    SSI0_CC_R |= SSI_CC_CS_SYSPLL;
-
-    // SSI Clock Prescale Divisor. Must be even, between 2 and 254
-    SSI0_CPSR_R |= 0x1A;
-
-    // SSI Configurations
-    // Serial Clock Rate Using Divisor Above - BR=SysClk/(CPSDVSR * (1 + SCR))
-    // 80Mhz / (24 * (1 + 0))
-    // SCR = 0
-    // SSI0_CR0_R |= (0 << 8U);
-    // // Data Capture Serial Clock Phase
-    // SSI0_CR0_R |= FIRST_EDGE_TRANSITION;
-    // // Clock Polarity
-    // SSI0_CR0_R |= STEADY_LOW;
-    // // Frame Format
-    // SSI0_CR0_R |= FREESCALE;
-
-    SSI0_CR0_R &= ~(SSI_CR0_SPH | SSI_CR0_SPO | SSI_CR0_SCR_M);
-    // 8 bit Data Size
-    SSI0_CR0_R |= DATASIZE_8;
+    regs->CC = SSI_CC_CS_SYSPLL;
+
+    // SSI Clock Prescale Divisor
+    regs->CPSR = config->prescale;
+
+    // BR = SysClk / (CPSDVSR * (1 + SCR))
+    regs->CR0 = ((uint32_t)config->scr << SSI_CR0_SCR_S) | config->phase | config->polarity |
+                config->frame_format | config->datasize;
+
+    ssi->config = *config;
+    ssi->initialised = 1;
+
+    clock_register_notifier( ssi_clock_changed );
 
     // Enable SSI Module
-    SSI0_CR1_R |= SSI_CR1_SSE;
+    regs->CR1 |= SSI_CR1_SSE;
 
     return SSI_OK;
 }
 
-enum ssiret ssi0_write( uint8_t byte )
+enum ssiret ssi_write( struct ssi_handle * ssi, uint16_t frame )
 {
-    while ( (SSI0_SR_R & SSI_SR_BSY) || !(SSI0_SR_R & SSI_SR_TNF) );
-    // Not Busy and Transmit Not Full
-    SSI0_DR_R = byte; // Transmit Data
+    struct ssi_regs * regs = ssi->regs;
+
+    // Wait for space in the TX FIFO
+    while ( !(regs->SR & SSI_SR_TNF) );
+    regs->DR = frame;
+
+    // Wait until transaction complete
+    while ( regs->SR & SSI_SR_BSY );
+
+    // Drop what was clocked in so the RX FIFO doesn't overrun
+    while ( regs->SR & SSI_SR_RNE )
+    {
+        (void)regs->DR;
+    }
 
-    // Until until transaction complete
-    while ( (SSI0_SR_R & SSI_SR_BSY) );
-    
     return SSI_OK;
 }
 
-enum ssiret ssi0_read( uint8_t * byte )
+enum ssiret ssi_read( struct ssi_handle * ssi, uint16_t * frame )
+{
+    struct ssi_regs * regs = ssi->regs;
+
+    if ( !(regs->SR & SSI_SR_RNE) )
+    {
+        return SSI_RX_FIFO_EMPTY;
+    }
+    *frame = (uint16_t)regs->DR;
+
+    return SSI_OK;
+}
+
+enum ssiret ssi_transfer( struct ssi_handle * ssi, const uint8_t * tx, uint8_t * rx, uint16_t length )
 {
-    enum ssiret status = SSI_OK;
-    if ( !(SSI0_SR_R & SSI_SR_BSY) && (SSI0_SR_R & SSI_SR_RNE) )
+    struct ssi_regs * regs = ssi->regs;
+    uint8_t packed = (ssi->config.datasize == DATASIZE_16);
+    uint16_t frames = length;
+    uint16_t sent = 0;
+    uint16_t received = 0;
+
+    if ( packed )
+    {
+        if ( length & 1U )
+        {
+            return SSI_INVALID_CONFIG;
+        }
+        frames = length / 2U;
+    }
+    else if ( ssi->config.datasize > DATASIZE_8 )
     {
-        // Not Busy and Receive Not Empty
-        *byte = SSI0_DR_R;
+        return SSI_INVALID_CONFIG;
+    }
+
+    // Stale frames would shift the received data
+    while ( regs->SR & SSI_SR_RNE )
+    {
+        (void)regs->DR;
+    }
+
+    while ( received < frames )
+    {
+        uint32_t status = regs->SR;
+
+        // Frames in flight are capped at the RX FIFO depth so it never overruns
+        if ( sent < frames && (uint16_t)(sent - received) < SSI_FIFO_DEPTH && (status & SSI_SR_TNF) )
+        {
+            uint16_t frame;
+            if ( !tx )
+            {
+                frame = packed ? ((SSI_READ_FILL << 8U) | SSI_READ_FILL) : SSI_READ_FILL;
+            }
+            else if ( packed )
+            {
+                frame = ((uint16_t)tx[2U * sent] << 8U) | tx[(2U * sent) + 1U];
+            }
+            else
+            {
+                frame = tx[sent];
+            }
+            regs->DR = frame;
+            sent++;
+        }
+
+        if ( status & SSI_SR_RNE )
+        {
+            uint16_t frame = (uint16_t)regs->DR;
+            if ( rx && packed )
+            {
+                rx[2U * received] = (uint8_t)(frame >> 8U);
+                rx[(2U * received) + 1U] = (uint8_t)frame;
+            }
+            else if ( rx )
+            {
+                rx[received] = (uint8_t)frame;
+            }
+            received++;
+        }
+    }
+
+    return SSI_OK;
+}
+
+enum ssiret ssi_write_buf( struct ssi_handle * ssi, const uint8_t * tx, uint16_t length )
+{
+    return ssi_transfer( ssi, tx, 0, length );
+}
+
+enum ssiret ssi_read_buf( struct ssi_handle * ssi, uint8_t * rx, uint16_t length )
+{
+    return ssi_transfer( ssi, 0, rx, length );
+}
+
+void ssi_wait_idle( struct ssi_handle * ssi )
+{
+    struct ssi_regs * regs = ssi->regs;
+
+    while ( !(regs->SR & SSI_SR_TFE) || (regs->SR & SSI_SR_BSY) );
+}
+
+void ssi_set_loopback( struct ssi_handle * ssi, uint8_t enable )
+{
+    struct ssi_regs * regs = ssi->regs;
+
+    ssi_wait_idle( ssi );
+
+    if ( enable )
+    {
+        regs->CR1 |= SSI_CR1_LBM;
     }
     else
     {
-        status = SSI_RX_FIFO_EMPTY;
+        regs->CR1 &= ~SSI_CR1_LBM;
+    }
+}
+
+enum ssiret ssi_set_bitrate( struct ssi_handle * ssi, uint32_t bitrate, uint32_t * achieved )
+{
+    struct ssi_regs * regs = ssi->regs;
+    uint8_t prescale;
+    uint8_t scr;
+    uint32_t rate = ssi_calc_divisors( ssi_clock_hz(), bitrate, &prescale, &scr );
+
+    if ( !rate || !ssi->initialised )
+    {
+        return SSI_INVALID_CONFIG;
+    }
+
+    ssi_wait_idle( ssi );
+
+    // Clock registers may only change with the module disabled
+    regs->CR1 &= ~SSI_CR1_SSE;
+    regs->CPSR = prescale;
+    regs->CR0 = (regs->CR0 & ~SSI_CR0_SCR_M) | ((uint32_t)scr << SSI_CR0_SCR_S);
+    regs->CR1 |= SSI_CR1_SSE;
+
+    ssi->config.bitrate = bitrate;
+    ssi->config.prescale = prescale;
+    ssi->config.scr = scr;
+
+    if ( achieved )
+    {
+        *achieved = rate;
     }
-    
+
+    return SSI_OK;
+}
+
+uint32_t ssi_get_bitrate( struct ssi_handle * ssi )
+{
+    struct ssi_regs * regs = ssi->regs;
+    uint32_t cpsdvsr = regs->CPSR & SSI_CPSR_CPSDVSR_M;
+    uint32_t divide = ((regs->CR0 & SSI_CR0_SCR_M) >> SSI_CR0_SCR_S) + 1U;
+
+    if ( cpsdvsr == 0 )
+    {
+        return 0;
+    }
+    return ssi_clock_hz() / (cpsdvsr * divide);
+}
+
+static void ssi_nvic_enable( uint8_t irq )
+{
+    ((volatile uint32_t *)&NVIC_EN0_R)[irq / 32U] = 1UL << (irq % 32U);
+}
+
+static void ssi_nvic_disable( uint8_t irq )
+{
+    ((volatile uint32_t *)&NVIC_DIS0_R)[irq / 32U] = 1UL << (irq % 32U);
+}
+
+/**
+ * @brief   Take or release one mode's hold on deep sleep. The module is only
+ *          clocked in run and sleep mode, so idle must not go deeper while
+ *          any mode can move frames. Only the first take and last release
+ *          reach idle. Called with the module's interrupt off, so its ISR
+ *          can't change the holds underneath.
+ *
+ */
+static void ssi_hold_deep_sleep( struct ssi_handle * ssi, uint8_t mode, uint8_t hold )
+{
+    uint8_t holds = hold ? (ssi->deep_sleep_holds | mode) : (ssi->deep_sleep_holds & ~mode);
+
+    if ( holds && !ssi->deep_sleep_holds )
+    {
+        idle_block_deep_sleep();
+    }
+    else if ( !holds && ssi->deep_sleep_holds )
+    {
+        idle_allow_deep_sleep();
+    }
+    ssi->deep_sleep_holds = holds;
+}
+
+static uint16_t ssi_ring_count( const struct ssi_ring * ring )
+{
+    return (uint16_t)(ring->head - ring->tail);
+}
+
+/**
+ * @brief   Move RX FIFO contents into the RX ring, or discard them
+ *
+ */
+static void ssi_drain_rx( struct ssi_handle * ssi )
+{
+    struct ssi_regs * regs = ssi->regs;
+    struct ssi_ring * rx = &ssi->rx;
+    uint8_t dropped = 0;
+
+    while ( regs->SR & SSI_SR_RNE )
+    {
+        uint16_t frame = (uint16_t)regs->DR;
+
+        if ( !ssi->receive )
+        {
+            continue;
+        }
+
+        if ( ssi_ring_count( rx ) >= SSI_RING_SIZE )
+        {
+            ssi->rx_dropped++;
+            dropped = 1;
+            continue;
+        }
+
+        rx->buffer[rx->head & SSI_RING_MASK] = frame;
+        rx->head++;
+    }
+
+    if ( dropped && ssi->callback )
+    {
+        ssi->callback( ssi, SSI_EVENT_RX_BUFFER_OVERRUN );
+    }
+}
+
+static void ssi_isr( struct ssi_handle * ssi )
+{
+    struct ssi_regs * regs = ssi->regs;
+    struct ssi_ring * tx = &ssi->tx;
+    uint32_t status = regs->MIS;
+
+    // uDMA completion arrives on the peripheral's vector
+    if ( (regs->DMACTL & SSI_DMACTL_RXDMAE) && udma_take_interrupt( ssi->dma_rx_channel ) && ssi->callback )
+    {
+        ssi->callback( ssi, SSI_EVENT_DMA_RX_DONE );
+    }
+    if ( (regs->DMACTL & SSI_DMACTL_TXDMAE) && udma_take_interrupt( ssi->dma_tx_channel ) && ssi->callback )
+    {
+        ssi->callback( ssi, SSI_EVENT_DMA_TX_DONE );
+    }
+
+    if ( status & SSI_MIS_RORMIS )
+    {
+        regs->ICR = SSI_ICR_RORIC;
+        if ( ssi->callback )
+        {
+            ssi->callback( ssi, SSI_EVENT_RX_FIFO_OVERRUN );
+        }
+    }
+
+    if ( status & SSI_MIS_RTMIS )
+    {
+        regs->ICR = SSI_ICR_RTIC;
+    }
+
+    // Always drain in interrupt mode, every TX frame clocks in an RX frame.
+    // With RX DMA the FIFO belongs to the controller
+    if ( !(regs->DMACTL & SSI_DMACTL_RXDMAE) )
+    {
+        ssi_drain_rx( ssi );
+    }
+
+    if ( !(status & SSI_MIS_TXMIS) )
+    {
+        return;
+    }
+
+    if ( regs->CR1 & SSI_CR1_EOT )
+    {
+        // FIFO empty and the last bit is out
+        regs->IM &= ~SSI_IM_TXIM;
+        regs->CR1 &= ~SSI_CR1_EOT;
+        ssi_drain_rx( ssi );
+        ssi->tx_active = 0;
+
+        if ( ssi->callback )
+        {
+            ssi->callback( ssi, SSI_EVENT_TX_COMPLETE );
+        }
+        return;
+    }
+
+    // FIFO half empty, top it up
+    while ( (tx->tail != tx->head) && (regs->SR & SSI_SR_TNF) )
+    {
+        regs->DR = tx->buffer[tx->tail & SSI_RING_MASK];
+        tx->tail++;
+    }
+
+    if ( tx->tail == tx->head )
+    {
+        // Nothing left to queue. Interrupt again when the line goes idle
+        regs->CR1 |= SSI_CR1_EOT;
+    }
+}
+
+enum ssiret ssi_irq_enable( struct ssi_handle * ssi, ssi_callback callback, uint8_t receive )
+{
+    struct ssi_regs * regs = ssi->regs;
+
+    if ( !ssi->initialised )
+    {
+        return SSI_INVALID_CONFIG;
+    }
+
+    ssi_nvic_disable( ssi->irq );
+
+    ssi->tx.head = ssi->tx.tail = 0;
+    ssi->rx.head = ssi->rx.tail = 0;
+    ssi->callback = callback;
+    ssi->receive = receive;
+    ssi->tx_active = 0;
+    ssi->rx_dropped = 0;
+
+    regs->CR1 &= ~SSI_CR1_EOT;
+    regs->ICR = SSI_ICR_RORIC | SSI_ICR_RTIC;
+
+    // TX is unmasked only while frames are queued
+    regs->IM = SSI_IM_RXIM | SSI_IM_RTIM | SSI_IM_RORIM;
+
+    ssi_hold_deep_sleep( ssi, SSI_HOLD_IRQ, 1 );
+    ssi_nvic_enable( ssi->irq );
+
+    return SSI_OK;
+}
+
+void ssi_irq_disable( struct ssi_handle * ssi )
+{
+    struct ssi_regs * regs = ssi->regs;
+
+    regs->IM = 0;
+    ssi_nvic_disable( ssi->irq );
+
+    regs->CR1 &= ~SSI_CR1_EOT;
+    ssi->tx.head = ssi->tx.tail;
+    ssi->tx_active = 0;
+
+    ssi_hold_deep_sleep( ssi, SSI_HOLD_IRQ, 0 );
+}
+
+/**
+ * @brief   Start or resume the TX interrupt after frames were queued
+ *
+ */
+static void ssi_irq_kick( struct ssi_handle * ssi )
+{
+    struct ssi_regs * regs = ssi->regs;
+
+    // Masking TX keeps the ISR off CR1 while EOT is cleared. A pending EOT
+    // completion is dropped, the new frames complete instead
+    regs->IM &= ~SSI_IM_TXIM;
+    regs->CR1 &= ~SSI_CR1_EOT;
+    ssi->tx_active = 1;
+    regs->IM |= SSI_IM_TXIM;
+}
+
+uint16_t ssi_irq_write( struct ssi_handle * ssi, const uint16_t * frames, uint16_t count )
+{
+    struct ssi_ring * tx = &ssi->tx;
+    uint16_t queued = 0;
+
+    while ( queued < count && ssi_ring_count( tx ) < SSI_RING_SIZE )
+    {
+        tx->buffer[tx->head & SSI_RING_MASK] = frames[queued++];
+        tx->head++;
+    }
+
+    if ( queued )
+    {
+        ssi_irq_kick( ssi );
+    }
+
+    return queued;
+}
+
+uint16_t ssi_irq_write_bytes( struct ssi_handle * ssi, const uint8_t * bytes, uint16_t count )
+{
+    struct ssi_ring * tx = &ssi->tx;
+    uint16_t queued = 0;
+
+    while ( queued < count && ssi_ring_count( tx ) < SSI_RING_SIZE )
+    {
+        tx->buffer[tx->head & SSI_RING_MASK] = bytes[queued++];
+        tx->head++;
+    }
+
+    if ( queued )
+    {
+        ssi_irq_kick( ssi );
+    }
+
+    return queued;
+}
+
+uint16_t ssi_irq_read( struct ssi_handle * ssi, uint16_t * frames, uint16_t max )
+{
+    struct ssi_ring * rx = &ssi->rx;
+    uint16_t read = 0;
+
+    while ( read < max && rx->tail != rx->head )
+    {
+        frames[read++] = rx->buffer[rx->tail & SSI_RING_MASK];
+        rx->tail++;
+    }
+
+    return read;
+}
+
+uint8_t ssi_irq_busy( struct ssi_handle * ssi )
+{
+    return ssi->tx_active;
+}
+
+enum ssiret ssi_dma_enable( struct ssi_handle * ssi, ssi_callback callback, uint8_t rx, uint8_t tx )
+{
+    struct ssi_regs * regs = ssi->regs;
+    uint32_t dmactl = 0;
+
+    if ( !ssi->initialised )
+    {
+        return SSI_INVALID_CONFIG;
+    }
+
+    ssi_nvic_disable( ssi->irq );
+    regs->IM = 0;
+    ssi->callback = callback;
+
+    if ( rx )
+    {
+        udma_assign_channel( ssi->dma_rx_channel, ssi->dma_encoding );
+        dmactl |= SSI_DMACTL_RXDMAE;
+    }
+    if ( tx )
+    {
+        udma_assign_channel( ssi->dma_tx_channel, ssi->dma_encoding );
+        dmactl |= SSI_DMACTL_TXDMAE;
+    }
+    regs->DMACTL = dmactl;
+
+    ssi_hold_deep_sleep( ssi, SSI_HOLD_DMA, 1 );
+    ssi_nvic_enable( ssi->irq );
+
+    return SSI_OK;
+}
+
+void ssi_dma_disable( struct ssi_handle * ssi )
+{
+    struct ssi_regs * regs = ssi->regs;
+
+    ssi_nvic_disable( ssi->irq );
+    udma_disable( ssi->dma_rx_channel );
+    udma_disable( ssi->dma_tx_channel );
+    regs->DMACTL = 0;
+
+    ssi_hold_deep_sleep( ssi, SSI_HOLD_DMA, 0 );
+}
+
+void ssi_deinit( struct ssi_handle * ssi )
+{
+    if ( !ssi->initialised )
+    {
+        return;
+    }
+
+    ssi_wait_idle( ssi );
+    ssi_irq_disable( ssi );
+    ssi_dma_disable( ssi );
+    ssi->regs->CR1 &= ~SSI_CR1_SSE;
+    ssi->initialised = 0;
+
+    clock_gate_disable( CLOCK_GATE_SSI, 1U << ssi->instance, CLOCK_GATE_SLEEP );
+    gpio_disable_port( ssi_pinmux_defs[ssi->config.pins].port );
+}
+
+void SSI0IntHandler( void )
+{
+    ssi_isr( &ssi_handles[SSI_INSTANCE_0] );
+}
+
+void SSI1IntHandler( void )
+{
+    ssi_isr( &ssi_handles[SSI_INSTANCE_1] );
+}
+
+void SSI2IntHandler( void )
+{
+    ssi_isr( &ssi_handles[SSI_INSTANCE_2] );
+}
+
+void SSI3IntHandler( void )
+{
+    ssi_isr( &ssi_handles[SSI_INSTANCE_3] );
+}
+
+enum ssiret ssi0_init( void )
+{
+    // SPI mode 0, 8 bit
+    const struct ssi_config config =
+    {
+        .pins = SSI_PINMUX_SSI0_PA2_PA5,
+        .frame_format = FREESCALE,
+        .polarity = STEADY_LOW,
+        .phase = FIRST_EDGE_TRANSITION,
+        .datasize = DATASIZE_8,
+        .bitrate = SSI0_DEFAULT_BITRATE,
+        .prescale = 0,
+        .scr = 0,
+        .software_fss = 0
+    };
+
+    return ssi_init( ssi_get_handle( SSI_INSTANCE_0 ), &config );
+}
+
+enum ssiret ssi0_write( uint8_t byte )
+{
+    return ssi_write( &ssi_handles[SSI_INSTANCE_0], byte );
+}
+
+enum ssiret ssi0_read( uint8_t * byte )
+{
+    uint16_t frame;
+    enum ssiret status = ssi_read( &ssi_handles[SSI_INSTANCE_0], &frame );
+
+    if ( status == SSI_OK )
+    {
+        *byte = (uint8_t)frame;
+    }
+
     return status;
 }
@@ -0,0 +1,288 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock.h"
+#include "hal/ssi.h"
+#include "hal/ssi_bench.h"
+#include "hal/udma.h"
+#include "util/cycles.h"
+#include "util/report.h"
+
+#define BENCH_DMA_RX_CONTROL (UDMA_PERIPHERAL_TO_MEMORY_8 | UDMA_CHCTL_ARBSIZE_4 | UDMA_CHCTL_XFERMODE_BASIC)
+#define BENCH_DMA_TX_CONTROL (UDMA_MEMORY_TO_PERIPHERAL_8 | UDMA_CHCTL_ARBSIZE_4 | UDMA_CHCTL_XFERMODE_BASIC)
+
+// Length of the idle loop calibration run
+#define BENCH_CALIBRATION_CYCLES 10000UL
+
+// Idle loop cost is kept with 8 fractional bits
+#define BENCH_COST_FRACTION_BITS 8U
+
+static const uint16_t bench_sizes[SSI_BENCH_SIZES] = {1U, 16U, 64U, 256U, SSI_BENCH_MAX_LENGTH};
+
+static const char * const bench_mode_names[SSI_BENCH_MODES] = {"polled", "bulk", "irq", "dma"};
+
+static uint8_t bench_tx[SSI_BENCH_MAX_LENGTH];
+static uint8_t bench_rx[SSI_BENCH_MAX_LENGTH];
+
+// Transfer state shared with the interrupt callbacks
+static volatile uint8_t bench_done = 0;
+static uint16_t bench_length = 0;
+static uint16_t bench_queued = 0;
+static uint16_t bench_received = 0;
+
+// Cycles per idle loop iteration, fixed point
+static uint32_t bench_idle_cost = 0;
+
+/**
+ * @brief   Spin until bench_done is set or the timeout passes. Reading the
+ *          cycle counter each time round keeps the cost per iteration fixed.
+ *
+ * @return uint32_t Iterations run
+ */
+static uint32_t bench_idle( uint32_t start, uint32_t timeout, uint8_t * timed_out )
+{
+    uint32_t iterations = 0;
+
+    while ( !bench_done )
+    {
+        iterations++;
+        if ( (cycles_now() - start) > timeout )
+        {
+            *timed_out = 1;
+            break;
+        }
+    }
+    return iterations;
+}
+
+static void bench_calibrate( void )
+{
+    uint8_t timed_out = 0;
+
+    bench_done = 0;
+    uint32_t start = cycles_now();
+    uint32_t iterations = bench_idle( start, BENCH_CALIBRATION_CYCLES, &timed_out );
+    uint32_t elapsed = cycles_now() - start;
+
+    bench_idle_cost = iterations ? ((elapsed << BENCH_COST_FRACTION_BITS) / iterations) : 0;
+}
+
+static void bench_irq_event( struct ssi_handle * ssi, enum ssi_event event )
+{
+    uint16_t frames[SSI_RING_SIZE];
+
+    if ( event != SSI_EVENT_TX_COMPLETE )
+    {
+        return;
+    }
+
+    // Every queued frame is back in the RX ring by now
+    uint16_t count = ssi_irq_read( ssi, frames, SSI_RING_SIZE );
+    for ( uint16_t i = 0; i < count && bench_received < bench_length; i++ )
+    {
+        bench_rx[bench_received++] = (uint8_t)frames[i];
+    }
+
+    if ( bench_queued < bench_length )
+    {
+        uint16_t chunk = bench_length - bench_queued;
+        if ( chunk > SSI_RING_SIZE )
+        {
+            chunk = SSI_RING_SIZE;
+        }
+        bench_queued += ssi_irq_write_bytes( ssi, &bench_tx[bench_queued], chunk );
+        return;
+    }
+
+    bench_done = 1;
+}
+
+static void bench_dma_event( struct ssi_handle * ssi, enum ssi_event event )
+{
+    (void)ssi;
+
+    // RX completes last
+    if ( event == SSI_EVENT_DMA_RX_DONE )
+    {
+        bench_done = 1;
+    }
+}
+
+/**
+ * @brief   Run one transfer and fill in its result
+ *
+ */
+static void bench_one( struct ssi_handle * ssi, enum ssi_bench_mode mode, uint16_t length,
+                       struct ssi_bench_result * result )
+{
+    uint32_t timeout = SSI_BENCH_TIMEOUT_US * CYCLES_PER_US;
+    uint32_t idle_iterations = 0;
+    uint8_t timed_out = 0;
+
+    for ( uint16_t i = 0; i < length; i++ )
+    {
+        bench_tx[i] = (uint8_t)((i * 7U) + length);
+        bench_rx[i] = (uint8_t)~bench_tx[i];
+    }
+
+    bench_done = 0;
+    bench_length = length;
+    bench_queued = 0;
+    bench_received = 0;
+
+    if ( mode == SSI_BENCH_IRQ )
+    {
+        ssi_irq_enable( ssi, bench_irq_event, 1 );
+    }
+
+    uint32_t start = cycles_now();
+
+    switch ( mode )
+    {
+        case SSI_BENCH_POLLED:
+            for ( uint16_t i = 0; i < length; i++ )
+            {
+                ssi_write( ssi, bench_tx[i] );
+            }
+            break;
+
+        case SSI_BENCH_BULK:
+            ssi_transfer( ssi, bench_tx, bench_rx, length );
+            break;
+
+        case SSI_BENCH_IRQ:
+            bench_queued = ssi_irq_write_bytes( ssi, bench_tx, (length > SSI_RING_SIZE) ? SSI_RING_SIZE : length );
+            idle_iterations = bench_idle( start, timeout, &timed_out );
+            break;
+
+        case SSI_BENCH_DMA:
+        default:
+            ssi_dma_enable( ssi, bench_dma_event, 1, 1 );
+            udma_set_high_priority( ssi->dma_rx_channel );
+            udma_set_transfer( ssi->dma_rx_channel, UDMA_PRIMARY, BENCH_DMA_RX_CONTROL,
+                               &ssi->regs->DR, bench_rx, length );
+            udma_set_transfer( ssi->dma_tx_channel, UDMA_PRIMARY, BENCH_DMA_TX_CONTROL,
+                               bench_tx, &ssi->regs->DR, length );
+            udma_enable( ssi->dma_rx_channel );
+            udma_enable( ssi->dma_tx_channel );
+            idle_iterations = bench_idle( start, timeout, &timed_out );
+            break;
+    }
+
+    uint32_t cycles = cycles_now() - start;
+
+    if ( mode == SSI_BENCH_IRQ )
+    {
+        ssi_irq_disable( ssi );
+    }
+    else if ( mode == SSI_BENCH_DMA )
+    {
+        ssi_dma_disable( ssi );
+    }
+
+    uint64_t idle_cycles = ((uint64_t)idle_iterations * bench_idle_cost) >> BENCH_COST_FRACTION_BITS;
+    if ( idle_cycles > cycles )
+    {
+        idle_cycles = cycles;
+    }
+
+    result->mode = mode;
+    result->length = length;
+    result->cycles = cycles;
+    result->bytes_per_second = cycles ? (uint32_t)(((uint64_t)length * SystemCoreClock) / cycles) : 0;
+    result->cpu_load = cycles ? (uint16_t)(1000U - ((idle_cycles * 1000U) / cycles)) : 1000U;
+    result->timed_out = timed_out;
+    result->errors = 0;
+
+    if ( mode != SSI_BENCH_POLLED )
+    {
+        for ( uint16_t i = 0; i < length; i++ )
+        {
+            if ( bench_rx[i] != bench_tx[i] )
+            {
+                result->errors++;
+            }
+        }
+    }
+
+    // Leave nothing behind for the next run
+    ssi_wait_idle( ssi );
+    while ( ssi->regs->SR & SSI_SR_RNE )
+    {
+        (void)ssi->regs->DR;
+    }
+}
+
+uint8_t ssi_bench_run( enum ssi_instance instance, enum ssi_pinmux pins, uint32_t bitrate,
+                       struct ssi_bench_result * results, uint8_t max )
+{
+    struct ssi_handle * ssi = ssi_get_handle( instance );
+    const struct ssi_config config =
+    {
+        .pins = pins,
+        .mode = SSI_MODE_MASTER,
+        .frame_format = FREESCALE,
+        .polarity = STEADY_LOW,
+        .phase = FIRST_EDGE_TRANSITION,
+        .datasize = DATASIZE_8,
+        .bitrate = bitrate,
+        .software_fss = 0
+    };
+    uint8_t count = 0;
+
+    if ( !ssi || ssi_init( ssi, &config ) != SSI_OK )
+    {
+        return 0;
+    }
+
+    cycles_init();
+    udma_init();
+    ssi_set_loopback( ssi, 1 );
+    bench_calibrate();
+
+    for ( uint8_t mode = 0; mode < SSI_BENCH_MODES; mode++ )
+    {
+        for ( uint8_t size = 0; size < SSI_BENCH_SIZES && count < max; size++ )
+        {
+            bench_one( ssi, (enum ssi_bench_mode)mode, bench_sizes[size], &results[count++] );
+        }
+    }
+
+    ssi_set_loopback( ssi, 0 );
+
+    return count;
+}
+
+void ssi_bench_report( const struct ssi_bench_result * results, uint8_t count, ssi_bench_put put )
+{
+    for ( uint8_t i = 0; i < count; i++ )
+    {
+        const struct ssi_bench_result * result = &results[i];
+
+        // e.g. "dma      1024 B    21000 cyc  3900952 B/s  cpu   3.1%  err 0"
+        report_put_string( put, bench_mode_names[result->mode], 7 );
+        report_put_uint( put, result->length, 5 );
+        report_put_string( put, " B ", 0 );
+        report_put_uint( put, result->cycles, 8 );
+        report_put_string( put, " cyc ", 0 );
+        report_put_uint( put, result->bytes_per_second, 8 );
+        report_put_string( put, " B/s  cpu ", 0 );
+        report_put_uint( put, result->cpu_load / 10U, 3 );
+        put( '.' );
+        report_put_uint( put, result->cpu_load % 10U, 1 );
+        report_put_string( put, "%  err ", 0 );
+        if ( result->mode == SSI_BENCH_POLLED )
+        {
+            put( '-' );
+        }
+        else
+        {
+            report_put_uint( put, result->errors, 0 );
+        }
+        if ( result->timed_out )
+        {
+            report_put_string( put, "  timeout", 0 );
+        }
+        report_put_line_end( put );
+    }
+}
@@ -0,0 +1,291 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock.h"
+#include "hal/idle.h"
+#include "hal/ssi.h"
+#include "hal/ssi_stream.h"
+#include "hal/timer.h"
+#include "hal/udma.h"
+
+// Timer requests are bursts of one frame per timeout
+#define STREAM_TIMER_CONTROL_INPUT (UDMA_FIXED_TO_PERIPHERAL_16 | UDMA_CHCTL_ARBSIZE_1 | UDMA_CHCTL_XFERMODE_PINGPONG)
+#define STREAM_TIMER_CONTROL_OUTPUT (UDMA_MEMORY_TO_PERIPHERAL_16 | UDMA_CHCTL_ARBSIZE_1 | UDMA_CHCTL_XFERMODE_PINGPONG)
+#define STREAM_RX_CONTROL (UDMA_PERIPHERAL_TO_MEMORY_16 | UDMA_CHCTL_ARBSIZE_4 | UDMA_CHCTL_XFERMODE_PINGPONG)
+
+// Microwire control word, always 8 bits
+#define STREAM_MICROWIRE_COMMAND_BITS 8U
+
+static struct ssi_stream * ssi_streams[SSI_INSTANCES] = {0};
+static struct ssi_stream * timer_streams[TIMER_INSTANCES] = {0};
+
+/**
+ * @brief   Timer period closest to a sample rate
+ *
+ */
+static uint32_t stream_period( uint32_t clock_hz, uint32_t sample_rate )
+{
+    return (clock_hz + (sample_rate / 2U)) / sample_rate;
+}
+
+/**
+ * @brief   Keep streams at their sample rate across clock changes. The SSI
+ *          driver recomputes the bit rate itself
+ *
+ */
+static void stream_clock_changed( enum clock_event event, uint32_t hz )
+{
+    if ( event != CLOCK_POST_CHANGE )
+    {
+        return;
+    }
+
+    for ( uint8_t i = 0; i < SSI_INSTANCES; i++ )
+    {
+        struct ssi_stream * stream = ssi_streams[i];
+        if ( stream )
+        {
+            uint32_t period = stream_period( hz, stream->requested_rate );
+            if ( timer_set_period( stream->timer, period ) == TIMER_OK )
+            {
+                stream->sample_rate = hz / period;
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Serial clocks one conversion occupies, with the gaps the frame
+ *          format inserts between frames
+ *
+ */
+static uint32_t stream_frame_clocks( enum ssi_frame_format format, enum ssi_datasize datasize )
+{
+    uint32_t bits = (uint32_t)datasize + 1U;
+
+    switch ( format )
+    {
+        case TEXASINST_SSF:
+            // Frame pulse
+            return bits + 1U;
+        case MICROWIRE:
+            // Command, turnaround, reply
+            return STREAM_MICROWIRE_COMMAND_BITS + 1U + bits;
+        case FREESCALE:
+        default:
+            // FSS pulses high between frames with SPH 0
+            return bits + 2U;
+    }
+}
+
+static void stream_arm_timer( struct ssi_stream * stream, enum udma_select select )
+{
+    volatile void * dr = &stream->ssi->regs->DR;
+
+    if ( stream->direction == SSI_STREAM_INPUT )
+    {
+        udma_set_transfer( stream->timer_channel, select, STREAM_TIMER_CONTROL_INPUT,
+                           &stream->command, dr, stream->block_samples );
+    }
+    else
+    {
+        udma_set_transfer( stream->timer_channel, select, STREAM_TIMER_CONTROL_OUTPUT,
+                           stream->blocks[select], dr, stream->block_samples );
+    }
+}
+
+static void stream_arm_rx( struct ssi_stream * stream, enum udma_select select )
+{
+    udma_set_transfer( stream->ssi->dma_rx_channel, select, STREAM_RX_CONTROL,
+                       &stream->ssi->regs->DR, stream->blocks[select], stream->block_samples );
+}
+
+/**
+ * @brief   Hand finished blocks to the callback and re-arm them
+ *
+ * @param stream Stream
+ * @param channel Channel whose descriptors mark block completion
+ */
+static void stream_service( struct ssi_stream * stream, uint8_t channel )
+{
+    for ( uint8_t i = 0; i < 2U && udma_get_mode( channel, stream->next ) == UDMA_CHCTL_XFERMODE_STOP; i++ )
+    {
+        enum udma_select done = stream->next;
+
+        stream->callback( stream, stream->blocks[done], stream->block_samples );
+
+        if ( stream->direction == SSI_STREAM_INPUT )
+        {
+            // The command for the last sample went out before its reply came
+            // back, so the timer descriptor of this block is finished too
+            stream_arm_timer( stream, done );
+            stream_arm_rx( stream, done );
+        }
+        else
+        {
+            stream_arm_timer( stream, done );
+        }
+
+        stream->next = (done == UDMA_PRIMARY) ? UDMA_ALTERNATE : UDMA_PRIMARY;
+        stream->blocks_done++;
+    }
+
+    if ( !udma_is_enabled( channel ) )
+    {
+        // Both blocks finished before this ran
+        stream->overruns++;
+        udma_enable( channel );
+        udma_enable( stream->timer_channel );
+    }
+}
+
+static void stream_ssi_done( struct ssi_handle * ssi, enum ssi_event event )
+{
+    struct ssi_stream * stream = ssi_streams[ssi->instance];
+
+    if ( event == SSI_EVENT_DMA_RX_DONE && stream && stream->running )
+    {
+        stream_service( stream, ssi->dma_rx_channel );
+    }
+}
+
+static void stream_timer_done( enum timer_instance instance )
+{
+    struct ssi_stream * stream = timer_streams[instance];
+
+    if ( stream && udma_take_interrupt( stream->timer_channel ) && stream->running )
+    {
+        stream_service( stream, stream->timer_channel );
+    }
+}
+
+enum ssi_stream_ret ssi_stream_init( struct ssi_stream * stream, const struct ssi_stream_config * config )
+{
+    uint8_t encoding = 0;
+    struct ssi_handle * ssi = ssi_get_handle( config->instance );
+
+    if ( !ssi || (unsigned)config->timer >= TIMER_INSTANCES || !config->callback ||
+         !config->blocks[0] || !config->blocks[1] ||
+         config->block_samples == 0 || config->block_samples > UDMA_MAX_TRANSFER ||
+         config->sample_rate == 0 || config->sample_rate > (SystemCoreClock / 2U) ||
+         (config->direction == SSI_STREAM_OUTPUT && config->frame_format == MICROWIRE) )
+    {
+        return SSI_STREAM_INVALID_CONFIG;
+    }
+
+    uint8_t timer_channel = timer_get_dma_channel( config->timer, &encoding );
+    if ( timer_channel == TIMER_NO_DMA_CHANNEL )
+    {
+        return SSI_STREAM_INVALID_CONFIG;
+    }
+
+    const struct ssi_config ssi_config =
+    {
+        .pins = config->pins,
+        .mode = SSI_MODE_MASTER,
+        .frame_format = config->frame_format,
+        .polarity = config->polarity,
+        .phase = config->phase,
+        .datasize = config->datasize,
+        .bitrate = config->bitrate,
+        .software_fss = 0
+    };
+
+    if ( ssi_init( ssi, &ssi_config ) != SSI_OK )
+    {
+        return SSI_STREAM_INVALID_CONFIG;
+    }
+
+    // Round the timer period to the nearest cycle
+    uint32_t period = stream_period( SystemCoreClock, config->sample_rate );
+    uint32_t sample_rate = SystemCoreClock / period;
+
+    // Each conversion must be off the wire before the next timeout
+    if ( (uint64_t)sample_rate * stream_frame_clocks( config->frame_format, config->datasize ) > ssi_get_bitrate( ssi ) ||
+         timer_init_periodic( config->timer, period ) != TIMER_OK )
+    {
+        return SSI_STREAM_INVALID_CONFIG;
+    }
+
+    stream->ssi = ssi;
+    stream->direction = config->direction;
+    stream->timer = config->timer;
+    stream->timer_channel = timer_channel;
+    stream->command = config->command;
+    stream->blocks[0] = config->blocks[0];
+    stream->blocks[1] = config->blocks[1];
+    stream->block_samples = config->block_samples;
+    stream->callback = config->callback;
+    stream->context = config->context;
+    stream->next = UDMA_PRIMARY;
+    stream->sample_rate = sample_rate;
+    stream->requested_rate = config->sample_rate;
+    stream->blocks_done = 0;
+    stream->overruns = 0;
+    stream->running = 0;
+
+    ssi_streams[config->instance] = stream;
+    timer_streams[config->timer] = stream;
+
+    clock_register_notifier( stream_clock_changed );
+
+    udma_init();
+    udma_assign_channel( timer_channel, encoding );
+    udma_set_burst_only( timer_channel );
+
+    return SSI_STREAM_OK;
+}
+
+void ssi_stream_start( struct ssi_stream * stream )
+{
+    struct ssi_regs * regs = stream->ssi->regs;
+
+    ssi_stream_stop( stream );
+
+    while ( regs->SR & SSI_SR_RNE )
+    {
+        (void)regs->DR;
+    }
+
+    stream->next = UDMA_PRIMARY;
+    stream_arm_timer( stream, UDMA_PRIMARY );
+    stream_arm_timer( stream, UDMA_ALTERNATE );
+
+    if ( stream->direction == SSI_STREAM_INPUT )
+    {
+        // Block completion is seen on the SSI RX channel
+        ssi_dma_enable( stream->ssi, stream_ssi_done, 1, 0 );
+        stream_arm_rx( stream, UDMA_PRIMARY );
+        stream_arm_rx( stream, UDMA_ALTERNATE );
+        udma_enable( stream->ssi->dma_rx_channel );
+    }
+    else
+    {
+        // Block completion is seen on the timer channel. Received frames are
+        // left to overrun the RX FIFO, which doesn't affect transmission
+        timer_set_callback( stream->timer, stream_timer_done );
+    }
+
+    // The pacing timer stops in deep sleep, output blocks as well as input
+    idle_block_deep_sleep();
+    stream->running = 1;
+    udma_enable( stream->timer_channel );
+    timer_start( stream->timer );
+}
+
+void ssi_stream_stop( struct ssi_stream * stream )
+{
+    timer_stop( stream->timer );
+    if ( stream->running )
+    {
+        idle_allow_deep_sleep();
+    }
+    stream->running = 0;
+
+    udma_disable( stream->timer_channel );
+    timer_set_callback( stream->timer, 0 );
+    ssi_dma_disable( stream->ssi );
+
+    // Let the last command's frame finish
+    ssi_wait_idle( stream->ssi );
+}
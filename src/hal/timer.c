@@ -0,0 +1,228 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock.h"
+#include "hal/clock_gate.h"
+#include "hal/timer.h"
+
+// Timer 0 base, timers are 4KB apart
+#define TIMER_BASE 0x40030000U
+#define TIMER_STRIDE 0x1000U
+
+struct timer_def
+{
+    // NVIC interrupt number of Timer A
+    uint8_t irq;
+    // uDMA channel of Timer A and its CHMAP encoding
+    uint8_t dma_channel;
+    uint8_t dma_encoding;
+};
+
+static const struct timer_def timer_defs[TIMER_INSTANCES] =
+{
+    {.irq = 19U, .dma_channel = 18U, .dma_encoding = 0U},
+    {.irq = 21U, .dma_channel = 20U, .dma_encoding = 0U},
+    {.irq = 23U, .dma_channel = TIMER_NO_DMA_CHANNEL, .dma_encoding = 0U},
+    {.irq = 35U, .dma_channel = TIMER_NO_DMA_CHANNEL, .dma_encoding = 0U},
+    {.irq = 70U, .dma_channel = TIMER_NO_DMA_CHANNEL, .dma_encoding = 0U},
+    {.irq = 92U, .dma_channel = TIMER_NO_DMA_CHANNEL, .dma_encoding = 0U}
+};
+
+static timer_callback timer_callbacks[TIMER_INSTANCES] = {0};
+// Timeout rates set by timer_set_rate, 0 for a fixed period
+static uint32_t timer_rates[TIMER_INSTANCES] = {0};
+// Timers holding a clock gate reference
+static uint8_t timer_enabled = 0;
+
+struct timer_regs * timer_get_regs( enum timer_instance instance )
+{
+    return (struct timer_regs *)(uintptr_t)(TIMER_BASE + ((uint32_t)instance * TIMER_STRIDE));
+}
+
+static enum timerret timer_init_mode( enum timer_instance instance, uint32_t period, uint32_t mode )
+{
+    if ( (unsigned)instance >= TIMER_INSTANCES || period < 2U )
+    {
+        return TIMER_INVALID_CONFIG;
+    }
+
+    struct timer_regs * timer = timer_get_regs( instance );
+    uint32_t module = 1U << instance;
+
+    // Enable Timer Module Clock, kept in sleep so it can wake the core, and
+    // wait until ready
+    if ( !(timer_enabled & module) )
+    {
+        clock_gate_enable( CLOCK_GATE_TIMER, module, CLOCK_GATE_SLEEP );
+        timer_enabled |= module;
+    }
+
+    // Disable while configuring
+    timer->CTL &= ~TIMER_CTL_TAEN;
+
+    timer->CFG = TIMER_CFG_32_BIT_TIMER;
+    timer->TAMR = mode;
+
+    // Counts period - 1 down to 0
+    timer->TAILR = period - 1U;
+    timer_rates[instance] = 0;
+    timer->ICR = TIMER_ICR_TATOCINT;
+
+    return TIMER_OK;
+}
+
+enum timerret timer_init_periodic( enum timer_instance instance, uint32_t period )
+{
+    return timer_init_mode( instance, period, TIMER_TAMR_TAMR_PERIOD );
+}
+
+enum timerret timer_init_oneshot( enum timer_instance instance, uint32_t period )
+{
+    return timer_init_mode( instance, period, TIMER_TAMR_TAMR_1_SHOT );
+}
+
+enum timerret timer_set_period( enum timer_instance instance, uint32_t period )
+{
+    if ( (unsigned)instance >= TIMER_INSTANCES || period < 2U )
+    {
+        return TIMER_INVALID_CONFIG;
+    }
+
+    timer_get_regs( instance )->TAILR = period - 1U;
+    timer_rates[instance] = 0;
+
+    return TIMER_OK;
+}
+
+static uint32_t timer_rate_period( uint32_t clock_hz, uint32_t hz )
+{
+    return (clock_hz + (hz / 2U)) / hz;
+}
+
+/**
+ * @brief   Keep rate based timers at their rate across clock changes
+ *
+ */
+static void timer_clock_changed( enum clock_event event, uint32_t hz )
+{
+    if ( event != CLOCK_POST_CHANGE )
+    {
+        return;
+    }
+
+    for ( uint8_t i = 0; i < TIMER_INSTANCES; i++ )
+    {
+        uint32_t period = timer_rates[i] ? timer_rate_period( hz, timer_rates[i] ) : 0;
+        if ( period >= 2U )
+        {
+            timer_get_regs( (enum timer_instance)i )->TAILR = period - 1U;
+        }
+    }
+}
+
+enum timerret timer_set_rate( enum timer_instance instance, uint32_t hz )
+{
+    if ( hz == 0 || timer_set_period( instance, timer_rate_period( SystemCoreClock, hz ) ) != TIMER_OK )
+    {
+        return TIMER_INVALID_CONFIG;
+    }
+
+    timer_rates[instance] = hz;
+    clock_register_notifier( timer_clock_changed );
+
+    return TIMER_OK;
+}
+
+void timer_start( enum timer_instance instance )
+{
+    timer_get_regs( instance )->CTL |= TIMER_CTL_TASTALL | TIMER_CTL_TAEN;
+}
+
+void timer_stop( enum timer_instance instance )
+{
+    timer_get_regs( instance )->CTL &= ~TIMER_CTL_TAEN;
+}
+
+void timer_set_alt_clock( enum timer_instance instance, uint8_t enable )
+{
+    timer_get_regs( instance )->CC = enable ? TIMER_CC_ALTCLK : 0;
+}
+
+void timer_deinit( enum timer_instance instance )
+{
+    if ( (unsigned)instance >= TIMER_INSTANCES || !(timer_enabled & (1U << instance)) )
+    {
+        return;
+    }
+
+    uint8_t module = 1U << instance;
+
+    timer_stop( instance );
+    timer_rates[instance] = 0;
+    timer_enabled &= ~module;
+    clock_gate_disable( CLOCK_GATE_TIMER, module, CLOCK_GATE_SLEEP );
+}
+
+void timer_set_callback( enum timer_instance instance, timer_callback callback )
+{
+    uint8_t irq = timer_defs[instance].irq;
+
+    timer_callbacks[instance] = callback;
+
+    if ( callback )
+    {
+        ((volatile uint32_t *)&NVIC_EN0_R)[irq / 32U] = 1UL << (irq % 32U);
+    }
+    else
+    {
+        ((volatile uint32_t *)&NVIC_DIS0_R)[irq / 32U] = 1UL << (irq % 32U);
+    }
+}
+
+uint8_t timer_get_dma_channel( enum timer_instance instance, uint8_t * encoding )
+{
+    *encoding = timer_defs[instance].dma_encoding;
+    return timer_defs[instance].dma_channel;
+}
+
+static void timer_isr( enum timer_instance instance )
+{
+    struct timer_regs * timer = timer_get_regs( instance );
+
+    timer->ICR = timer->MIS & TIMER_ICR_TATOCINT;
+
+    if ( timer_callbacks[instance] )
+    {
+        timer_callbacks[instance]( instance );
+    }
+}
+
+void Timer0AIntHandler( void )
+{
+    timer_isr( TIMER_INSTANCE_0 );
+}
+
+void Timer1AIntHandler( void )
+{
+    timer_isr( TIMER_INSTANCE_1 );
+}
+
+void Timer2AIntHandler( void )
+{
+    timer_isr( TIMER_INSTANCE_2 );
+}
+
+void Timer3AIntHandler( void )
+{
+    timer_isr( TIMER_INSTANCE_3 );
+}
+
+void Timer4AIntHandler( void )
+{
+    timer_isr( TIMER_INSTANCE_4 );
+}
+
+void Timer5AIntHandler( void )
+{
+    timer_isr( TIMER_INSTANCE_5 );
+}
@@ -0,0 +1,130 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/common.h"
+#include "hal/clock.h"
+#include "hal/clock_gate.h"
+#include "hal/gpio.h"
+#include "hal/uart.h"
+
+enum uart_pin
+{
+    // UART0 Port A
+    UART0_RX = PIN_0,
+    UART0_TX = PIN_1
+};
+
+// DR error flags: overrun, break, parity, framing
+#define UART_DR_ERROR_M 0x00000F00U
+
+static uint32_t uart0_baud = 0;
+
+static void uart0_set_divisor( uint32_t clock_hz )
+{
+    // Baud Rate Divisor = SysClk / (16 * baud), fraction in 1/64ths
+    // Computed as (SysClk * 4 / baud) so the bottom 6 bits are the fraction, rounded
+    uint32_t divisor = (uint32_t)((((uint64_t)clock_hz * 8U) / uart0_baud + 1U) / 2U);
+    UART0_IBRD_R = divisor >> 6U;
+    UART0_FBRD_R = divisor & 0x3FU;
+}
+
+/**
+ * @brief   Keep the baud rate across clock changes
+ *
+ */
+static void uart0_clock_changed( enum clock_event event, uint32_t hz )
+{
+    if ( event == CLOCK_PRE_CHANGE )
+    {
+        // Let queued bytes go out at the old rate
+        while ( UART0_FR_R & UART_FR_BUSY );
+        return;
+    }
+
+    UART0_CTL_R &= ~UART_CTL_UARTEN;
+    uart0_set_divisor( hz );
+    // Divisor changes take effect on the LCRH write
+    UART0_LCRH_R = UART0_LCRH_R;
+    UART0_CTL_R |= UART_CTL_UARTEN;
+}
+
+enum uartret uart0_init( uint32_t baud )
+{
+    // Enable UART0 and Port A clocks once, and wait until ready
+    if ( !uart0_baud )
+    {
+        clock_gate_enable( CLOCK_GATE_UART, SYSCTL_RCGCUART_R0, CLOCK_GATE_SLEEP );
+        gpio_enable_port( PORT_A );
+    }
+
+    // Enable Alternate function on PA0,1
+    GPIO_PORTA_AHB_AFSEL_R |= UART0_RX | UART0_TX;
+
+    // UART0 Mux, 0x01 for Pins 0, 1
+    GPIO_PORTA_AHB_PCTL_R = (GPIO_PORTA_AHB_PCTL_R & ~0x000000FFU) | (1U << 0U) | (1U << 4U);
+
+    // Disable Analog Mode
+    GPIO_PORTA_AHB_AMSEL_R &= ~(UART0_RX | UART0_TX);
+
+    // Digital Enable
+    GPIO_PORTA_AHB_DEN_R |= UART0_RX | UART0_TX;
+
+    // Disable UART while configuring
+    UART0_CTL_R &= ~UART_CTL_UARTEN;
+
+    uart0_baud = baud;
+    uart0_set_divisor( SystemCoreClock );
+
+    // 8 bit, no parity, one stop bit, FIFOs enabled
+    UART0_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+
+    // Select Clock Source, System Clock
+    UART0_CC_R = 0;
+
+    // Enable UART, TX and RX
+    UART0_CTL_R |= UART_CTL_RXE | UART_CTL_TXE | UART_CTL_UARTEN;
+
+    clock_register_notifier( uart0_clock_changed );
+
+    return UART_OK;
+}
+
+enum uartret uart0_write( uint8_t byte )
+{
+    // Wait for space in the TX FIFO
+    while ( UART0_FR_R & UART_FR_TXFF );
+    UART0_DR_R = byte;
+
+    return UART_OK;
+}
+
+enum uartret uart0_try_write( uint8_t byte )
+{
+    if ( UART0_FR_R & UART_FR_TXFF )
+    {
+        return UART_TX_FIFO_FULL;
+    }
+    UART0_DR_R = byte;
+
+    return UART_OK;
+}
+
+enum uartret uart0_read( uint8_t * byte )
+{
+    if ( UART0_FR_R & UART_FR_RXFE )
+    {
+        return UART_RX_FIFO_EMPTY;
+    }
+
+    uint32_t data = UART0_DR_R;
+    *byte = (uint8_t)data;
+
+    if ( data & UART_DR_ERROR_M )
+    {
+        // Clear the error flags
+        UART0_ECR_R = 0;
+        return UART_RX_ERROR;
+    }
+
+    return UART_OK;
+}
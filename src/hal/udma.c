@@ -0,0 +1,317 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/clock_gate.h"
+#include "hal/udma.h"
+
+// CHMAP holds 4 bits per channel, 8 channels per register
+#define UDMA_CHMAP_BITS 4U
+#define UDMA_CHMAP_CHANNELS 8U
+
+// NVIC interrupt numbers
+#define UDMA_IRQ 46U
+#define UDMA_ERROR_IRQ 47U
+
+// Words the controller copies per scatter-gather task
+#define UDMA_TASK_WORDS (sizeof( struct udma_descriptor ) / sizeof( uint32_t ))
+
+// Primary descriptors, followed by the alternate descriptors. The controller
+// requires the table to be 1024 byte aligned; the linker script places the
+// section first in SRAM so the alignment costs no padding. Not zeroed at
+// reset, udma_init clears it
+static struct udma_descriptor udma_control_table[UDMA_CHANNELS * 2U]
+    __attribute__((section(".udma_table"), aligned(1024)));
+
+static udma_callback udma_callbacks[UDMA_CHANNELS] = {0};
+// Channels with a callback, the ones the software interrupt completes
+static uint32_t udma_callback_mask = 0;
+
+static udma_error_callback udma_on_error = 0;
+static volatile uint32_t udma_errors = 0;
+
+static uint8_t udma_initialised = 0;
+
+static struct udma_descriptor * udma_descriptor( uint8_t channel, enum udma_select select )
+{
+    return &udma_control_table[channel + ((select == UDMA_ALTERNATE) ? UDMA_CHANNELS : 0U)];
+}
+
+void udma_init( void )
+{
+    // Drivers each call this, only the first may clear the table
+    if ( udma_initialised )
+    {
+        return;
+    }
+    udma_initialised = 1;
+
+    // Enable uDMA Module Clock, kept in sleep so transfers carry on, and wait
+    // until ready
+    clock_gate_enable( CLOCK_GATE_DMA, SYSCTL_RCGCDMA_R0, CLOCK_GATE_SLEEP );
+
+    for ( uint8_t i = 0; i < UDMA_CHANNELS * 2U; i++ )
+    {
+        udma_control_table[i].control = UDMA_CHCTL_XFERMODE_STOP;
+    }
+
+    UDMA_CFG_R = UDMA_CFG_MASTEN;
+    UDMA_CTLBASE_R = (uint32_t)(uintptr_t)udma_control_table;
+
+    udma_errors = 0;
+    UDMA_ERRCLR_R = UDMA_ERRCLR_ERRCLR;
+    ((volatile uint32_t *)&NVIC_EN0_R)[UDMA_ERROR_IRQ / 32U] = 1UL << (UDMA_ERROR_IRQ % 32U);
+}
+
+enum udmaret udma_assign_channel( uint8_t channel, uint8_t encoding )
+{
+    if ( channel >= UDMA_CHANNELS )
+    {
+        return UDMA_INVALID_CHANNEL;
+    }
+
+    volatile uint32_t * chmap = (volatile uint32_t *)&UDMA_CHMAP0_R + (channel / UDMA_CHMAP_CHANNELS);
+    uint32_t shift = (channel % UDMA_CHMAP_CHANNELS) * UDMA_CHMAP_BITS;
+    uint32_t mask = 1UL << channel;
+
+    UDMA_ENACLR_R = mask;
+    *chmap = (*chmap & ~(0xFUL << shift)) | ((uint32_t)(encoding & 0xFU) << shift);
+
+    UDMA_USEBURSTCLR_R = mask;
+    UDMA_ALTCLR_R = mask;
+    UDMA_PRIOCLR_R = mask;
+    UDMA_REQMASKCLR_R = mask;
+
+    return UDMA_OK;
+}
+
+void udma_set_burst_only( uint8_t channel )
+{
+    UDMA_USEBURSTSET_R = 1UL << channel;
+}
+
+void udma_set_high_priority( uint8_t channel )
+{
+    UDMA_PRIOSET_R = 1UL << channel;
+}
+
+/**
+ * @brief   Bytes the address moves per item for an increment field
+ *
+ */
+static uint32_t udma_increment( uint32_t increment, uint32_t none, uint32_t half, uint32_t word )
+{
+    if ( increment == none )
+    {
+        return 0;
+    }
+    if ( increment == half )
+    {
+        return 2U;
+    }
+    if ( increment == word )
+    {
+        return 4U;
+    }
+    return 1U;
+}
+
+/**
+ * @brief   Fill in a descriptor, count already checked
+ *
+ */
+static void udma_fill( struct udma_descriptor * descriptor, uint32_t control,
+                       volatile void * src, volatile void * dst, uint16_t count )
+{
+    uint32_t src_step = udma_increment( control & UDMA_CHCTL_SRCINC_M, UDMA_CHCTL_SRCINC_NONE,
+                                        UDMA_CHCTL_SRCINC_16, UDMA_CHCTL_SRCINC_32 );
+    uint32_t dst_step = udma_increment( control & UDMA_CHCTL_DSTINC_M, UDMA_CHCTL_DSTINC_NONE,
+                                        UDMA_CHCTL_DSTINC_16, UDMA_CHCTL_DSTINC_32 );
+
+    // End pointers address the last item
+    descriptor->src_end = (volatile uint8_t *)src + ((count - 1U) * src_step);
+    descriptor->dst_end = (volatile uint8_t *)dst + ((count - 1U) * dst_step);
+    descriptor->control = (control & ~UDMA_CHCTL_XFERSIZE_M) |
+                          ((uint32_t)(count - 1U) << UDMA_CHCTL_XFERSIZE_S);
+}
+
+enum udmaret udma_set_transfer( uint8_t channel, enum udma_select select, uint32_t control,
+                                volatile void * src, volatile void * dst, uint16_t count )
+{
+    if ( channel >= UDMA_CHANNELS )
+    {
+        return UDMA_INVALID_CHANNEL;
+    }
+    if ( count == 0 || count > UDMA_MAX_TRANSFER )
+    {
+        return UDMA_INVALID_SIZE;
+    }
+
+    udma_fill( udma_descriptor( channel, select ), control, src, dst, count );
+
+    return UDMA_OK;
+}
+
+enum udmaret udma_set_task( struct udma_descriptor * task, uint32_t control,
+                            volatile void * src, volatile void * dst, uint16_t count )
+{
+    if ( count == 0 || count > UDMA_MAX_TRANSFER )
+    {
+        return UDMA_INVALID_SIZE;
+    }
+
+    udma_fill( task, control & ~UDMA_CHCTL_XFERMODE_M, src, dst, count );
+
+    return UDMA_OK;
+}
+
+enum udmaret udma_set_scatter_gather( uint8_t channel, struct udma_descriptor * tasks, uint16_t count,
+                                      uint8_t peripheral )
+{
+    if ( channel >= UDMA_CHANNELS )
+    {
+        return UDMA_INVALID_CHANNEL;
+    }
+    if ( count == 0 || count > UDMA_MAX_TASKS )
+    {
+        return UDMA_INVALID_SIZE;
+    }
+    if ( udma_is_enabled( channel ) )
+    {
+        return UDMA_BUSY;
+    }
+
+    // Every task but the last hands back to the primary descriptor for the
+    // next copy. The last runs as a plain transfer and completes the channel
+    for ( uint16_t i = 0; i < count; i++ )
+    {
+        uint32_t mode;
+
+        if ( i + 1U < count )
+        {
+            mode = peripheral ? UDMA_CHCTL_XFERMODE_PER_SGA : UDMA_CHCTL_XFERMODE_MEM_SGA;
+        }
+        else
+        {
+            mode = peripheral ? UDMA_CHCTL_XFERMODE_BASIC : UDMA_CHCTL_XFERMODE_AUTO;
+        }
+        tasks[i].control = (tasks[i].control & ~UDMA_CHCTL_XFERMODE_M) | mode;
+    }
+
+    // The primary descriptor copies one task at a time into the alternate
+    struct udma_descriptor * primary = udma_descriptor( channel, UDMA_PRIMARY );
+    struct udma_descriptor * alternate = udma_descriptor( channel, UDMA_ALTERNATE );
+
+    primary->src_end = &tasks[count - 1U].reserved;
+    primary->dst_end = &alternate->reserved;
+    primary->control = UDMA_MEMORY_TO_MEMORY_32 | UDMA_CHCTL_ARBSIZE_4 |
+                       ((uint32_t)((count * UDMA_TASK_WORDS) - 1U) << UDMA_CHCTL_XFERSIZE_S) |
+                       (peripheral ? UDMA_CHCTL_XFERMODE_PER_SG : UDMA_CHCTL_XFERMODE_MEM_SG);
+
+    UDMA_ALTCLR_R = 1UL << channel;
+
+    return UDMA_OK;
+}
+
+void udma_enable( uint8_t channel )
+{
+    UDMA_ENASET_R = 1UL << channel;
+}
+
+void udma_disable( uint8_t channel )
+{
+    UDMA_ENACLR_R = 1UL << channel;
+}
+
+uint8_t udma_is_enabled( uint8_t channel )
+{
+    return (UDMA_ENASET_R & (1UL << channel)) ? 1U : 0U;
+}
+
+uint32_t udma_get_mode( uint8_t channel, enum udma_select select )
+{
+    return udma_descriptor( channel, select )->control & UDMA_CHCTL_XFERMODE_M;
+}
+
+uint16_t udma_get_remaining( uint8_t channel, enum udma_select select )
+{
+    uint32_t control = udma_descriptor( channel, select )->control;
+
+    if ( (control & UDMA_CHCTL_XFERMODE_M) == UDMA_CHCTL_XFERMODE_STOP )
+    {
+        return 0;
+    }
+    return (uint16_t)(((control & UDMA_CHCTL_XFERSIZE_M) >> UDMA_CHCTL_XFERSIZE_S) + 1U);
+}
+
+void udma_request( uint8_t channel )
+{
+    UDMA_SWREQ_R = 1UL << channel;
+}
+
+uint8_t udma_take_interrupt( uint8_t channel )
+{
+    uint32_t mask = 1UL << channel;
+
+    if ( UDMA_CHIS_R & mask )
+    {
+        UDMA_CHIS_R = mask;
+        return 1;
+    }
+    return 0;
+}
+
+void udma_set_callback( uint8_t channel, udma_callback callback )
+{
+    uint32_t mask = 1UL << channel;
+
+    udma_callbacks[channel] = callback;
+
+    if ( callback )
+    {
+        udma_callback_mask |= mask;
+        ((volatile uint32_t *)&NVIC_EN0_R)[UDMA_IRQ / 32U] = 1UL << (UDMA_IRQ % 32U);
+    }
+    else
+    {
+        udma_callback_mask &= ~mask;
+    }
+}
+
+void udma_set_error_callback( udma_error_callback callback )
+{
+    udma_on_error = callback;
+}
+
+uint32_t udma_get_error_count( void )
+{
+    return udma_errors;
+}
+
+void UDMAIntHandler( void )
+{
+    uint32_t done = UDMA_CHIS_R & udma_callback_mask;
+
+    UDMA_CHIS_R = done;
+
+    for ( uint8_t channel = 0; done; channel++, done >>= 1U )
+    {
+        if ( done & 1U )
+        {
+            udma_callbacks[channel]( channel );
+        }
+    }
+}
+
+void UDMAErrorIntHandler( void )
+{
+    if ( UDMA_ERRCLR_R & UDMA_ERRCLR_ERRCLR )
+    {
+        UDMA_ERRCLR_R = UDMA_ERRCLR_ERRCLR;
+        udma_errors++;
+
+        if ( udma_on_error )
+        {
+            udma_on_error();
+        }
+    }
+}
@@ -3,9 +3,11 @@
 #include "lcd_5110/lcd.h"
 #include "hal/tm4c123gh6pm.h"
 #include "hal/common.h"
+#include "hal/delay.h"
 #include "hal/gpio.h"
 #include "hal/ssi.h"
 #include "util/common.h"
+#include "util/timebase.h"
 
 #include "tiva/led.h"
 
@@ -23,9 +25,28 @@
 #define FONT_ROWS 5U
 #define FONT_COLUMNS 11U
 #define FONT_WIDTH 5U
+// Characters in ASCII, starting from 0x20
+#define FONT_CHARACTERS 97U
 
 #define START_DRAWING_BIT 7U
 
+// Buffer loops, run from SRAM when built with LCD_5110_RAMFUNC. lcd_bench
+// measures whether that pays, on copies built from the same bodies
+#ifdef LCD_5110_RAMFUNC
+#define LCD_HOT RAMFUNC
+#else
+#define LCD_HOT
+#endif
+#define LCD_HOT_BODY static inline __attribute__((always_inline))
+
+#define WARM_SIGNATURE 0x4C434435UL
+// RESET' pulse when restoring after a warm reset, the datasheet minimum
+#define WARM_RESET_PULSE_NS 100U
+// Cold reset pulse, and settling times after clearing and flipping
+#define RESET_PULSE_MS 125U
+#define CLEAR_SETTLE_MS 625U
+#define FLIP_SETTLE_MS 125U
+
 #define DATA_COMMAND_PIN (*(GPIO_PORTA_AHB_DATA_BITS_R + PIN_6))
 #define RESET_PIN__N (*(GPIO_PORTA_AHB_DATA_BITS_R + PIN_7))
 
@@ -65,7 +86,10 @@ enum lcd_5110_status
 
 static const char ASCII[][5];
 
-// static enum lcd_5110_font font = LCD_5110_FONT_COURSE;
+static enum lcd_5110_font lcd_font = LCD_5110_FONT_COURSE;
+
+// Fonts supplied from outside, e.g. external flash
+static lcd_glyph_source lcd_glyph_sources[LCD_5110_FONT_MINE + 1] = {0};
 
 static uint16_t lcd_cursor_byte = 0;
 static uint8_t lcd_cursor_bit = 0;
@@ -73,20 +97,51 @@ static uint8_t lcd_cursor_bit = 0;
 static uint8_t lcd_cursor_x = 0;
 static uint8_t lcd_cursor_y = 0;
 
-static uint8_t lcd_screen_buffer[ROWS * COLUMNS / PIXELS_BYTE] = {0};
+static uint8_t lcd_screen_buffer[ROWS * COLUMNS / PIXELS_BYTE];
+
+// What the panel shows, updated as lcd_display and lcd_display_dirty send it.
+// Kept in .noinit so it survives a warm reset, which may land while the
+// screen buffer is half drawn
+static uint8_t lcd_shown_buffer[ROWS * COLUMNS / PIXELS_BYTE] NOINIT;
+
+// Validates lcd_shown_buffer and the state saved with it after a reset
+struct lcd_warm_state
+{
+    uint32_t signature;
+    uint32_t checksum;
+    uint8_t cursor_x;
+    uint8_t cursor_y;
+    uint8_t ui_size;
+    uint8_t ui_state[LCD_5110_UI_STATE_SIZE];
+};
+
+static struct lcd_warm_state lcd_warm_state NOINIT;
+
+// Application state copied into lcd_warm_state at each display
+static const uint8_t *lcd_ui_state = 0;
+static uint8_t lcd_ui_size = 0;
+static uint8_t lcd_warm_boot = 0;
+
+// Changed column span per bank. start > end means the bank is clean
+static uint8_t lcd_dirty_start[ROW_BANKS] = {0};
+static uint8_t lcd_dirty_end[ROW_BANKS] = {0};
 
 static void lcd_send(enum lcd_5110_datatype data_type, uint8_t data);
+static void lcd_send_data(const uint8_t *data, uint16_t length);
+static void lcd_clear_dirty(void);
+static void lcd_send_span(uint8_t bank, uint8_t start_x, uint8_t end_x);
+static LCD_HOT uint32_t lcd_buffer_checksum(void);
+static void lcd_save_warm_state(void);
+static uint32_t lcd_warm_checksum(void);
 
 void lcd_init(void)
 {
-    // Start SPI Interface
+    // Start SPI Interface, as fast as the controller allows
     ssi0_init();
+    ssi_set_bitrate(ssi_get_handle(SSI_INSTANCE_0), LCD_5110_MAX_BITRATE, 0);
 
-    // Enable Clock for Port A
-    SYSCTL_RCGCGPIO_R |= PORT_A;
-
-    // Enable High Performance Bus
-    SYSCTL_GPIOHBCTL_R |= PORT_A;
+    // Enable Clock and High Performance Bus for Port A
+    gpio_enable_port(PORT_A);
 
     // Unlock all CR
     GPIO_PORTA_AHB_LOCK_R = GPIO_LOCK_KEY;
@@ -110,9 +165,16 @@ void lcd_init(void)
 
     __asm("NOP\n");
 
+    // A valid frame in .noinit means this is a warm reset and the frame can be
+    // shown again straight away instead of blanking the panel
+    uint8_t warm = (lcd_warm_state.signature == WARM_SIGNATURE) &&
+                   (lcd_warm_state.ui_size <= LCD_5110_UI_STATE_SIZE) &&
+                   (lcd_warm_state.checksum == lcd_warm_checksum());
+    lcd_warm_boot = warm;
+
     // Apply RESET' pulse (Resets all registers)
     RESET_PIN__N = LCD5110_RESET_LOW;
-    delay(1);
+    delay_sleep_ns(warm ? WARM_RESET_PULSE_NS : (RESET_PULSE_MS * 1000000ULL));
     RESET_PIN__N = LCD5110_RESET_HIGH;
 
     // Set LCD Functions. Chip Active. Horizontal Addressing. Use Extended Instruction Set
@@ -133,6 +195,29 @@ void lcd_init(void)
     // Must send before modifying display control mode
     lcd_send(LCD5110_COMMAND, 0x20);
 
+    if (warm)
+    {
+        // Carry on drawing from the frame on the panel
+        for (uint16_t i = 0; i < sizeof(lcd_screen_buffer); i++)
+        {
+            lcd_screen_buffer[i] = lcd_shown_buffer[i];
+        }
+        lcd_set_buffer_pixel_cursor(lcd_warm_state.cursor_x, lcd_warm_state.cursor_y);
+        lcd_display();
+
+        // Set display to Normal Mode
+        lcd_send(LCD5110_COMMAND, 0x0C);
+        return;
+    }
+
+    // Cold start, nothing valid to restore until the next lcd_display. The
+    // panel is cleared below
+    lcd_warm_state.signature = 0;
+    for (uint16_t i = 0; i < sizeof(lcd_shown_buffer); i++)
+    {
+        lcd_shown_buffer[i] = 0x00;
+    }
+
     lcd_page_flip();
 
     // Set display to Normal Mode
@@ -151,9 +236,191 @@ void lcd_display(void)
     // Set display cursor position to Bank(Y) = 0, X = 0
     lcd_send(LCD5110_COMMAND, 0x80 | (0 & 0x7F));
     lcd_send(LCD5110_COMMAND, 0x40 | ((0 % ROW_BANKS) & 0x07));
-    for (uint16_t i = 0; i < (COLUMNS * ROWS / PIXELS_BYTE); i++)
+    lcd_send_data(lcd_screen_buffer, BYTES);
+    for (uint16_t i = 0; i < BYTES; i++)
     {
-        lcd_send(LCD5110_DATA, lcd_screen_buffer[i]);
+        lcd_shown_buffer[i] = lcd_screen_buffer[i];
+    }
+
+    lcd_clear_dirty();
+    lcd_save_warm_state();
+
+#ifdef LCD_5110_TRACE
+    lcd_trace_frame();
+#endif
+}
+
+void lcd_display_dirty(void)
+{
+    for (uint8_t bank = 0; bank < ROW_BANKS; bank++)
+    {
+        if (lcd_dirty_start[bank] > lcd_dirty_end[bank])
+        {
+            continue;
+        }
+
+        lcd_send_span(bank, lcd_dirty_start[bank], lcd_dirty_end[bank]);
+    }
+
+    lcd_clear_dirty();
+    lcd_save_warm_state();
+
+#ifdef LCD_5110_TRACE
+    lcd_trace_frame();
+#endif
+}
+
+void lcd_display_span(uint8_t bank, uint8_t start_x, uint8_t end_x)
+{
+    if (bank >= ROW_BANKS || start_x > end_x || start_x > MAX_X)
+    {
+        return;
+    }
+    if (end_x > MAX_X)
+    {
+        end_x = MAX_X;
+    }
+
+    lcd_send_span(bank, start_x, end_x);
+
+    // Nothing left for lcd_display_dirty if the span covered all changes
+    if (lcd_dirty_start[bank] >= start_x && lcd_dirty_end[bank] <= end_x)
+    {
+        lcd_dirty_start[bank] = COLUMNS;
+        lcd_dirty_end[bank] = 0;
+    }
+
+    lcd_save_warm_state();
+}
+
+/**
+ * @brief   Send a span of one bank of the screen buffer and record it as shown
+ * 
+ */
+static void lcd_send_span(uint8_t bank, uint8_t start_x, uint8_t end_x)
+{
+    // Horizontal addressing so the span is sent as one run after setting the address
+    lcd_nb_set_cursor(start_x, bank);
+    uint16_t offset = (bank * COLUMNS) + start_x;
+    uint16_t length = end_x - start_x + 1U;
+    lcd_send_data(&lcd_screen_buffer[offset], length);
+    for (uint16_t i = offset; i < offset + length; i++)
+    {
+        lcd_shown_buffer[i] = lcd_screen_buffer[i];
+    }
+}
+
+void lcd_mark_dirty(uint8_t bank, uint8_t start_x, uint8_t end_x)
+{
+    if (bank >= ROW_BANKS)
+    {
+        return;
+    }
+    if (end_x > MAX_X)
+    {
+        end_x = MAX_X;
+    }
+
+    if (lcd_dirty_start[bank] > lcd_dirty_end[bank])
+    {
+        lcd_dirty_start[bank] = start_x;
+        lcd_dirty_end[bank] = end_x;
+        return;
+    }
+    if (start_x < lcd_dirty_start[bank])
+    {
+        lcd_dirty_start[bank] = start_x;
+    }
+    if (end_x > lcd_dirty_end[bank])
+    {
+        lcd_dirty_end[bank] = end_x;
+    }
+}
+
+uint8_t *lcd_get_screen_buffer(void)
+{
+    return lcd_screen_buffer;
+}
+
+LCD_HOT_BODY uint32_t lcd_buffer_checksum_body(void)
+{
+    uint32_t checksum = 0;
+    for (uint16_t i = 0; i < sizeof(lcd_shown_buffer); i++)
+    {
+        // Rotate so that swapped bytes change the result
+        checksum = ((checksum << 5U) | (checksum >> 27U)) ^ lcd_shown_buffer[i];
+    }
+    return checksum;
+}
+
+static LCD_HOT uint32_t lcd_buffer_checksum(void)
+{
+    return lcd_buffer_checksum_body();
+}
+
+/**
+ * @brief   Record the frame that is now on the panel as valid for a warm restart
+ * 
+ */
+static void lcd_save_warm_state(void)
+{
+    lcd_warm_state.cursor_x = lcd_cursor_x;
+    lcd_warm_state.cursor_y = lcd_cursor_y;
+    lcd_warm_state.ui_size = lcd_ui_size;
+    for (uint8_t i = 0; i < lcd_ui_size; i++)
+    {
+        lcd_warm_state.ui_state[i] = lcd_ui_state[i];
+    }
+    lcd_warm_state.checksum = lcd_warm_checksum();
+    lcd_warm_state.signature = WARM_SIGNATURE;
+}
+
+/**
+ * @brief   Checksum of the shown frame and the state saved with it
+ * 
+ */
+static uint32_t lcd_warm_checksum(void)
+{
+    uint32_t checksum = lcd_buffer_checksum() ^ ((uint32_t)lcd_warm_state.cursor_x << 16U) ^
+                        ((uint32_t)lcd_warm_state.cursor_y << 8U) ^ lcd_warm_state.ui_size;
+
+    for (uint8_t i = 0; i < lcd_warm_state.ui_size; i++)
+    {
+        checksum = ((checksum << 5U) | (checksum >> 27U)) ^ lcd_warm_state.ui_state[i];
+    }
+    return checksum;
+}
+
+void lcd_set_ui_state(const void *state, uint8_t size)
+{
+    if (!state || size > LCD_5110_UI_STATE_SIZE)
+    {
+        size = 0;
+    }
+    lcd_ui_state = state;
+    lcd_ui_size = size;
+}
+
+uint8_t lcd_get_ui_state(void *state, uint8_t size)
+{
+    if (!lcd_warm_boot || size != lcd_warm_state.ui_size)
+    {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < size; i++)
+    {
+        ((uint8_t *)state)[i] = lcd_warm_state.ui_state[i];
+    }
+    return 1;
+}
+
+static void lcd_clear_dirty(void)
+{
+    for (uint8_t bank = 0; bank < ROW_BANKS; bank++)
+    {
+        lcd_dirty_start[bank] = COLUMNS;
+        lcd_dirty_end[bank] = 0;
     }
 }
 
@@ -166,20 +433,49 @@ void lcd_send(enum lcd_5110_datatype data_type, uint8_t data)
             ;
     }
     ssi0_write(data);
+
+#ifdef LCD_5110_TRACE
+    lcd_trace_byte(data_type == LCD5110_DATA, data);
+#endif
+}
+
+/**
+ * @brief   Stream display data, keeping the SSI FIFO full
+ *
+ */
+static void lcd_send_data(const uint8_t *data, uint16_t length)
+{
+    DATA_COMMAND_PIN = LCD5110_DATA;
+    ssi_write_buf(ssi_get_handle(SSI_INSTANCE_0), data, length);
+
+#ifdef LCD_5110_TRACE
+    for (uint16_t i = 0; i < length; i++)
+    {
+        lcd_trace_byte(1, data[i]);
+    }
+#endif
+}
+
+void lcd_write_data(const uint8_t *data, uint16_t length)
+{
+    lcd_send_data(data, length);
 }
 
 void lcd_write_pixel(void)
 {
     SET_BIT_VALUE(lcd_screen_buffer[lcd_cursor_byte], 1, lcd_cursor_bit);
+    lcd_mark_dirty(lcd_cursor_y / PIXELS_BYTE, lcd_cursor_x, lcd_cursor_x);
 }
 
 void lcd_nb_write_char(char character)
 {
+    const char *glyph = lcd_get_glyph(lcd_font, character);
+
     // Padding on the left
     lcd_send(LCD5110_DATA, 0x00);
     for (uint8_t i = 0; i < FONT_WIDTH; i++)
     {
-        lcd_send(LCD5110_DATA, ASCII[character - 0x20][i]);
+        lcd_send(LCD5110_DATA, glyph[i]);
     }
     // Padding on the right
     lcd_send(LCD5110_DATA, 0x00);
@@ -211,16 +507,28 @@ void lcd_nb_set_cursor(uint8_t x, uint8_t y)
     lcd_send(LCD5110_COMMAND, 0x40 | ((y % ROW_BANKS) & 0x07));
 }
 
-void lcd_write_byte(uint8_t byte)
+LCD_HOT_BODY void lcd_write_byte_body(uint8_t byte)
 {
     uint8_t cache_cursor_bit = lcd_cursor_bit;
+    uint8_t bank = lcd_cursor_y / PIXELS_BYTE;
+
+    lcd_mark_dirty(bank, lcd_cursor_x, lcd_cursor_x);
+    if (lcd_cursor_bit != 0)
+    {
+        // Unaligned writes spill into the bank below
+        lcd_mark_dirty(bank + 1, lcd_cursor_x, lcd_cursor_x);
+    }
 
-    // if ( lcd_cursor_bit == START_DRAWING_BIT )
-    // {
-    //     lcd_screen_buffer[lcd_cursor_byte] = byte;
-    //     lcd_cursor_byte++;
-    // }
-    // else
+    if (lcd_cursor_bit == 0)
+    {
+        // Cursor is on a bank boundary so the whole column byte can be stored at once
+        lcd_screen_buffer[lcd_cursor_byte] = byte;
+
+        // Advance to next column - wraps around to 0 from MAX_X
+        lcd_cursor_x = (lcd_cursor_x + 1) % COLUMNS;
+        lcd_cursor_byte = GET_CURSOR_BYTE();
+    }
+    else
     {
         // Partial byte writes
         for (uint8_t i = 0; i < PIXELS_BYTE; i++)
@@ -248,14 +556,49 @@ void lcd_write_byte(uint8_t byte)
     }
 }
 
+LCD_HOT void lcd_write_byte(uint8_t byte)
+{
+    lcd_write_byte_body(byte);
+}
+
+const char *lcd_get_glyph(enum lcd_5110_font font, char character)
+{
+    if ((unsigned)font < sizeof(lcd_glyph_sources) / sizeof(lcd_glyph_sources[0]) && lcd_glyph_sources[font])
+    {
+        return lcd_glyph_sources[font](font, character);
+    }
+
+    // Only the one font is built in so far
+    if (character < 0x20 || (uint8_t)(character - 0x20) >= FONT_CHARACTERS)
+    {
+        character = ' ';
+    }
+    return ASCII[character - 0x20];
+}
+
+void lcd_set_glyph_source(enum lcd_5110_font font, lcd_glyph_source source)
+{
+    if ((unsigned)font < sizeof(lcd_glyph_sources) / sizeof(lcd_glyph_sources[0]))
+    {
+        lcd_glyph_sources[font] = source;
+    }
+}
+
+void lcd_set_font(enum lcd_5110_font font)
+{
+    lcd_font = font;
+}
+
 void lcd_write_char(char character)
 {
+    const char *glyph = lcd_get_glyph(lcd_font, character);
+
     // Padding on the left
     lcd_write_byte(0x00);
 
     for (uint8_t i = 0; i < FONT_WIDTH; i++)
     {
-        lcd_write_byte(ASCII[character - 0x20][i]);
+        lcd_write_byte(glyph[i]);
     }
 
     // Padding on the right
@@ -297,11 +640,13 @@ void lcd_write_row(uint8_t start_x, uint8_t start_y, uint8_t fill, char *string)
     lcd_set_buffer_pixel_cursor((start_x + 0), start_y);
     while (*string)
     {
+        const char *glyph = lcd_get_glyph(lcd_font, *string);
+
         lcd_write_byte(fill_mask ^ 0x00U);
 
         for (int8_t i = 0; i < FONT_WIDTH; i++)
         {
-            lcd_write_byte(fill_mask ^ (ASCII[*string - 0x20][i]));
+            lcd_write_byte(fill_mask ^ glyph[i]);
         }
         string++;
 
@@ -358,18 +703,63 @@ void lcd_clear_screen(void)
         lcd_send(LCD5110_DATA, 0x00);
     }
 
-    delay(5);
+    timebase_delay_ms(CLEAR_SETTLE_MS);
 
     lcd_nb_set_cursor(0, 0);
 }
 
-void lcd_clear_screen_buffer(void)
+LCD_HOT_BODY void lcd_clear_screen_buffer_body(void)
 {
     for (uint16_t i = 0; i < sizeof(lcd_screen_buffer); i++)
     {
         lcd_screen_buffer[i] = 0x00;
     }
+
+    for (uint8_t bank = 0; bank < ROW_BANKS; bank++)
+    {
+        lcd_mark_dirty(bank, 0, MAX_X);
+    }
+}
+
+LCD_HOT void lcd_clear_screen_buffer(void)
+{
+    lcd_clear_screen_buffer_body();
+}
+
+#ifdef LCD_BENCH
+// Flash and SRAM copies of the LCD_HOT functions for lcd_bench, whichever
+// placement the build picked for the real ones
+
+__attribute__((noinline)) uint32_t lcd_bench_checksum_flash(void)
+{
+    return lcd_buffer_checksum_body();
+}
+
+RAMFUNC uint32_t lcd_bench_checksum_sram(void)
+{
+    return lcd_buffer_checksum_body();
+}
+
+__attribute__((noinline)) void lcd_bench_write_byte_flash(uint8_t byte)
+{
+    lcd_write_byte_body(byte);
+}
+
+RAMFUNC void lcd_bench_write_byte_sram(uint8_t byte)
+{
+    lcd_write_byte_body(byte);
+}
+
+__attribute__((noinline)) void lcd_bench_clear_flash(void)
+{
+    lcd_clear_screen_buffer_body();
+}
+
+RAMFUNC void lcd_bench_clear_sram(void)
+{
+    lcd_clear_screen_buffer_body();
 }
+#endif
 
 void lcd_page_flip(void)
 {
@@ -379,7 +769,7 @@ void lcd_page_flip(void)
     lcd_nb_set_cursor(0, 0);
     lcd_clear_screen_buffer();
     lcd_clear_screen();
-    delay(1);
+    timebase_delay_ms(FLIP_SETTLE_MS);
     // Normal Mode
     lcd_send(LCD5110_COMMAND, 0x0C);
 }
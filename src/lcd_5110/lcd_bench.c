@@ -0,0 +1,189 @@
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+#include "lcd_5110/lcd_bench.h"
+#include "lcd_5110/lcd_print.h"
+#include "util/cycles.h"
+#include "util/report.h"
+
+// Needs the copies lcd.c builds with LCD_BENCH
+#ifdef LCD_BENCH
+
+// Rows of the lcd_write_byte runs, a bank boundary and 3 bits below one
+#define BENCH_ALIGNED_ROW 8U
+#define BENCH_UNALIGNED_ROW 11U
+
+static const char *const bench_loop_names[LCD_BENCH_LOOPS] = {"checksum", "clear", "write", "write+3"};
+
+// lcd_bench_print_run fields, two columns of 7 characters
+#define BENCH_PRINT_COLUMN_X 42U
+#define BENCH_PRINT_ROW_Y 9U
+
+static const char *const bench_print_formats[LCD_BENCH_PRINT_FIELDS] =
+{
+    "%5d", "%6.1q", "%04X", "%5u", "%3d%%",
+    "%6.2q", "%c%5d", "%7s", "%05u", "%x"
+};
+
+// Keeps the checksum from being optimised away
+static volatile uint32_t bench_sink;
+
+typedef void (*bench_write)(uint8_t byte);
+
+static void bench_checksum_flash(void)
+{
+    bench_sink = lcd_bench_checksum_flash();
+}
+
+static void bench_checksum_sram(void)
+{
+    bench_sink = lcd_bench_checksum_sram();
+}
+
+static void bench_write_row(bench_write write, uint8_t row)
+{
+    lcd_set_buffer_pixel_cursor(0, row);
+    for (uint8_t x = 0; x < LCD_5110_COLUMNS; x++)
+    {
+        write((uint8_t)(x * 37U));
+    }
+}
+
+static void bench_write_aligned_flash(void)
+{
+    bench_write_row(lcd_bench_write_byte_flash, BENCH_ALIGNED_ROW);
+}
+
+static void bench_write_aligned_sram(void)
+{
+    bench_write_row(lcd_bench_write_byte_sram, BENCH_ALIGNED_ROW);
+}
+
+static void bench_write_unaligned_flash(void)
+{
+    bench_write_row(lcd_bench_write_byte_flash, BENCH_UNALIGNED_ROW);
+}
+
+static void bench_write_unaligned_sram(void)
+{
+    bench_write_row(lcd_bench_write_byte_sram, BENCH_UNALIGNED_ROW);
+}
+
+typedef void (*bench_loop)(void);
+
+static const bench_loop bench_flash_loops[LCD_BENCH_LOOPS] =
+{
+    bench_checksum_flash, lcd_bench_clear_flash, bench_write_aligned_flash, bench_write_unaligned_flash
+};
+
+static const bench_loop bench_sram_loops[LCD_BENCH_LOOPS] =
+{
+    bench_checksum_sram, lcd_bench_clear_sram, bench_write_aligned_sram, bench_write_unaligned_sram
+};
+
+static uint32_t bench_time(bench_loop loop)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (uint8_t i = 0; i < LCD_BENCH_REPEATS; i++)
+    {
+        uint32_t start = cycles_now();
+        loop();
+        uint32_t cycles = cycles_now() - start;
+
+        if (cycles < best)
+        {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+void lcd_bench_run(struct lcd_bench_result *results)
+{
+    cycles_init();
+
+    for (uint8_t loop = 0; loop < LCD_BENCH_LOOPS; loop++)
+    {
+        results[loop].loop = (enum lcd_bench_loop)loop;
+        results[loop].flash_cycles = bench_time(bench_flash_loops[loop]);
+        results[loop].sram_cycles = bench_time(bench_sram_loops[loop]);
+    }
+
+    lcd_clear_screen_buffer();
+    lcd_set_buffer_pixel_cursor(0, 0);
+}
+
+static void bench_print_fields(void)
+{
+    for (uint8_t i = 0; i < LCD_BENCH_PRINT_FIELDS; i++)
+    {
+        uint8_t x = (uint8_t)((i % 2U) * BENCH_PRINT_COLUMN_X);
+        uint8_t y = (uint8_t)((i / 2U) * BENCH_PRINT_ROW_Y);
+        // One negative field for the sign path, the rest fit their widths
+        int32_t value = i ? (int32_t)(i * 1234U) : -1234;
+
+        if (i == 6U)
+        {
+            lcd_printf_at(x, y, bench_print_formats[i], 'T', value);
+        }
+        else if (i == 7U)
+        {
+            lcd_printf_at(x, y, bench_print_formats[i], "label");
+        }
+        else
+        {
+            lcd_printf_at(x, y, bench_print_formats[i], value);
+        }
+    }
+}
+
+void lcd_bench_print_run(struct lcd_bench_print_result *result)
+{
+    cycles_init();
+
+    result->cycles = bench_time(bench_print_fields);
+    result->cpu_load = (uint32_t)(((uint64_t)result->cycles * LCD_BENCH_PRINT_HZ * 10000U) / SystemCoreClock);
+
+    lcd_clear_screen_buffer();
+    lcd_set_buffer_pixel_cursor(0, 0);
+}
+
+void lcd_bench_print_report(const struct lcd_bench_print_result *result, lcd_bench_put put)
+{
+    // e.g. "printf x10 fields   21000 cyc  cpu   1.31% at 50Hz  ok"
+    report_put_string(put, "printf x", 0);
+    report_put_uint(put, LCD_BENCH_PRINT_FIELDS, 0);
+    report_put_string(put, " fields ", 0);
+    report_put_uint(put, result->cycles, 7);
+    report_put_string(put, " cyc  cpu ", 0);
+    report_put_uint(put, result->cpu_load / 100U, 3);
+    put('.');
+    report_put_uint(put, (result->cpu_load / 10U) % 10U, 1);
+    report_put_uint(put, result->cpu_load % 10U, 1);
+    report_put_string(put, "% at ", 0);
+    report_put_uint(put, LCD_BENCH_PRINT_HZ, 0);
+    report_put_string(put, (result->cpu_load <= LCD_BENCH_PRINT_BUDGET) ? "Hz  ok" : "Hz  over budget", 0);
+    report_put_line_end(put);
+}
+
+void lcd_bench_report(const struct lcd_bench_result *results, lcd_bench_put put)
+{
+    for (uint8_t i = 0; i < LCD_BENCH_LOOPS; i++)
+    {
+        const struct lcd_bench_result *result = &results[i];
+
+        // e.g. "checksum  flash   4540 cyc  sram   3530 cyc  sram/flash  77%"
+        report_put_string(put, bench_loop_names[result->loop], 9);
+        report_put_string(put, " flash ", 0);
+        report_put_uint(put, result->flash_cycles, 6);
+        report_put_string(put, " cyc  sram ", 0);
+        report_put_uint(put, result->sram_cycles, 6);
+        report_put_string(put, " cyc  sram/flash ", 0);
+        report_put_uint(put, result->flash_cycles ? (result->sram_cycles * 100U) / result->flash_cycles : 0, 3);
+        put('%');
+        report_put_line_end(put);
+    }
+}
+
+#endif
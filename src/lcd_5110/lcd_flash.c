@@ -0,0 +1,199 @@
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+#include "lcd_5110/lcd_flash.h"
+#include "spi_nor/spi_nor.h"
+
+#define FONTS (LCD_5110_FONT_MINE + 1U)
+
+// Fonts not in flash
+#define NO_FONT_ADDRESS 0xFFFFFFFFUL
+
+struct lcd_flash_glyph_slot
+{
+    char glyph[LCD_5110_GLYPH_WIDTH];
+    // Font and character held, 0 when empty
+    uint16_t key;
+};
+
+static struct spi_nor *flash_nor = 0;
+static uint32_t flash_font_address[FONTS] = {NO_FONT_ADDRESS, NO_FONT_ADDRESS};
+
+// Direct mapped on the character, so a string in one font never thrashes
+static struct lcd_flash_glyph_slot flash_glyph_slots[LCD_FLASH_GLYPH_SLOTS];
+
+static const char flash_blank_glyph[LCD_5110_GLYPH_WIDTH] = {0};
+
+static struct lcd_flash_stats flash_stats = {0};
+
+static uint16_t flash_glyph_key(enum lcd_5110_font font, uint8_t index)
+{
+    // Index 0 is ' ', keep 0 free for empty slots
+    return (uint16_t)(((uint16_t)font << 8U) | (uint16_t)(index + 1U));
+}
+
+static void flash_clear_glyphs(void)
+{
+    for (uint8_t i = 0; i < LCD_FLASH_GLYPH_SLOTS; i++)
+    {
+        flash_glyph_slots[i].key = 0;
+    }
+}
+
+/**
+ * @brief   Glyph source for fonts in flash
+ *
+ */
+static const char *flash_get_glyph(enum lcd_5110_font font, char character)
+{
+    uint8_t index = (uint8_t)(character - ' ');
+
+    if (character < ' ' || index >= LCD_FLASH_FONT_CHARACTERS)
+    {
+        index = 0;
+    }
+
+    uint16_t key = flash_glyph_key(font, index);
+    struct lcd_flash_glyph_slot *slot = &flash_glyph_slots[index % LCD_FLASH_GLYPH_SLOTS];
+
+    if (slot->key == key)
+    {
+        flash_stats.glyph_hits++;
+        return slot->glyph;
+    }
+    flash_stats.glyph_misses++;
+
+    // Five bytes, not worth setting up DMA. Let an image read finish first
+    spi_nor_dma_wait(flash_nor);
+    if (spi_nor_read(flash_nor, flash_font_address[font] + ((uint32_t)index * LCD_5110_GLYPH_WIDTH),
+                     (uint8_t *)slot->glyph, LCD_5110_GLYPH_WIDTH) != SPI_NOR_OK)
+    {
+        slot->key = 0;
+        flash_stats.read_errors++;
+        return flash_blank_glyph;
+    }
+
+    slot->key = key;
+    return slot->glyph;
+}
+
+void lcd_flash_attach(struct spi_nor *nor)
+{
+    flash_nor = nor;
+    flash_clear_glyphs();
+}
+
+enum spi_nor_ret lcd_flash_set_font(enum lcd_5110_font font, uint32_t address)
+{
+    uint32_t size = LCD_FLASH_FONT_CHARACTERS * LCD_5110_GLYPH_WIDTH;
+
+    if (!flash_nor || (unsigned)font >= FONTS)
+    {
+        return SPI_NOR_INVALID_CONFIG;
+    }
+    if (address >= flash_nor->size || size > (flash_nor->size - address))
+    {
+        return SPI_NOR_OUT_OF_RANGE;
+    }
+
+    flash_font_address[font] = address;
+    flash_clear_glyphs();
+    lcd_set_glyph_source(font, flash_get_glyph);
+
+    return SPI_NOR_OK;
+}
+
+static enum spi_nor_ret flash_check_image(uint8_t x, uint8_t bank, uint8_t width, uint8_t banks)
+{
+    if (!flash_nor)
+    {
+        return SPI_NOR_INVALID_CONFIG;
+    }
+    if (width == 0 || banks == 0 || x >= LCD_5110_COLUMNS || width > (LCD_5110_COLUMNS - x) ||
+        bank >= LCD_5110_BANKS || banks > (LCD_5110_BANKS - bank))
+    {
+        return SPI_NOR_OUT_OF_RANGE;
+    }
+    return SPI_NOR_OK;
+}
+
+/**
+ * @brief   Start the DMA read of one bank of an image into the screen buffer
+ *
+ */
+static enum spi_nor_ret flash_read_bank(uint32_t address, uint8_t x, uint8_t bank, uint8_t width, uint8_t row)
+{
+    uint8_t *buffer = lcd_get_screen_buffer();
+
+    return spi_nor_read_dma(flash_nor, address + ((uint32_t)row * width),
+                            &buffer[((bank + row) * LCD_5110_COLUMNS) + x], width, 0);
+}
+
+enum spi_nor_ret lcd_flash_load_image(uint32_t address, uint8_t x, uint8_t bank, uint8_t width, uint8_t banks)
+{
+    enum spi_nor_ret ret = flash_check_image(x, bank, width, banks);
+    if (ret != SPI_NOR_OK)
+    {
+        return ret;
+    }
+
+    spi_nor_dma_wait(flash_nor);
+
+    if (x == 0 && width == LCD_5110_COLUMNS)
+    {
+        // Full width banks are contiguous in the buffer, one read does it
+        ret = spi_nor_read_dma(flash_nor, address, &lcd_get_screen_buffer()[bank * LCD_5110_COLUMNS],
+                               (uint32_t)width * banks, 0);
+        spi_nor_dma_wait(flash_nor);
+    }
+    else
+    {
+        for (uint8_t row = 0; row < banks && ret == SPI_NOR_OK; row++)
+        {
+            ret = flash_read_bank(address, x, bank, width, row);
+            spi_nor_dma_wait(flash_nor);
+        }
+    }
+
+    for (uint8_t row = 0; row < banks; row++)
+    {
+        lcd_mark_dirty(bank + row, x, x + width - 1U);
+    }
+
+    return ret;
+}
+
+enum spi_nor_ret lcd_flash_show_image(uint32_t address, uint8_t x, uint8_t bank, uint8_t width, uint8_t banks)
+{
+    enum spi_nor_ret ret = flash_check_image(x, bank, width, banks);
+    if (ret != SPI_NOR_OK)
+    {
+        return ret;
+    }
+
+    spi_nor_dma_wait(flash_nor);
+    ret = flash_read_bank(address, x, bank, width, 0);
+
+    for (uint8_t row = 0; row < banks && ret == SPI_NOR_OK; row++)
+    {
+        spi_nor_dma_wait(flash_nor);
+
+        // Read the next bank while this one goes to the panel
+        if (row + 1U < banks)
+        {
+            ret = flash_read_bank(address, x, bank, width, row + 1U);
+        }
+
+        // Through the screen buffer, so a warm reset brings the image back
+        lcd_display_span(bank + row, x, x + width - 1U);
+    }
+
+    spi_nor_dma_wait(flash_nor);
+
+    return ret;
+}
+
+void lcd_flash_get_stats(struct lcd_flash_stats *stats)
+{
+    *stats = flash_stats;
+}
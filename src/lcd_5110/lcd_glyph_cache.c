@@ -0,0 +1,354 @@
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+#include "lcd_5110/lcd_glyph_cache.h"
+
+#define PIXELS_BYTE 8U
+
+struct lcd_glyph_cache_entry
+{
+    const char *string;
+    uint32_t last_used;
+    uint16_t offset;
+    uint8_t width;
+    uint8_t font;
+    uint8_t shift;
+    uint8_t inverse;
+    uint8_t valid;
+};
+
+static uint8_t glyph_cache_arena[LCD_GLYPH_CACHE_ARENA_SIZE];
+static uint16_t glyph_cache_arena_used = 0;
+
+static struct lcd_glyph_cache_entry glyph_cache_entries[LCD_GLYPH_CACHE_ENTRIES];
+
+// Incremented on every lookup to order entries for LRU eviction
+static uint32_t glyph_cache_clock = 0;
+
+static uint32_t glyph_cache_hits = 0;
+static uint32_t glyph_cache_misses = 0;
+static uint32_t glyph_cache_evictions = 0;
+static uint32_t glyph_cache_uncached = 0;
+
+/**
+ * @brief   Walks a string column by column, including padding columns
+ *
+ */
+struct glyph_cursor
+{
+    const char *string;
+    const char *glyph;
+    uint8_t column;
+    uint8_t font;
+};
+
+static void glyph_cursor_start(struct glyph_cursor *cursor, const char *string, uint8_t font)
+{
+    cursor->string = string;
+    cursor->column = 0;
+    cursor->font = font;
+    cursor->glyph = lcd_get_glyph((enum lcd_5110_font)font, *string);
+}
+
+static uint8_t glyph_cursor_next(struct glyph_cursor *cursor)
+{
+    uint8_t byte = 0x00;
+
+    // Column 0 and the last column are padding
+    if (cursor->column > 0 && cursor->column <= LCD_5110_GLYPH_WIDTH)
+    {
+        byte = (uint8_t)cursor->glyph[cursor->column - 1U];
+    }
+
+    if (++cursor->column == LCD_5110_CHAR_WIDTH)
+    {
+        cursor->column = 0;
+        cursor->string++;
+        cursor->glyph = lcd_get_glyph((enum lcd_5110_font)cursor->font, *cursor->string);
+    }
+
+    return byte;
+}
+
+static uint8_t glyph_string_width(const char *string)
+{
+    uint16_t width = 0;
+    while (*string && width < LCD_5110_COLUMNS)
+    {
+        width += LCD_5110_CHAR_WIDTH;
+        string++;
+    }
+    return (width > LCD_5110_COLUMNS) ? LCD_5110_COLUMNS : (uint8_t)width;
+}
+
+/**
+ * @brief   Merge one column of a label into the screen buffer
+ *
+ * @param x Column
+ * @param bank Top bank of the label
+ * @param shift Bit offset of the label within the bank
+ * @param top Bits for the top bank, already shifted
+ * @param bottom Bits for the bank below, already shifted
+ */
+static void glyph_blit_column(uint8_t *buffer, uint8_t x, uint8_t bank, uint8_t shift, uint8_t top, uint8_t bottom)
+{
+    uint8_t top_mask = (uint8_t)(0xFFU << shift);
+    uint16_t index = (uint16_t)(bank * LCD_5110_COLUMNS) + x;
+
+    buffer[index] = (buffer[index] & ~top_mask) | (top & top_mask);
+
+    if (shift && (bank + 1U) < LCD_5110_BANKS)
+    {
+        uint8_t bottom_mask = (uint8_t)(0xFFU >> (PIXELS_BYTE - shift));
+        index += LCD_5110_COLUMNS;
+        buffer[index] = (buffer[index] & ~bottom_mask) | (bottom & bottom_mask);
+    }
+}
+
+static void glyph_mark_dirty(uint8_t x, uint8_t bank, uint8_t shift, uint8_t columns)
+{
+    lcd_mark_dirty(bank, x, x + columns - 1U);
+    if (shift)
+    {
+        lcd_mark_dirty(bank + 1U, x, x + columns - 1U);
+    }
+}
+
+static void glyph_cache_blit(const struct lcd_glyph_cache_entry *entry, uint8_t x, uint8_t bank)
+{
+    uint8_t *buffer = lcd_get_screen_buffer();
+    const uint8_t *top = &glyph_cache_arena[entry->offset];
+    const uint8_t *bottom = top + entry->width;
+    uint8_t columns = entry->width;
+
+    if ((uint16_t)x + columns > LCD_5110_COLUMNS)
+    {
+        columns = LCD_5110_COLUMNS - x;
+    }
+
+    for (uint8_t i = 0; i < columns; i++)
+    {
+        glyph_blit_column(buffer, x + i, bank, entry->shift, top[i], entry->shift ? bottom[i] : 0U);
+    }
+
+    glyph_mark_dirty(x, bank, entry->shift, columns);
+}
+
+/**
+ * @brief   Draw without caching, for labels larger than the arena
+ *
+ */
+static void glyph_draw_direct(uint8_t x, uint8_t bank, uint8_t shift, uint8_t font, uint8_t inverse, const char *string)
+{
+    uint8_t *buffer = lcd_get_screen_buffer();
+    uint8_t columns = glyph_string_width(string);
+    uint8_t fill = inverse ? 0xFFU : 0x00U;
+    struct glyph_cursor cursor;
+
+    if ((uint16_t)x + columns > LCD_5110_COLUMNS)
+    {
+        columns = LCD_5110_COLUMNS - x;
+    }
+
+    glyph_cursor_start(&cursor, string, font);
+    for (uint8_t i = 0; i < columns; i++)
+    {
+        uint8_t byte = glyph_cursor_next(&cursor) ^ fill;
+        glyph_blit_column(buffer, x + i, bank, shift, (uint8_t)(byte << shift), (uint8_t)(byte >> (PIXELS_BYTE - shift)));
+    }
+
+    glyph_mark_dirty(x, bank, shift, columns);
+}
+
+static void glyph_cache_evict(uint8_t slot)
+{
+    struct lcd_glyph_cache_entry *victim = &glyph_cache_entries[slot];
+    uint16_t size = victim->width * (victim->shift ? 2U : 1U);
+    uint16_t end = victim->offset + size;
+
+    // Compact the arena so free space is always at the end
+    for (uint16_t i = end; i < glyph_cache_arena_used; i++)
+    {
+        glyph_cache_arena[i - size] = glyph_cache_arena[i];
+    }
+    glyph_cache_arena_used -= size;
+
+    for (uint8_t i = 0; i < LCD_GLYPH_CACHE_ENTRIES; i++)
+    {
+        if (glyph_cache_entries[i].valid && glyph_cache_entries[i].offset >= end)
+        {
+            glyph_cache_entries[i].offset -= size;
+        }
+    }
+
+    victim->valid = 0;
+    glyph_cache_evictions++;
+}
+
+static int8_t glyph_cache_lru_slot(void)
+{
+    int8_t oldest = -1;
+    for (uint8_t i = 0; i < LCD_GLYPH_CACHE_ENTRIES; i++)
+    {
+        if (glyph_cache_entries[i].valid &&
+            (oldest < 0 || (glyph_cache_clock - glyph_cache_entries[i].last_used) >
+                               (glyph_cache_clock - glyph_cache_entries[oldest].last_used)))
+        {
+            oldest = (int8_t)i;
+        }
+    }
+    return oldest;
+}
+
+/**
+ * @brief   Make room for a bitmap, evicting least recently used labels
+ *
+ * @param size Bytes needed
+ * @return int8_t Free entry slot, -1 if the bitmap can never fit
+ */
+static int8_t glyph_cache_allocate(uint16_t size)
+{
+    if (size > LCD_GLYPH_CACHE_ARENA_SIZE)
+    {
+        return -1;
+    }
+
+    while (glyph_cache_arena_used + size > LCD_GLYPH_CACHE_ARENA_SIZE)
+    {
+        glyph_cache_evict((uint8_t)glyph_cache_lru_slot());
+    }
+
+    for (uint8_t i = 0; i < LCD_GLYPH_CACHE_ENTRIES; i++)
+    {
+        if (!glyph_cache_entries[i].valid)
+        {
+            return (int8_t)i;
+        }
+    }
+
+    // Out of entries rather than arena
+    int8_t slot = glyph_cache_lru_slot();
+    glyph_cache_evict((uint8_t)slot);
+    return slot;
+}
+
+static void glyph_cache_rasterise(struct lcd_glyph_cache_entry *entry)
+{
+    uint8_t *top = &glyph_cache_arena[entry->offset];
+    uint8_t *bottom = top + entry->width;
+    uint8_t fill = entry->inverse ? 0xFFU : 0x00U;
+    struct glyph_cursor cursor;
+
+    glyph_cursor_start(&cursor, entry->string, entry->font);
+    for (uint8_t i = 0; i < entry->width; i++)
+    {
+        uint8_t byte = glyph_cursor_next(&cursor) ^ fill;
+        top[i] = (uint8_t)(byte << entry->shift);
+        if (entry->shift)
+        {
+            bottom[i] = (uint8_t)(byte >> (PIXELS_BYTE - entry->shift));
+        }
+    }
+}
+
+void lcd_glyph_cache_draw(uint8_t x, uint8_t y, enum lcd_5110_font font, uint8_t inverse, const char *string)
+{
+    uint8_t bank = y / PIXELS_BYTE;
+    uint8_t shift = y % PIXELS_BYTE;
+
+    if (!string || !*string || x >= LCD_5110_COLUMNS || bank >= LCD_5110_BANKS)
+    {
+        return;
+    }
+    inverse = inverse ? 1U : 0U;
+
+    glyph_cache_clock++;
+
+    for (uint8_t i = 0; i < LCD_GLYPH_CACHE_ENTRIES; i++)
+    {
+        struct lcd_glyph_cache_entry *entry = &glyph_cache_entries[i];
+        if (entry->valid && entry->string == string && entry->font == font &&
+            entry->shift == shift && entry->inverse == inverse)
+        {
+            entry->last_used = glyph_cache_clock;
+            glyph_cache_hits++;
+            glyph_cache_blit(entry, x, bank);
+            return;
+        }
+    }
+
+    glyph_cache_misses++;
+
+    uint8_t width = glyph_string_width(string);
+    uint16_t size = width * (shift ? 2U : 1U);
+    int8_t slot = glyph_cache_allocate(size);
+
+    if (slot < 0)
+    {
+        glyph_cache_uncached++;
+        glyph_draw_direct(x, bank, shift, font, inverse, string);
+        return;
+    }
+
+    struct lcd_glyph_cache_entry *entry = &glyph_cache_entries[slot];
+    entry->string = string;
+    entry->font = font;
+    entry->shift = shift;
+    entry->inverse = inverse;
+    entry->width = width;
+    entry->offset = glyph_cache_arena_used;
+    entry->last_used = glyph_cache_clock;
+    entry->valid = 1;
+    glyph_cache_arena_used += size;
+
+    glyph_cache_rasterise(entry);
+    glyph_cache_blit(entry, x, bank);
+}
+
+void lcd_glyph_cache_invalidate(const char *string)
+{
+    for (uint8_t i = 0; i < LCD_GLYPH_CACHE_ENTRIES; i++)
+    {
+        if (glyph_cache_entries[i].valid && glyph_cache_entries[i].string == string)
+        {
+            glyph_cache_evict(i);
+        }
+    }
+}
+
+void lcd_glyph_cache_clear(void)
+{
+    for (uint8_t i = 0; i < LCD_GLYPH_CACHE_ENTRIES; i++)
+    {
+        glyph_cache_entries[i].valid = 0;
+    }
+    glyph_cache_arena_used = 0;
+    glyph_cache_hits = 0;
+    glyph_cache_misses = 0;
+    glyph_cache_evictions = 0;
+    glyph_cache_uncached = 0;
+}
+
+void lcd_glyph_cache_get_stats(struct lcd_glyph_cache_stats *stats)
+{
+    stats->hits = glyph_cache_hits;
+    stats->misses = glyph_cache_misses;
+    stats->evictions = glyph_cache_evictions;
+    stats->uncached = glyph_cache_uncached;
+    stats->arena_used = glyph_cache_arena_used;
+    stats->entries = 0;
+    for (uint8_t i = 0; i < LCD_GLYPH_CACHE_ENTRIES; i++)
+    {
+        stats->entries += glyph_cache_entries[i].valid;
+    }
+}
+
+uint16_t lcd_glyph_cache_hit_rate(void)
+{
+    uint32_t lookups = glyph_cache_hits + glyph_cache_misses;
+    if (lookups == 0)
+    {
+        return 0;
+    }
+    return (uint16_t)(((uint64_t)glyph_cache_hits * 1000U) / lookups);
+}
@@ -0,0 +1,314 @@
+#include <stdint.h>
+#include <stdarg.h>
+
+#include "lcd_5110/lcd.h"
+#include "lcd_5110/lcd_print.h"
+
+#define UINT32_DIGITS 10U
+#define HEX_DIGITS 8U
+#define MAX_DECIMALS 9U
+#define DEFAULT_DECIMALS 2U
+// Printable range of the font, anything else prints as UNPRINTABLE
+#define FIRST_PRINTABLE ' '
+#define LAST_PRINTABLE '~'
+#define UNPRINTABLE '?'
+
+// Powers of ten used to extract digits by subtraction instead of division
+static const uint32_t lcd_print_pow10[UINT32_DIGITS] =
+{
+    1UL,
+    10UL,
+    100UL,
+    1000UL,
+    10000UL,
+    100000UL,
+    1000000UL,
+    10000000UL,
+    100000000UL,
+    1000000000UL
+};
+
+/**
+ * @brief   Write a character that may come from the caller, e.g. a '\n' in the
+ *          format or a %c argument, mapping what the font can't show
+ *
+ * @param character Character to write
+ */
+static void lcd_print_char(char character)
+{
+    if (character < FIRST_PRINTABLE || character > LAST_PRINTABLE)
+    {
+        character = UNPRINTABLE;
+    }
+    lcd_write_char(character);
+}
+
+static void lcd_print_pad(char pad, uint8_t count)
+{
+    while (count)
+    {
+        lcd_write_char(pad);
+        count--;
+    }
+}
+
+static uint8_t lcd_print_count_digits(uint32_t value)
+{
+    uint8_t digits = 1;
+    while (digits < UINT32_DIGITS && value >= lcd_print_pow10[digits])
+    {
+        digits++;
+    }
+    return digits;
+}
+
+/**
+ * @brief   Emit exactly 'digits' decimal digits of value, most significant first
+ *
+ * @param value Value to print, must be below 10^digits
+ * @param digits Digit count
+ */
+static void lcd_print_digits(uint32_t value, uint8_t digits)
+{
+    while (digits)
+    {
+        uint32_t power = lcd_print_pow10[digits - 1];
+        char digit = '0';
+
+        // At most 9 subtractions per digit
+        while (value >= power)
+        {
+            value -= power;
+            digit++;
+        }
+        lcd_write_char(digit);
+        digits--;
+    }
+}
+
+/**
+ * @brief   Print a magnitude with an optional sign, honouring width and padding
+ *
+ * @param magnitude Absolute value to print
+ * @param negative Print a leading '-'
+ * @param width Minimum field width
+ * @param pad Padding character
+ */
+static void lcd_print_signed(uint32_t magnitude, uint8_t negative, uint8_t width, char pad)
+{
+    uint8_t digits = lcd_print_count_digits(magnitude);
+    uint8_t length = (uint8_t)(digits + (negative ? 1U : 0U));
+    uint8_t fill = (width > length) ? (uint8_t)(width - length) : 0U;
+
+    if (pad == '0')
+    {
+        if (negative)
+        {
+            lcd_write_char('-');
+        }
+        lcd_print_pad('0', fill);
+    }
+    else
+    {
+        lcd_print_pad(pad, fill);
+        if (negative)
+        {
+            lcd_write_char('-');
+        }
+    }
+
+    lcd_print_digits(magnitude, digits);
+}
+
+void lcd_print_uint(uint32_t value, uint8_t width, char pad)
+{
+    lcd_print_signed(value, 0, width, pad);
+}
+
+void lcd_print_int(int32_t value, uint8_t width, char pad)
+{
+    uint8_t negative = (value < 0);
+    uint32_t magnitude = negative ? (0U - (uint32_t)value) : (uint32_t)value;
+
+    lcd_print_signed(magnitude, negative, width, pad);
+}
+
+void lcd_print_hex(uint32_t value, uint8_t width, char pad, uint8_t upper)
+{
+    char letter_base = upper ? 'A' : 'a';
+    uint8_t digits = 1;
+
+    while (digits < HEX_DIGITS && (value >> (digits * 4U)))
+    {
+        digits++;
+    }
+
+    if (width > digits)
+    {
+        lcd_print_pad(pad, width - digits);
+    }
+
+    while (digits)
+    {
+        digits--;
+        uint8_t nibble = (value >> (digits * 4U)) & 0x0FU;
+        lcd_write_char((nibble < 10U) ? (char)('0' + nibble) : (char)(letter_base + nibble - 10U));
+    }
+}
+
+void lcd_print_fixed(int32_t value, uint8_t frac_bits, uint8_t decimals, uint8_t width, char pad)
+{
+    uint8_t negative = (value < 0);
+    uint32_t magnitude = negative ? (0U - (uint32_t)value) : (uint32_t)value;
+
+    if (frac_bits > 31U)
+    {
+        frac_bits = 31U;
+    }
+    if (decimals > MAX_DECIMALS)
+    {
+        decimals = MAX_DECIMALS;
+    }
+
+    uint32_t integer = magnitude >> frac_bits;
+    uint32_t fraction = magnitude & ((1UL << frac_bits) - 1U);
+
+    // Scale the binary fraction to 'decimals' decimal digits, rounding to nearest.
+    // Only a multiply and a shift so no division is needed.
+    uint64_t scaled = (uint64_t)fraction * lcd_print_pow10[decimals];
+    if (frac_bits)
+    {
+        scaled += (1ULL << (frac_bits - 1U));
+    }
+    uint32_t fraction_digits = (uint32_t)(scaled >> frac_bits);
+
+    // Rounding carried into the integer part, e.g. 1.999 -> 2.00
+    if (fraction_digits >= lcd_print_pow10[decimals])
+    {
+        fraction_digits -= lcd_print_pow10[decimals];
+        integer++;
+    }
+
+    // Don't print "-0.00"
+    if (integer == 0 && fraction_digits == 0)
+    {
+        negative = 0;
+    }
+
+    uint8_t fraction_length = decimals ? (uint8_t)(decimals + 1U) : 0U;
+    uint8_t integer_width = (width > fraction_length) ? (uint8_t)(width - fraction_length) : 0U;
+
+    lcd_print_signed(integer, negative, integer_width, pad);
+
+    if (decimals)
+    {
+        lcd_write_char('.');
+        lcd_print_digits(fraction_digits, decimals);
+    }
+}
+
+static void lcd_vprintf(const char *format, va_list args)
+{
+    while (*format)
+    {
+        if (*format != '%')
+        {
+            lcd_print_char(*format++);
+            continue;
+        }
+        format++;
+
+        char pad = ' ';
+        uint8_t width = 0;
+        uint8_t precision = DEFAULT_DECIMALS;
+
+        if (*format == '0')
+        {
+            pad = '0';
+            format++;
+        }
+        while (*format >= '0' && *format <= '9')
+        {
+            width = (uint8_t)(width * 10U + (*format - '0'));
+            format++;
+        }
+        if (*format == '.')
+        {
+            format++;
+            precision = 0;
+            while (*format >= '0' && *format <= '9')
+            {
+                precision = (uint8_t)(precision * 10U + (*format - '0'));
+                format++;
+            }
+        }
+
+        switch (*format)
+        {
+        case 'd':
+        case 'i':
+            lcd_print_int((int32_t)va_arg(args, int), width, pad);
+            break;
+        case 'u':
+            lcd_print_uint((uint32_t)va_arg(args, unsigned int), width, pad);
+            break;
+        case 'x':
+            lcd_print_hex((uint32_t)va_arg(args, unsigned int), width, pad, 0);
+            break;
+        case 'X':
+            lcd_print_hex((uint32_t)va_arg(args, unsigned int), width, pad, 1);
+            break;
+        case 'q':
+            lcd_print_fixed((int32_t)va_arg(args, int), LCD_PRINT_Q_BITS, precision, width, pad);
+            break;
+        case 'c':
+            lcd_print_pad(' ', (width > 1U) ? (uint8_t)(width - 1U) : 0U);
+            lcd_print_char((char)va_arg(args, int));
+            break;
+        case 's':
+        {
+            const char *string = va_arg(args, const char *);
+            // Only counted as far as the width, the padding is all it's for
+            uint16_t length = 0;
+            while (length < width && string[length])
+            {
+                length++;
+            }
+            lcd_print_pad(' ', (uint8_t)(width - length));
+            while (*string)
+            {
+                lcd_print_char(*string++);
+            }
+            break;
+        }
+        case '%':
+            lcd_write_char('%');
+            break;
+        case '\0':
+            // Dangling '%' at the end of the format
+            return;
+        default:
+            // Unknown conversion, print it as is
+            lcd_print_char(*format);
+            break;
+        }
+        format++;
+    }
+}
+
+void lcd_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    lcd_vprintf(format, args);
+    va_end(args);
+}
+
+void lcd_printf_at(uint8_t x, uint8_t y, const char *format, ...)
+{
+    va_list args;
+    lcd_set_buffer_pixel_cursor(x, y);
+    va_start(args, format);
+    lcd_vprintf(format, args);
+    va_end(args);
+}
@@ -0,0 +1,466 @@
+#include <stdint.h>
+
+#include "lcd_5110/lcd.h"
+#include "lcd_5110/lcd_remote.h"
+#include "hal/idle.h"
+#include "hal/uart.h"
+#include "util/timebase.h"
+
+#define SYNC_0 0xA5U
+#define SYNC_1 0x5AU
+#define CRC8_POLYNOMIAL 0x07U
+
+#define RLE_LITERAL 0x80U
+#define RLE_MAX_RUN 128U
+
+// Largest delta payload: every byte changed, one token per 128 literals
+#define MAX_DELTA_LENGTH (LCD_5110_BUFFER_SIZE + (LCD_5110_BUFFER_SIZE / RLE_MAX_RUN) + 1U)
+
+// Sync, TYPE, SEQ, LEN and CRC around every payload
+#define FRAME_OVERHEAD 7U
+// One start, 8 data and one stop bit per byte on the wire
+#define BYTE_US (((10UL * 1000000UL) + LCD_REMOTE_BAUD - 1U) / LCD_REMOTE_BAUD)
+// Time the host may take to turn a frame round into its ACK
+#define ACK_MARGIN_US 20000UL
+
+enum lcd_remote_rx_state
+{
+    RX_SYNC_0,
+    RX_SYNC_1,
+    RX_TYPE,
+    RX_SEQ,
+    RX_LENGTH_LO,
+    RX_LENGTH_HI,
+    RX_PAYLOAD,
+    RX_CRC
+};
+
+// Copy of the last frame mirrored to the host, the base for the next delta
+static uint8_t lcd_remote_reference[LCD_5110_BUFFER_SIZE];
+
+static uint8_t tx_seq = 0;
+static uint8_t tx_awaiting_ack = 0;
+static uint8_t tx_need_keyframe = 1;
+// A frame not acknowledged by then is assumed lost
+static uint64_t tx_ack_deadline = 0;
+static uint8_t tx_crc = 0;
+
+static enum lcd_remote_rx_state rx_state = RX_SYNC_0;
+static uint8_t rx_type = 0;
+static uint8_t rx_seq = 0;
+static uint16_t rx_length = 0;
+static uint16_t rx_received = 0;
+static uint8_t rx_crc = 0;
+// Frame is being applied to the screen buffer (as opposed to skipped)
+static uint8_t rx_applying = 0;
+static uint8_t rx_error = 0;
+
+// Host frames apply on top of the screen buffer, so a delta is only valid
+// when the last applied frame had the previous sequence number
+static uint8_t rx_synced = 0;
+static uint8_t rx_expected_seq = 0;
+
+// Frame being received, copied to the screen buffer only once its CRC and
+// sequence check out. A keyframe is the frame itself, a delta its XOR with
+// the screen buffer
+static uint8_t rx_staging[LCD_5110_BUFFER_SIZE];
+
+// Decoder position
+static uint16_t rx_position = 0;
+static uint8_t rx_token_remaining = 0;
+
+// Deep sleep blocked once, for as long as the link listens
+static uint8_t rx_holding_deep_sleep = 0;
+
+static uint8_t lcd_remote_crc8(uint8_t crc, uint8_t byte)
+{
+    crc ^= byte;
+    for (uint8_t i = 0; i < 8U; i++)
+    {
+        crc = (crc & 0x80U) ? (uint8_t)((crc << 1U) ^ CRC8_POLYNOMIAL) : (uint8_t)(crc << 1U);
+    }
+    return crc;
+}
+
+static void lcd_remote_put(uint8_t byte)
+{
+    tx_crc = lcd_remote_crc8(tx_crc, byte);
+    uart0_write(byte);
+}
+
+static void lcd_remote_send_header(enum lcd_remote_type type, uint8_t seq, uint16_t length)
+{
+    uart0_write(SYNC_0);
+    uart0_write(SYNC_1);
+
+    tx_crc = 0;
+    lcd_remote_put(type);
+    lcd_remote_put(seq);
+    lcd_remote_put(length & 0xFFU);
+    lcd_remote_put(length >> 8U);
+}
+
+static void lcd_remote_send_control(enum lcd_remote_type type, uint8_t seq)
+{
+    lcd_remote_send_header(type, seq, 0);
+    uart0_write(tx_crc);
+}
+
+/**
+ * @brief   Run length code the XOR of frame and the reference.
+ *          Runs once to size the payload and again to send it, so no output
+ *          buffer is needed. Trailing unchanged bytes are not coded.
+ *
+ * @param frame Current screen buffer
+ * @param emit Send the coded bytes as well as counting them
+ * @return uint16_t Payload length
+ */
+static uint16_t lcd_remote_encode_delta(const uint8_t *frame, uint8_t emit)
+{
+    uint16_t length = 0;
+    uint16_t pending_skip = 0;
+    uint16_t i = 0;
+
+    while (i < LCD_5110_BUFFER_SIZE)
+    {
+        if (frame[i] == lcd_remote_reference[i])
+        {
+            pending_skip++;
+            i++;
+            continue;
+        }
+
+        // Flush the skipped bytes ahead of the changed ones
+        while (pending_skip)
+        {
+            uint8_t run = (pending_skip > RLE_MAX_RUN) ? RLE_MAX_RUN : (uint8_t)pending_skip;
+            if (emit)
+            {
+                lcd_remote_put(run - 1U);
+            }
+            length++;
+            pending_skip -= run;
+        }
+
+        // Literal run. A single unchanged byte is cheaper to carry than to skip
+        uint8_t run = 0;
+        while ((i + run) < LCD_5110_BUFFER_SIZE && run < RLE_MAX_RUN)
+        {
+            uint16_t next = i + run;
+            if (frame[next] == lcd_remote_reference[next] &&
+                ((next + 1U) >= LCD_5110_BUFFER_SIZE || frame[next + 1U] == lcd_remote_reference[next + 1U]))
+            {
+                break;
+            }
+            run++;
+        }
+
+        if (emit)
+        {
+            lcd_remote_put(RLE_LITERAL | (run - 1U));
+            for (uint8_t k = 0; k < run; k++)
+            {
+                lcd_remote_put(frame[i + k] ^ lcd_remote_reference[i + k]);
+            }
+        }
+        length += 1U + run;
+        i += run;
+    }
+
+    return length;
+}
+
+void lcd_remote_init(void)
+{
+    uart0_init(LCD_REMOTE_BAUD);
+
+    // UART0 isn't clocked in deep sleep and a frame can start at any time
+    if (!rx_holding_deep_sleep)
+    {
+        idle_block_deep_sleep();
+        rx_holding_deep_sleep = 1;
+    }
+
+    tx_seq = 0;
+    tx_awaiting_ack = 0;
+    tx_need_keyframe = 1;
+
+    rx_state = RX_SYNC_0;
+    rx_synced = 0;
+}
+
+void lcd_remote_resync(void)
+{
+    tx_need_keyframe = 1;
+}
+
+enum lcd_remote_status lcd_remote_send_frame(void)
+{
+    const uint8_t *frame = lcd_get_screen_buffer();
+
+    if (tx_awaiting_ack)
+    {
+        if (!timebase_expired(tx_ack_deadline))
+        {
+            return LCD_REMOTE_BUSY;
+        }
+        // ACK or frame lost, the host can't be trusted to have the reference
+        tx_awaiting_ack = 0;
+        tx_need_keyframe = 1;
+    }
+
+    tx_seq++;
+    uint16_t length = LCD_5110_BUFFER_SIZE;
+
+    if (tx_need_keyframe)
+    {
+        lcd_remote_send_header(LCD_REMOTE_KEYFRAME, tx_seq, LCD_5110_BUFFER_SIZE);
+        for (uint16_t i = 0; i < LCD_5110_BUFFER_SIZE; i++)
+        {
+            lcd_remote_put(frame[i]);
+            lcd_remote_reference[i] = frame[i];
+        }
+        uart0_write(tx_crc);
+        tx_need_keyframe = 0;
+    }
+    else
+    {
+        length = lcd_remote_encode_delta(frame, 0);
+        if (length == 0)
+        {
+            tx_seq--;
+            return LCD_REMOTE_NO_CHANGE;
+        }
+
+        lcd_remote_send_header(LCD_REMOTE_DELTA, tx_seq, length);
+        lcd_remote_encode_delta(frame, 1);
+        uart0_write(tx_crc);
+
+        for (uint16_t i = 0; i < LCD_5110_BUFFER_SIZE; i++)
+        {
+            lcd_remote_reference[i] = frame[i];
+        }
+    }
+
+    // The last byte is queued, not yet sent. Allow for the whole frame still
+    // being on the wire, the ACK coming back and the host in between
+    tx_awaiting_ack = 1;
+    tx_ack_deadline = timebase_deadline(((length + (2U * FRAME_OVERHEAD)) * BYTE_US) + ACK_MARGIN_US);
+
+    return LCD_REMOTE_OK;
+}
+
+static void lcd_remote_rx_payload(uint8_t byte)
+{
+    if (rx_type == LCD_REMOTE_KEYFRAME)
+    {
+        rx_staging[rx_position++] = byte;
+        return;
+    }
+
+    // Delta
+    if (rx_token_remaining)
+    {
+        if (rx_position >= LCD_5110_BUFFER_SIZE)
+        {
+            rx_error = 1;
+            return;
+        }
+        rx_staging[rx_position++] = byte;
+        rx_token_remaining--;
+    }
+    else if (byte & RLE_LITERAL)
+    {
+        rx_token_remaining = (byte & ~RLE_LITERAL) + 1U;
+    }
+    else
+    {
+        rx_position += byte + 1U;
+    }
+}
+
+/**
+ * @brief   Apply a received frame to the screen buffer, marking the columns
+ *          that change dirty
+ *
+ */
+static void lcd_remote_rx_commit(void)
+{
+    uint8_t *buffer = lcd_get_screen_buffer();
+    uint16_t i = 0;
+
+    for (uint8_t bank = 0; bank < LCD_5110_BANKS; bank++)
+    {
+        for (uint8_t column = 0; column < LCD_5110_COLUMNS; column++, i++)
+        {
+            uint8_t value = (rx_type == LCD_REMOTE_KEYFRAME) ? rx_staging[i] : (uint8_t)(buffer[i] ^ rx_staging[i]);
+            if (value != buffer[i])
+            {
+                buffer[i] = value;
+                lcd_mark_dirty(bank, column, column);
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Decide what to do with a frame once its header has arrived
+ *
+ */
+static void lcd_remote_rx_begin(void)
+{
+    rx_position = 0;
+    rx_token_remaining = 0;
+    rx_error = 0;
+    rx_applying = 0;
+
+    if (rx_type == LCD_REMOTE_KEYFRAME)
+    {
+        rx_applying = (rx_length == LCD_5110_BUFFER_SIZE);
+    }
+    else if (rx_type == LCD_REMOTE_DELTA)
+    {
+        rx_applying = rx_synced && (rx_seq == rx_expected_seq) && (rx_length <= MAX_DELTA_LENGTH);
+
+        // Skipped bytes stay as they are
+        if (rx_applying)
+        {
+            for (uint16_t i = 0; i < LCD_5110_BUFFER_SIZE; i++)
+            {
+                rx_staging[i] = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief   Handle a complete frame
+ *
+ * @param crc_ok Frame CRC matched
+ * @return enum lcd_remote_status
+ */
+static enum lcd_remote_status lcd_remote_rx_end(uint8_t crc_ok)
+{
+    switch (rx_type)
+    {
+    case LCD_REMOTE_ACK:
+        if (crc_ok && tx_awaiting_ack && rx_seq == tx_seq)
+        {
+            tx_awaiting_ack = 0;
+        }
+        return LCD_REMOTE_IDLE;
+
+    case LCD_REMOTE_NAK:
+        if (crc_ok)
+        {
+            tx_awaiting_ack = 0;
+            tx_need_keyframe = 1;
+        }
+        return LCD_REMOTE_IDLE;
+
+    case LCD_REMOTE_KEYFRAME:
+    case LCD_REMOTE_DELTA:
+        if (rx_applying && crc_ok && !rx_error)
+        {
+            lcd_remote_rx_commit();
+            rx_synced = 1;
+            rx_expected_seq = rx_seq + 1U;
+            lcd_remote_send_control(LCD_REMOTE_ACK, rx_seq);
+            return LCD_REMOTE_FRAME_APPLIED;
+        }
+
+        // Out of sequence or corrupted, nothing was applied. Deltas after it
+        // build on it, so drop them until the keyframe the NAK asks for
+        if (rx_applying)
+        {
+            rx_synced = 0;
+        }
+        lcd_remote_send_control(LCD_REMOTE_NAK, rx_seq);
+        return LCD_REMOTE_IDLE;
+
+    default:
+        return LCD_REMOTE_IDLE;
+    }
+}
+
+enum lcd_remote_status lcd_remote_poll(void)
+{
+    enum lcd_remote_status status = LCD_REMOTE_IDLE;
+    uint8_t byte;
+    enum uartret ret;
+
+    while ((ret = uart0_read(&byte)) != UART_RX_FIFO_EMPTY)
+    {
+        if (ret == UART_RX_ERROR)
+        {
+            // Line error, drop the frame in progress
+            if (rx_state == RX_PAYLOAD || rx_state == RX_CRC)
+            {
+                rx_error = 1;
+            }
+            else
+            {
+                rx_state = RX_SYNC_0;
+                continue;
+            }
+        }
+
+        switch (rx_state)
+        {
+        case RX_SYNC_0:
+            if (byte == SYNC_0)
+            {
+                rx_state = RX_SYNC_1;
+            }
+            break;
+        case RX_SYNC_1:
+            rx_state = (byte == SYNC_1) ? RX_TYPE : ((byte == SYNC_0) ? RX_SYNC_1 : RX_SYNC_0);
+            break;
+        case RX_TYPE:
+            rx_type = byte;
+            rx_crc = lcd_remote_crc8(0, byte);
+            rx_state = RX_SEQ;
+            break;
+        case RX_SEQ:
+            rx_seq = byte;
+            rx_crc = lcd_remote_crc8(rx_crc, byte);
+            rx_state = RX_LENGTH_LO;
+            break;
+        case RX_LENGTH_LO:
+            rx_length = byte;
+            rx_crc = lcd_remote_crc8(rx_crc, byte);
+            rx_state = RX_LENGTH_HI;
+            break;
+        case RX_LENGTH_HI:
+            rx_length |= (uint16_t)byte << 8U;
+            rx_crc = lcd_remote_crc8(rx_crc, byte);
+            rx_received = 0;
+            lcd_remote_rx_begin();
+            rx_state = rx_length ? RX_PAYLOAD : RX_CRC;
+            break;
+        case RX_PAYLOAD:
+            rx_crc = lcd_remote_crc8(rx_crc, byte);
+            if (rx_applying)
+            {
+                lcd_remote_rx_payload(byte);
+            }
+            if (++rx_received == rx_length)
+            {
+                rx_state = RX_CRC;
+            }
+            break;
+        case RX_CRC:
+        {
+            enum lcd_remote_status frame_status = lcd_remote_rx_end(byte == rx_crc);
+            if (frame_status != LCD_REMOTE_IDLE)
+            {
+                status = frame_status;
+            }
+            rx_state = RX_SYNC_0;
+            break;
+        }
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,427 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/common.h"
+#include "hal/gpio.h"
+#include "hal/ssi.h"
+#include "hal/udma.h"
+#include "link/ssi_link.h"
+#include "util/crc16.h"
+#include "util/critical.h"
+#include "util/cycles.h"
+
+#define LINK_SYNC_1 0xA5U
+#define LINK_SYNC_2 0x5AU
+
+#define LINK_SEQUENCE_OFFSET 2U
+#define LINK_LENGTH_OFFSET 3U
+#define LINK_CRC_OFFSET (SSI_LINK_HEADER_SIZE + SSI_LINK_PAYLOAD_MAX)
+
+// Slots that must be free for READY to be high: one for a frame that was
+// already started when READY dropped, one for the next
+#define LINK_READY_FREE_SLOTS 2U
+
+// No DMA progress for this long means the master has stopped clocking
+#define LINK_QUIET_US 100U
+
+#define LINK_RX_DMA_CONTROL (UDMA_PERIPHERAL_TO_MEMORY_8 | UDMA_CHCTL_ARBSIZE_4 | UDMA_CHCTL_XFERMODE_PINGPONG)
+
+struct link_slot
+{
+    uint8_t length;
+    uint8_t payload[SSI_LINK_PAYLOAD_MAX];
+};
+
+static struct ssi_link_stats link_stats = {0};
+
+// Master side
+static struct ssi_handle * link_master_ssi = 0;
+static struct gpio_regs * link_master_ready_gpio = 0;
+static uint8_t link_master_ready_pin = 0;
+static uint8_t link_master_frame[SSI_LINK_FRAME_SIZE];
+static uint8_t link_master_sequence = 0;
+
+// Slave side
+static struct ssi_handle * link_slave_ssi = 0;
+static struct gpio_regs * link_slave_ready_gpio = 0;
+static uint8_t link_slave_ready_pin = 0;
+
+// DMA ping-pong blocks, indexed by enum udma_select
+static uint8_t link_rx_blocks[2][SSI_LINK_FRAME_SIZE];
+static volatile enum udma_select link_rx_next = UDMA_PRIMARY;
+
+static struct link_slot link_rx_slots[SSI_LINK_RX_SLOTS];
+static volatile uint8_t link_rx_head = 0;
+static volatile uint8_t link_rx_tail = 0;
+
+// Frame being assembled byte by byte when frames and blocks don't line up
+static uint8_t link_parse_frame[SSI_LINK_FRAME_SIZE];
+static uint16_t link_parse_count = 0;
+static uint16_t link_parse_start = 0;
+
+static uint8_t link_expected_sequence = 0;
+static uint8_t link_have_sequence = 0;
+
+static volatile uint8_t link_resync_pending = 0;
+static uint16_t link_quiet_remaining = 0;
+static uint32_t link_quiet_since = 0;
+
+static uint16_t link_frame_crc( const uint8_t * frame )
+{
+    return crc16_update( CRC16_INIT, &frame[LINK_SEQUENCE_OFFSET],
+                         (SSI_LINK_HEADER_SIZE - LINK_SEQUENCE_OFFSET) + SSI_LINK_PAYLOAD_MAX );
+}
+
+enum ssi_link_ret ssi_link_master_init( enum ssi_instance instance, enum ssi_pinmux pins, uint32_t bitrate,
+                                        Port ready_port, uint8_t ready_pin )
+{
+    const struct ssi_config config =
+    {
+        .pins = pins,
+        .mode = SSI_MODE_MASTER,
+        .frame_format = FREESCALE,
+        .polarity = STEADY_LOW,
+        .phase = SECOND_EDGE_TRANSITION,
+        .datasize = DATASIZE_8,
+        .bitrate = bitrate,
+        .software_fss = 0
+    };
+
+    link_master_ssi = ssi_get_handle( instance );
+    if ( !link_master_ssi || bitrate > SSI_LINK_DEFAULT_BITRATE || ssi_init( link_master_ssi, &config ) != SSI_OK )
+    {
+        link_master_ssi = 0;
+        return SSI_LINK_INVALID_CONFIG;
+    }
+
+    gpio_enable_port( ready_port );
+    gpio_set_input( ready_port, ready_pin );
+    // A missing slave reads as not ready
+    gpio_set_pull_down( ready_port, ready_pin );
+    link_master_ready_gpio = gpio_get_port( ready_port );
+    link_master_ready_pin = ready_pin;
+
+    link_master_sequence = 0;
+
+    return SSI_LINK_OK;
+}
+
+uint8_t ssi_link_ready( void )
+{
+    return gpio_read( link_master_ready_gpio, link_master_ready_pin ) ? 1U : 0U;
+}
+
+enum ssi_link_ret ssi_link_send( const uint8_t * payload, uint8_t length )
+{
+    if ( length > SSI_LINK_PAYLOAD_MAX )
+    {
+        return SSI_LINK_TOO_LONG;
+    }
+    if ( !link_master_ssi )
+    {
+        return SSI_LINK_INVALID_CONFIG;
+    }
+    if ( !ssi_link_ready() )
+    {
+        link_stats.not_ready++;
+        return SSI_LINK_NOT_READY;
+    }
+
+    uint8_t * frame = link_master_frame;
+    frame[0] = LINK_SYNC_1;
+    frame[1] = LINK_SYNC_2;
+    frame[LINK_SEQUENCE_OFFSET] = link_master_sequence++;
+    frame[LINK_LENGTH_OFFSET] = length;
+
+    for ( uint16_t i = 0; i < SSI_LINK_PAYLOAD_MAX; i++ )
+    {
+        frame[SSI_LINK_HEADER_SIZE + i] = (i < length) ? payload[i] : 0x00U;
+    }
+
+    uint16_t crc = link_frame_crc( frame );
+    frame[LINK_CRC_OFFSET] = (uint8_t)(crc >> 8U);
+    frame[LINK_CRC_OFFSET + 1U] = (uint8_t)crc;
+
+    ssi_write_buf( link_master_ssi, frame, SSI_LINK_FRAME_SIZE );
+
+    link_stats.tx_packets++;
+    link_stats.tx_payload_bytes += length;
+
+    return SSI_LINK_OK;
+}
+
+static void link_update_ready( void )
+{
+    uint8_t free_slots = SSI_LINK_RX_SLOTS - (uint8_t)(link_rx_head - link_rx_tail);
+    uint8_t ready = (free_slots >= LINK_READY_FREE_SLOTS) && !link_resync_pending;
+
+    gpio_write( link_slave_ready_gpio, link_slave_ready_pin, ready );
+}
+
+/**
+ * @brief   Check a complete frame and queue its payload
+ *
+ * @param frame SSI_LINK_FRAME_SIZE bytes starting at the sync bytes
+ * @return uint8_t 1 if the frame was valid
+ */
+static uint8_t link_accept_frame( const uint8_t * frame )
+{
+    uint16_t crc = ((uint16_t)frame[LINK_CRC_OFFSET] << 8U) | frame[LINK_CRC_OFFSET + 1U];
+    uint8_t length = frame[LINK_LENGTH_OFFSET];
+    uint8_t sequence = frame[LINK_SEQUENCE_OFFSET];
+
+    if ( crc != link_frame_crc( frame ) || length > SSI_LINK_PAYLOAD_MAX )
+    {
+        link_stats.crc_errors++;
+        return 0;
+    }
+
+    if ( link_have_sequence && sequence != link_expected_sequence )
+    {
+        link_stats.sequence_gaps += (uint8_t)(sequence - link_expected_sequence);
+    }
+    link_expected_sequence = sequence + 1U;
+    link_have_sequence = 1;
+
+    if ( (uint8_t)(link_rx_head - link_rx_tail) >= SSI_LINK_RX_SLOTS )
+    {
+        link_stats.overruns++;
+        return 1;
+    }
+
+    struct link_slot * slot = &link_rx_slots[link_rx_head % SSI_LINK_RX_SLOTS];
+    slot->length = length;
+    for ( uint8_t i = 0; i < length; i++ )
+    {
+        slot->payload[i] = frame[SSI_LINK_HEADER_SIZE + i];
+    }
+    link_rx_head++;
+
+    link_stats.rx_packets++;
+    link_stats.rx_payload_bytes += length;
+
+    return 1;
+}
+
+/**
+ * @brief   Feed received bytes through the frame parser
+ *
+ * @param block Received bytes
+ * @param length Number of bytes
+ */
+static void link_parse( const uint8_t * block, uint16_t length )
+{
+    // Aligned, the block is exactly one frame. A bad one is dropped whole:
+    // scanning it again would count its CRC error twice. Had the sync bytes
+    // been payload, the real frame starting in this block is lost and the
+    // scan picks up the next one
+    if ( link_parse_count == 0 && length == SSI_LINK_FRAME_SIZE &&
+         block[0] == LINK_SYNC_1 && block[1] == LINK_SYNC_2 )
+    {
+        (void)link_accept_frame( block );
+        return;
+    }
+
+    for ( uint16_t i = 0; i < length; i++ )
+    {
+        uint8_t byte = block[i];
+
+        if ( link_parse_count == 0 )
+        {
+            if ( byte == LINK_SYNC_1 )
+            {
+                link_parse_frame[link_parse_count++] = byte;
+                link_parse_start = i;
+            }
+            continue;
+        }
+
+        if ( link_parse_count == 1 && byte != LINK_SYNC_2 )
+        {
+            link_parse_count = (byte == LINK_SYNC_1) ? 1U : 0U;
+            link_parse_start = i;
+            continue;
+        }
+
+        link_parse_frame[link_parse_count++] = byte;
+
+        if ( link_parse_count == SSI_LINK_FRAME_SIZE )
+        {
+            link_parse_count = 0;
+            if ( link_accept_frame( link_parse_frame ) && link_parse_start != 0 )
+            {
+                // Valid frames straddle blocks. Realign once the bus is quiet
+                link_resync_pending = 1;
+            }
+        }
+    }
+}
+
+static void link_arm_block( enum udma_select select )
+{
+    udma_set_transfer( link_slave_ssi->dma_rx_channel, select, LINK_RX_DMA_CONTROL,
+                       &link_slave_ssi->regs->DR, link_rx_blocks[select], SSI_LINK_FRAME_SIZE );
+}
+
+/**
+ * @brief   Reset DMA so the next byte lands at the start of the primary block
+ *
+ */
+static void link_start_dma( void )
+{
+    uint8_t channel = link_slave_ssi->dma_rx_channel;
+
+    udma_disable( channel );
+    udma_assign_channel( channel, link_slave_ssi->dma_encoding );
+
+    while ( link_slave_ssi->regs->SR & SSI_SR_RNE )
+    {
+        (void)link_slave_ssi->regs->DR;
+    }
+
+    link_arm_block( UDMA_PRIMARY );
+    link_arm_block( UDMA_ALTERNATE );
+    link_rx_next = UDMA_PRIMARY;
+    link_parse_count = 0;
+
+    udma_enable( channel );
+}
+
+static void link_slave_dma_done( struct ssi_handle * ssi, enum ssi_event event )
+{
+    uint8_t channel = ssi->dma_rx_channel;
+
+    if ( event != SSI_EVENT_DMA_RX_DONE )
+    {
+        return;
+    }
+
+    // Blocks complete in order, handle every finished one
+    for ( uint8_t i = 0; i < 2U && udma_get_mode( channel, link_rx_next ) == UDMA_CHCTL_XFERMODE_STOP; i++ )
+    {
+        enum udma_select done = link_rx_next;
+
+        link_parse( link_rx_blocks[done], SSI_LINK_FRAME_SIZE );
+        link_arm_block( done );
+        link_rx_next = (done == UDMA_PRIMARY) ? UDMA_ALTERNATE : UDMA_PRIMARY;
+    }
+
+    if ( !udma_is_enabled( channel ) )
+    {
+        // Both blocks filled before this ran and the controller stopped
+        link_stats.overruns++;
+        udma_enable( channel );
+    }
+
+    link_update_ready();
+}
+
+enum ssi_link_ret ssi_link_slave_init( enum ssi_instance instance, enum ssi_pinmux pins,
+                                       Port ready_port, uint8_t ready_pin )
+{
+    const struct ssi_config config =
+    {
+        .pins = pins,
+        .mode = SSI_MODE_SLAVE_OUTPUT_DISABLED,
+        .frame_format = FREESCALE,
+        .polarity = STEADY_LOW,
+        .phase = SECOND_EDGE_TRANSITION,
+        .datasize = DATASIZE_8,
+        .bitrate = SSI_LINK_DEFAULT_BITRATE,
+        .software_fss = 0
+    };
+
+    link_slave_ssi = ssi_get_handle( instance );
+    if ( !link_slave_ssi || ssi_init( link_slave_ssi, &config ) != SSI_OK )
+    {
+        link_slave_ssi = 0;
+        return SSI_LINK_INVALID_CONFIG;
+    }
+
+    // Not ready until DMA is armed
+    gpio_enable_port( ready_port );
+    link_slave_ready_gpio = gpio_get_port( ready_port );
+    link_slave_ready_pin = ready_pin;
+    gpio_write( link_slave_ready_gpio, ready_pin, 0 );
+    gpio_set_output( ready_port, ready_pin );
+
+    cycles_init();
+    udma_init();
+
+    link_rx_head = 0;
+    link_rx_tail = 0;
+    link_have_sequence = 0;
+    link_resync_pending = 0;
+
+    ssi_dma_enable( link_slave_ssi, link_slave_dma_done, 1, 0 );
+    link_start_dma();
+    link_update_ready();
+
+    return SSI_LINK_OK;
+}
+
+enum ssi_link_ret ssi_link_receive( uint8_t * payload, uint8_t * length )
+{
+    if ( link_rx_tail == link_rx_head )
+    {
+        return SSI_LINK_NO_PACKET;
+    }
+
+    struct link_slot * slot = &link_rx_slots[link_rx_tail % SSI_LINK_RX_SLOTS];
+    for ( uint8_t i = 0; i < slot->length; i++ )
+    {
+        payload[i] = slot->payload[i];
+    }
+    *length = slot->length;
+
+    uint32_t primask = critical_enter();
+    link_rx_tail++;
+    link_update_ready();
+    critical_exit( primask );
+
+    return SSI_LINK_OK;
+}
+
+void ssi_link_slave_poll( void )
+{
+    if ( !link_slave_ssi || !link_resync_pending )
+    {
+        return;
+    }
+
+    uint8_t channel = link_slave_ssi->dma_rx_channel;
+    uint16_t remaining = udma_get_remaining( channel, UDMA_PRIMARY ) + udma_get_remaining( channel, UDMA_ALTERNATE );
+    uint32_t now = cycles_now();
+
+    // READY went low when the resync was requested. Wait for the master to
+    // finish the frame it was sending
+    if ( remaining != link_quiet_remaining || (link_slave_ssi->regs->SR & SSI_SR_RNE) )
+    {
+        link_quiet_remaining = remaining;
+        link_quiet_since = now;
+        return;
+    }
+    if ( cycles_to_us( now - link_quiet_since ) < LINK_QUIET_US )
+    {
+        return;
+    }
+
+    uint32_t primask = critical_enter();
+
+    // Frame tail sitting in the partly filled block
+    enum udma_select active = link_rx_next;
+    uint16_t filled = SSI_LINK_FRAME_SIZE - udma_get_remaining( channel, active );
+    link_parse( link_rx_blocks[active], filled );
+
+    link_start_dma();
+    link_resync_pending = 0;
+    link_stats.resyncs++;
+    link_update_ready();
+
+    critical_exit( primask );
+}
+
+void ssi_link_get_stats( struct ssi_link_stats * stats )
+{
+    *stats = link_stats;
+}
@@ -2,9 +2,42 @@
 #include "util/common.h"
 #include "hal/common.h"
 #include "hal/pll.h"
+#include "hal/clock_gate.h"
+#include "hal/idle.h"
 #include "hal/ssi.h"
+#include "util/boot_time.h"
+#include "util/timebase.h"
 #include "tiva/led.h"
 #include "lcd_5110/lcd.h"
+#include "ui/anim.h"
+#include "ui/frame_pacer.h"
+#ifdef SSI_BENCH
+#include "hal/ssi_bench.h"
+#endif
+#ifdef LCD_BENCH
+#include "lcd_5110/lcd_bench.h"
+#endif
+#if defined(SSI_BENCH) || defined(LCD_BENCH)
+#include "hal/uart.h"
+#endif
+
+#define FRAMES_PER_SECOND 30U
+
+// Kept with each displayed frame, so a warm reset carries on from it
+struct ui_state
+{
+	int16_t text_y;
+	int16_t text_inverse;
+};
+
+#if defined(SSI_BENCH) || defined(LCD_BENCH)
+#define BENCH_BAUD 115200U
+
+static void bench_put(char character)
+{
+	uart0_write((uint8_t)character);
+}
+#endif
 
 /**
  * @brief Application Entry Point
@@ -13,17 +46,95 @@
  */
 int main(void)
 {
-	pll_init();
+	struct ui_state ui = {.text_y = 0, .text_inverse = 1};
+	// What the screen buffer holds, text_y -1 for nothing drawn yet
+	struct ui_state drawn = {.text_y = -1, .text_inverse = 0};
+
+	boot_time_mark(BOOT_STAGE_MAIN);
+	timebase_init(TIMEBASE_DEFAULT_TICK_HZ);
+
+	// Bring up from the crystal while the PLL locks. The drivers follow the
+	// switch to 80MHz through their clock notifiers
+	enum clockret clock_status = pll_start();
+	clock_gate_init();
+
+	// Delays from here on sleep. Light sleep only until the PLL has locked
+	idle_init();
+	idle_block_deep_sleep();
+
 	led_init();
+#ifndef SSI_BENCH
 	lcd_init();
+	boot_time_mark(BOOT_STAGE_PERIPHERALS);
+#endif
+	if (clock_status == CLOCK_OK)
+	{
+		clock_status = pll_wait();
+	}
+	idle_allow_deep_sleep();
+	boot_time_mark(BOOT_STAGE_CLOCK);
+
+	// Running slow from an oscillator, carry on and show it
+	if (clock_status != CLOCK_OK)
+	{
+		led_on(LED_RED);
+	}
+
+#ifdef SSI_BENCH
+	// Loopback benchmark of SSI0 before the LCD takes it, report on UART0
+	static struct ssi_bench_result bench_results[SSI_BENCH_RESULTS];
+	uart0_init(BENCH_BAUD);
+	ssi_bench_report(bench_results,
+		ssi_bench_run(SSI_INSTANCE_0, SSI_PINMUX_SSI0_PA2_PA5, LCD_5110_MAX_BITRATE, bench_results, SSI_BENCH_RESULTS),
+		bench_put);
+
+	lcd_init();
+	boot_time_mark(BOOT_STAGE_PERIPHERALS);
+#endif
 
-	lcd_write_row(5,20,1, "H E L L O !");
+#ifdef LCD_BENCH
+	// Screen buffer loops from flash and from SRAM, and the lcd_printf load,
+	// at 80MHz. Report on UART0
+	static struct lcd_bench_result lcd_bench_results[LCD_BENCH_LOOPS];
+	static struct lcd_bench_print_result lcd_bench_print;
+	uart0_init(BENCH_BAUD);
+	lcd_bench_run(lcd_bench_results);
+	lcd_bench_report(lcd_bench_results, bench_put);
+	lcd_bench_print_run(&lcd_bench_print);
+	lcd_bench_print_report(&lcd_bench_print, bench_put);
+#endif
 
-	lcd_display();
+	// After a warm reset pick up from the frame on the panel
+	lcd_get_ui_state(&ui, sizeof(ui));
+	lcd_set_ui_state(&ui, sizeof(ui));
+
+	// Slide the greeting down then blink it
+	anim_start(&ui.text_y, ui.text_y, 20, 1000, ANIM_EASE_OUT_QUAD, ANIM_FLAG_NONE);
+	anim_start(&ui.text_inverse, 1, 0, 500, ANIM_EASE_STEP, ANIM_FLAG_LOOP | ANIM_FLAG_PINGPONG);
+
+	// Sleep between frames
+	frame_pacer_init(FRAMES_PER_SECOND);
 
 	while (1)
-	{	
+	{
+		anim_update(frame_pacer_begin());
+
+		// Redraw only when the greeting moved or blinked, so lcd_display_dirty
+		// sends just the banks it covers
+		if (ui.text_y != drawn.text_y || ui.text_inverse != drawn.text_inverse)
+		{
+			if (drawn.text_y >= 0)
+			{
+				lcd_write_row(0, (uint8_t)drawn.text_y, 0, "");
+			}
+			lcd_write_row(5, (uint8_t)ui.text_y, (uint8_t)ui.text_inverse, "H E L L O !");
+			drawn = ui;
+		}
+		lcd_display_dirty();
+		boot_time_mark(BOOT_STAGE_FIRST_FRAME);
+
+		frame_pacer_end();
 	}
 
 	return 0;
-}
+}
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include <stdint.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/common.h"
+#include "hal/gpio.h"
+#include "hal/ssi.h"
+#include "hal/udma.h"
+#include "spi_nor/spi_nor.h"
+#include "util/cycles.h"
+
+#define SPI_NOR_CMD_WRITE_ENABLE 0x06U
+#define SPI_NOR_CMD_READ_STATUS 0x05U
+#define SPI_NOR_CMD_FAST_READ 0x0BU
+#define SPI_NOR_CMD_PAGE_PROGRAM 0x02U
+#define SPI_NOR_CMD_SECTOR_ERASE 0x20U
+#define SPI_NOR_CMD_READ_ID 0x9FU
+#define SPI_NOR_CMD_RELEASE_POWER_DOWN 0xABU
+
+#define SPI_NOR_STATUS_BUSY 0x01U
+
+// Command byte plus 3 address bytes, fast read adds a dummy byte
+#define SPI_NOR_ADDRESS_COMMAND_SIZE 4U
+#define SPI_NOR_FAST_READ_COMMAND_SIZE 5U
+
+// Capacity byte of the JEDEC ID is log2 of the size. 3 byte addressing
+// reaches 16MB
+#define SPI_NOR_MIN_CAPACITY 16U
+#define SPI_NOR_MAX_CAPACITY 24U
+
+// Wake up time after release from power down, tRES1
+#define SPI_NOR_WAKE_US 30U
+
+#define SPI_NOR_DMA_RX_CONTROL (UDMA_PERIPHERAL_TO_MEMORY_8 | UDMA_CHCTL_ARBSIZE_4 | UDMA_CHCTL_XFERMODE_BASIC)
+#define SPI_NOR_DMA_TX_CONTROL (UDMA_FIXED_TO_PERIPHERAL_8 | UDMA_CHCTL_ARBSIZE_4 | UDMA_CHCTL_XFERMODE_BASIC)
+
+// Largest data phase handed to ssi_transfer at once
+#define SPI_NOR_TRANSFER_CHUNK 0x8000U
+
+// Clocked out by the TX channel during DMA reads
+static const uint8_t spi_nor_fill = SSI_READ_FILL;
+
+// Device using each SSI module, for the DMA completion callback
+static struct spi_nor * spi_nor_devices[SSI_INSTANCES] = {0};
+
+static void spi_nor_select( struct spi_nor * nor )
+{
+    gpio_write( nor->cs_gpio, nor->cs_pin, 0 );
+}
+
+static void spi_nor_deselect( struct spi_nor * nor )
+{
+    gpio_write( nor->cs_gpio, nor->cs_pin, 1 );
+}
+
+/**
+ * @brief   Run a whole command with the chip selected
+ *
+ * @param nor Device
+ * @param command Command, address and dummy bytes
+ * @param command_size Number of command bytes
+ * @param tx Data phase bytes to send, NULL when reading
+ * @param rx Data phase storage, NULL when writing
+ * @param length Data phase length
+ */
+static void spi_nor_command( struct spi_nor * nor, const uint8_t * command, uint8_t command_size,
+                             const uint8_t * tx, uint8_t * rx, uint32_t length )
+{
+    spi_nor_select( nor );
+    ssi_transfer( nor->ssi, command, 0, command_size );
+
+    while ( length )
+    {
+        uint16_t chunk = (length > SPI_NOR_TRANSFER_CHUNK) ? SPI_NOR_TRANSFER_CHUNK : (uint16_t)length;
+
+        ssi_transfer( nor->ssi, tx, rx, chunk );
+        tx = tx ? tx + chunk : 0;
+        rx = rx ? rx + chunk : 0;
+        length -= chunk;
+    }
+
+    spi_nor_deselect( nor );
+}
+
+static void spi_nor_address_command( uint8_t * command, uint8_t opcode, uint32_t address )
+{
+    command[0] = opcode;
+    command[1] = (uint8_t)(address >> 16U);
+    command[2] = (uint8_t)(address >> 8U);
+    command[3] = (uint8_t)address;
+}
+
+static uint8_t spi_nor_read_status( struct spi_nor * nor )
+{
+    const uint8_t command = SPI_NOR_CMD_READ_STATUS;
+    uint8_t status = 0;
+
+    spi_nor_command( nor, &command, 1, 0, &status, 1 );
+    return status;
+}
+
+static enum spi_nor_ret spi_nor_wait_ready( struct spi_nor * nor, uint32_t timeout_us )
+{
+    uint32_t start = cycles_now();
+
+    while ( spi_nor_read_status( nor ) & SPI_NOR_STATUS_BUSY )
+    {
+        if ( cycles_to_us( cycles_now() - start ) > timeout_us )
+        {
+            return SPI_NOR_TIMEOUT;
+        }
+    }
+    return SPI_NOR_OK;
+}
+
+static void spi_nor_write_enable( struct spi_nor * nor )
+{
+    const uint8_t command = SPI_NOR_CMD_WRITE_ENABLE;
+
+    spi_nor_command( nor, &command, 1, 0, 0, 0 );
+}
+
+static enum spi_nor_ret spi_nor_check_range( struct spi_nor * nor, uint32_t address, uint32_t length )
+{
+    if ( nor->dma_busy )
+    {
+        return SPI_NOR_BUSY;
+    }
+    if ( address >= nor->size || length > (nor->size - address) )
+    {
+        return SPI_NOR_OUT_OF_RANGE;
+    }
+    return SPI_NOR_OK;
+}
+
+enum spi_nor_ret spi_nor_init( struct spi_nor * nor, const struct spi_nor_config * config )
+{
+    const struct ssi_config ssi_config =
+    {
+        .pins = config->pins,
+        .mode = SSI_MODE_MASTER,
+        .frame_format = FREESCALE,
+        .polarity = STEADY_LOW,
+        .phase = FIRST_EDGE_TRANSITION,
+        .datasize = DATASIZE_8,
+        .bitrate = config->bitrate,
+        .software_fss = 1
+    };
+
+    nor->ssi = ssi_get_handle( config->instance );
+    if ( !nor->ssi || ssi_init( nor->ssi, &ssi_config ) != SSI_OK )
+    {
+        return SPI_NOR_INVALID_CONFIG;
+    }
+
+    // Deselected before the pin becomes an output
+    gpio_enable_port( config->cs_port );
+    nor->cs_gpio = gpio_get_port( config->cs_port );
+    nor->cs_pin = config->cs_pin;
+    spi_nor_deselect( nor );
+    gpio_set_output( config->cs_port, config->cs_pin );
+
+    nor->dma_busy = 0;
+    nor->size = 0;
+    spi_nor_devices[config->instance] = nor;
+
+    cycles_init();
+    udma_init();
+
+    // The part may have been left in deep power down
+    const uint8_t wake = SPI_NOR_CMD_RELEASE_POWER_DOWN;
+    spi_nor_command( nor, &wake, 1, 0, 0, 0 );
+    uint32_t start = cycles_now();
+    while ( cycles_to_us( cycles_now() - start ) < SPI_NOR_WAKE_US );
+
+    const uint8_t read_id = SPI_NOR_CMD_READ_ID;
+    uint8_t id[3] = {0};
+    spi_nor_command( nor, &read_id, 1, 0, id, sizeof(id) );
+    nor->jedec_id = ((uint32_t)id[0] << 16U) | ((uint32_t)id[1] << 8U) | id[2];
+
+    // Floating MISO reads as all ones, a missing pull up as all zeros
+    if ( nor->jedec_id == 0 || nor->jedec_id == 0xFFFFFFUL || id[2] < SPI_NOR_MIN_CAPACITY )
+    {
+        return SPI_NOR_NOT_FOUND;
+    }
+
+    nor->size = 1UL << ((id[2] > SPI_NOR_MAX_CAPACITY) ? SPI_NOR_MAX_CAPACITY : id[2]);
+
+    return SPI_NOR_OK;
+}
+
+enum spi_nor_ret spi_nor_read( struct spi_nor * nor, uint32_t address, uint8_t * data, uint32_t length )
+{
+    enum spi_nor_ret ret = spi_nor_check_range( nor, address, length );
+    if ( ret != SPI_NOR_OK )
+    {
+        return ret;
+    }
+
+    uint8_t command[SPI_NOR_FAST_READ_COMMAND_SIZE];
+    spi_nor_address_command( command, SPI_NOR_CMD_FAST_READ, address );
+    command[4] = SSI_READ_FILL;
+
+    spi_nor_command( nor, command, sizeof(command), 0, data, length );
+
+    return SPI_NOR_OK;
+}
+
+/**
+ * @brief   Arm both channels for the next part of a DMA read
+ *
+ */
+static void spi_nor_dma_start_chunk( struct spi_nor * nor )
+{
+    struct ssi_handle * ssi = nor->ssi;
+    uint16_t count = (nor->dma_remaining > UDMA_MAX_TRANSFER) ? UDMA_MAX_TRANSFER : (uint16_t)nor->dma_remaining;
+
+    udma_set_transfer( ssi->dma_rx_channel, UDMA_PRIMARY, SPI_NOR_DMA_RX_CONTROL,
+                       &ssi->regs->DR, nor->dma_dst, count );
+    udma_set_transfer( ssi->dma_tx_channel, UDMA_PRIMARY, SPI_NOR_DMA_TX_CONTROL,
+                       (volatile uint8_t *)&spi_nor_fill, &ssi->regs->DR, count );
+
+    nor->dma_dst += count;
+    nor->dma_remaining -= count;
+
+    // RX first so the first fill byte's reply has somewhere to go
+    udma_enable( ssi->dma_rx_channel );
+    udma_enable( ssi->dma_tx_channel );
+}
+
+static void spi_nor_dma_done( struct ssi_handle * ssi, enum ssi_event event )
+{
+    struct spi_nor * nor = spi_nor_devices[ssi->instance];
+
+    // TX finishes first, the read is over once the last byte is received
+    if ( event != SSI_EVENT_DMA_RX_DONE || !nor || !nor->dma_busy )
+    {
+        return;
+    }
+
+    if ( nor->dma_remaining )
+    {
+        // The clock pauses between chunks, the part doesn't mind
+        spi_nor_dma_start_chunk( nor );
+        return;
+    }
+
+    ssi_dma_disable( ssi );
+    spi_nor_deselect( nor );
+    nor->dma_busy = 0;
+
+    if ( nor->dma_callback )
+    {
+        nor->dma_callback( nor );
+    }
+}
+
+enum spi_nor_ret spi_nor_read_dma( struct spi_nor * nor, uint32_t address, uint8_t * data, uint32_t length,
+                                   spi_nor_callback callback )
+{
+    enum spi_nor_ret ret = spi_nor_check_range( nor, address, length );
+    if ( ret != SPI_NOR_OK || length == 0 )
+    {
+        return ret;
+    }
+
+    uint8_t command[SPI_NOR_FAST_READ_COMMAND_SIZE];
+    spi_nor_address_command( command, SPI_NOR_CMD_FAST_READ, address );
+    command[4] = SSI_READ_FILL;
+
+    nor->dma_busy = 1;
+    nor->dma_dst = data;
+    nor->dma_remaining = length;
+    nor->dma_callback = callback;
+
+    // Command phase polled, the chip stays selected for the data phase
+    spi_nor_select( nor );
+    ssi_transfer( nor->ssi, command, 0, sizeof(command) );
+
+    ssi_dma_enable( nor->ssi, spi_nor_dma_done, 1, 1 );
+    // The TX channel must never get far enough ahead to overrun the RX FIFO
+    udma_set_high_priority( nor->ssi->dma_rx_channel );
+    spi_nor_dma_start_chunk( nor );
+
+    return SPI_NOR_OK;
+}
+
+uint8_t spi_nor_dma_busy( struct spi_nor * nor )
+{
+    return nor->dma_busy;
+}
+
+void spi_nor_dma_wait( struct spi_nor * nor )
+{
+    while ( nor->dma_busy );
+}
+
+enum spi_nor_ret spi_nor_program( struct spi_nor * nor, uint32_t address, const uint8_t * data, uint32_t length )
+{
+    enum spi_nor_ret ret = spi_nor_check_range( nor, address, length );
+
+    while ( ret == SPI_NOR_OK && length )
+    {
+        // A page program wraps within its page, so stop at the boundary
+        uint32_t room = SPI_NOR_PAGE_SIZE - (address % SPI_NOR_PAGE_SIZE);
+        uint32_t chunk = (length < room) ? length : room;
+        uint8_t command[SPI_NOR_ADDRESS_COMMAND_SIZE];
+
+        spi_nor_address_command( command, SPI_NOR_CMD_PAGE_PROGRAM, address );
+        spi_nor_write_enable( nor );
+        spi_nor_command( nor, command, sizeof(command), data, 0, chunk );
+        ret = spi_nor_wait_ready( nor, SPI_NOR_PAGE_PROGRAM_TIMEOUT_US );
+
+        address += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+
+    return ret;
+}
+
+enum spi_nor_ret spi_nor_erase_sector( struct spi_nor * nor, uint32_t address )
+{
+    enum spi_nor_ret ret = spi_nor_check_range( nor, address, 1 );
+    if ( ret != SPI_NOR_OK )
+    {
+        return ret;
+    }
+
+    uint8_t command[SPI_NOR_ADDRESS_COMMAND_SIZE];
+    spi_nor_address_command( command, SPI_NOR_CMD_SECTOR_ERASE, address & ~(SPI_NOR_SECTOR_SIZE - 1U) );
+
+    spi_nor_write_enable( nor );
+    spi_nor_command( nor, command, sizeof(command), 0, 0, 0 );
+
+    return spi_nor_wait_ready( nor, SPI_NOR_SECTOR_ERASE_TIMEOUT_US );
+}
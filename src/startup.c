@@ -24,6 +24,8 @@
 
 #include <stdint.h>
 
+#include "util/timebase.h"
+
 //*****************************************************************************
 //
 // Forward declaration of the default fault handlers.
@@ -58,6 +60,19 @@ static uint32_t pui32Stack[128];
 //
 //*****************************************************************************
 // To be added by user
+extern void SysTickIntHandler(void);
+extern void SSI0IntHandler(void);
+extern void SSI1IntHandler(void);
+extern void SSI2IntHandler(void);
+extern void SSI3IntHandler(void);
+extern void Timer0AIntHandler(void);
+extern void Timer1AIntHandler(void);
+extern void Timer2AIntHandler(void);
+extern void Timer3AIntHandler(void);
+extern void Timer4AIntHandler(void);
+extern void Timer5AIntHandler(void);
+extern void UDMAIntHandler(void);
+extern void UDMAErrorIntHandler(void);
 
 //*****************************************************************************
 //
@@ -85,7 +100,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // Debug monitor handler
     0,                                      // Reserved
     IntDefaultHandler,                      // The PendSV handler
-    IntDefaultHandler,                      // The SysTick handler
+    SysTickIntHandler,                      // The SysTick handler
     IntDefaultHandler,                      // GPIO Port A
     IntDefaultHandler,                      // GPIO Port B
     IntDefaultHandler,                      // GPIO Port C
@@ -93,7 +108,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port E
     IntDefaultHandler,                      // UART0 Rx and Tx
     IntDefaultHandler,                      // UART1 Rx and Tx
-    IntDefaultHandler,                      // SSI0 Rx and Tx
+    SSI0IntHandler,                         // SSI0 Rx and Tx
     IntDefaultHandler,                      // I2C0 Master and Slave
     IntDefaultHandler,                      // PWM Fault
     IntDefaultHandler,                      // PWM Generator 0
@@ -105,11 +120,11 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // ADC Sequence 2
     IntDefaultHandler,                      // ADC Sequence 3
     IntDefaultHandler,                      // Watchdog timer
-    IntDefaultHandler,                      // Timer 0 subtimer A
+    Timer0AIntHandler,                      // Timer 0 subtimer A
     IntDefaultHandler,                      // Timer 0 subtimer B
-    IntDefaultHandler,                      // Timer 1 subtimer A
+    Timer1AIntHandler,                      // Timer 1 subtimer A
     IntDefaultHandler,                      // Timer 1 subtimer B
-    IntDefaultHandler,                      // Timer 2 subtimer A
+    Timer2AIntHandler,                      // Timer 2 subtimer A
     IntDefaultHandler,                      // Timer 2 subtimer B
     IntDefaultHandler,                      // Analog Comparator 0
     IntDefaultHandler,                      // Analog Comparator 1
@@ -120,8 +135,8 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port G
     IntDefaultHandler,                      // GPIO Port H
     IntDefaultHandler,                      // UART2 Rx and Tx
-    IntDefaultHandler,                      // SSI1 Rx and Tx
-    IntDefaultHandler,                      // Timer 3 subtimer A
+    SSI1IntHandler,                         // SSI1 Rx and Tx
+    Timer3AIntHandler,                      // Timer 3 subtimer A
     IntDefaultHandler,                      // Timer 3 subtimer B
     IntDefaultHandler,                      // I2C1 Master and Slave
     IntDefaultHandler,                      // Quadrature Encoder 1
@@ -132,8 +147,8 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // Hibernate
     IntDefaultHandler,                      // USB0
     IntDefaultHandler,                      // PWM Generator 3
-    IntDefaultHandler,                      // uDMA Software Transfer
-    IntDefaultHandler,                      // uDMA Error
+    UDMAIntHandler,                         // uDMA Software Transfer
+    UDMAErrorIntHandler,                    // uDMA Error
     IntDefaultHandler,                      // ADC1 Sequence 0
     IntDefaultHandler,                      // ADC1 Sequence 1
     IntDefaultHandler,                      // ADC1 Sequence 2
@@ -143,8 +158,8 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port J
     IntDefaultHandler,                      // GPIO Port K
     IntDefaultHandler,                      // GPIO Port L
-    IntDefaultHandler,                      // SSI2 Rx and Tx
-    IntDefaultHandler,                      // SSI3 Rx and Tx
+    SSI2IntHandler,                         // SSI2 Rx and Tx
+    SSI3IntHandler,                         // SSI3 Rx and Tx
     IntDefaultHandler,                      // UART3 Rx and Tx
     IntDefaultHandler,                      // UART4 Rx and Tx
     IntDefaultHandler,                      // UART5 Rx and Tx
@@ -156,7 +171,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     IntDefaultHandler,                      // I2C2 Master and Slave
     IntDefaultHandler,                      // I2C3 Master and Slave
-    IntDefaultHandler,                      // Timer 4 subtimer A
+    Timer4AIntHandler,                      // Timer 4 subtimer A
     IntDefaultHandler,                      // Timer 4 subtimer B
     0,                                      // Reserved
     0,                                      // Reserved
@@ -178,7 +193,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     0,                                      // Reserved
     0,                                      // Reserved
-    IntDefaultHandler,                      // Timer 5 subtimer A
+    Timer5AIntHandler,                      // Timer 5 subtimer A
     IntDefaultHandler,                      // Timer 5 subtimer B
     IntDefaultHandler,                      // Wide Timer 0 subtimer A
     IntDefaultHandler,                      // Wide Timer 0 subtimer B
@@ -237,6 +252,9 @@ void (* const g_pfnVectors[])(void) =
 extern uint32_t __data_load__;
 extern uint32_t __data_start__;
 extern uint32_t __data_end__;
+extern uint32_t __ramfunc_load__;
+extern uint32_t __ramfunc_start__;
+extern uint32_t __ramfunc_end__;
 extern uint32_t __bss_start__;
 extern uint32_t __bss_end__;
 
@@ -255,6 +273,12 @@ ResetISR(void)
 {
     uint32_t *pui32Src, *pui32Dest;
 
+    //
+    // Start the timebase, timing the boot from here.  Touches no variables,
+    // so it can run before the data and bss segments are set up.
+    //
+    timebase_start();
+
     //
     // Copy the data segment initializers from flash to SRAM.
     //
@@ -265,7 +289,17 @@ ResetISR(void)
     }
 
     //
-    // Zero fill the bss segment.
+    // Copy the functions that run from SRAM.
+    //
+    pui32Src = &__ramfunc_load__;
+    for(pui32Dest = &__ramfunc_start__; pui32Dest < &__ramfunc_end__; )
+    {
+        *pui32Dest++ = *pui32Src++;
+    }
+
+    //
+    // Zero fill the bss segment.  The .noinit segment is placed after it and
+    // is deliberately left alone so its contents survive a warm reset.
     //
     __asm("    ldr     r0, =__bss_start__\n"
           "    ldr     r1, =__bss_end__\n"
@@ -1,21 +1,19 @@
 #include "tiva/led.h"
 #include "util/common.h"
 #include "hal/common.h"
+#include "hal/delay.h"
 
-void led_init(void)
-{
-    // Enable clock for Port
-    SYSCTL_RCGCGPIO_R |= PORT_F;
-
-    // Use High Performance Bus
-    SYSCTL_GPIOHBCTL_R |= PORT_F;
+#define FLASH_HALF_PERIOD_MS 125U
+#define FLASH_HALF_PERIOD_NS (FLASH_HALF_PERIOD_MS * 1000000ULL)
 
-    __asm("NOP\n");
+// LED blinking in the background and the on and off steps it has left
+static enum led led_blink_led;
+static volatile uint16_t led_blink_steps = 0;
 
-    // GPIO Software Reset Register. Wait till reset flag cleared
-    while (!(SYSCTL_PRGPIO_R & PORT_F))
-    {
-    }
+void led_init(void)
+{
+    // Enable clock and High Performance Bus, wait till ready
+    gpio_enable_port(PORT_F);
 
     // Set Direction
     GPIO_PORTF_AHB_DIR_R |= LED_BLUE | LED_GREEN | LED_RED;
@@ -48,9 +46,9 @@ void led_flash(enum led led, uint8_t flashes)
     while (flashes)
     {
         GPIO_PORTF_AHB_DATA_BITS_R[led] = led;
-        delay(1);
+        delay_sleep_ms(FLASH_HALF_PERIOD_MS);
         GPIO_PORTF_AHB_DATA_BITS_R[led] = 0;
-        delay(1);
+        delay_sleep_ms(FLASH_HALF_PERIOD_MS);
         flashes--;
     }
 }
@@ -61,12 +59,47 @@ void led_flash_multi(enum led led, enum led led2, uint8_t flashes)
     {
         GPIO_PORTF_AHB_DATA_BITS_R[led] = led;
         GPIO_PORTF_AHB_DATA_BITS_R[led2] = 0;
-        delay(1);
+        delay_sleep_ms(FLASH_HALF_PERIOD_MS);
         GPIO_PORTF_AHB_DATA_BITS_R[led] = 0;
         GPIO_PORTF_AHB_DATA_BITS_R[led2] = led2;
-        delay(1);
+        delay_sleep_ms(FLASH_HALF_PERIOD_MS);
         flashes--;
     }
     GPIO_PORTF_AHB_DATA_BITS_R[led] = 0;
     GPIO_PORTF_AHB_DATA_BITS_R[led2] = 0;
+}
+
+static void led_blink_step(void *context)
+{
+    (void)context;
+
+    GPIO_PORTF_AHB_DATA_BITS_R[led_blink_led] ^= led_blink_led;
+    led_blink_steps--;
+
+    if (led_blink_steps && delay_start(FLASH_HALF_PERIOD_NS, led_blink_step, 0, 0) != DELAY_OK)
+    {
+        led_blink_steps = 0;
+        led_off(led_blink_led);
+    }
+}
+
+uint8_t led_blink(enum led led, uint8_t flashes)
+{
+    if (led_blink_steps || !flashes)
+    {
+        return 0;
+    }
+
+    led_blink_led = led;
+    led_blink_steps = (uint16_t)(flashes * 2U) - 1U;
+    led_on(led);
+
+    if (delay_start(FLASH_HALF_PERIOD_NS, led_blink_step, 0, 0) != DELAY_OK)
+    {
+        led_blink_steps = 0;
+        led_off(led);
+        return 0;
+    }
+
+    return 1;
 }
\ No newline at end of file
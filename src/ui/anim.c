@@ -0,0 +1,179 @@
+#include <stdint.h>
+
+#include "ui/anim.h"
+
+#define HALF (ANIM_Q16_ONE / 2)
+
+struct anim_tween
+{
+    int16_t *property;
+    int16_t from;
+    int16_t to;
+    uint32_t duration_us;
+    uint32_t elapsed_us;
+    enum anim_easing easing;
+    uint8_t flags;
+    uint8_t running;
+};
+
+static struct anim_tween anim_tweens[ANIM_MAX_TWEENS];
+
+static inline int32_t anim_q16_mul(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) >> 16);
+}
+
+int32_t anim_ease(enum anim_easing easing, int32_t t)
+{
+    if (t <= 0)
+    {
+        return 0;
+    }
+    if (t >= ANIM_Q16_ONE)
+    {
+        return ANIM_Q16_ONE;
+    }
+
+    switch (easing)
+    {
+    case ANIM_EASE_IN_QUAD:
+        return anim_q16_mul(t, t);
+
+    case ANIM_EASE_OUT_QUAD:
+    {
+        int32_t inverse = ANIM_Q16_ONE - t;
+        return ANIM_Q16_ONE - anim_q16_mul(inverse, inverse);
+    }
+
+    case ANIM_EASE_IN_OUT_CUBIC:
+        if (t < HALF)
+        {
+            // 4t^3
+            return 4 * anim_q16_mul(anim_q16_mul(t, t), t);
+        }
+        else
+        {
+            // 1 - (2 - 2t)^3 / 2
+            int32_t inverse = 2 * (ANIM_Q16_ONE - t);
+            return ANIM_Q16_ONE - (anim_q16_mul(anim_q16_mul(inverse, inverse), inverse) / 2);
+        }
+
+    case ANIM_EASE_STEP:
+        return 0;
+
+    case ANIM_EASE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+int8_t anim_start(int16_t *property, int16_t from, int16_t to, uint16_t duration_ms,
+                  enum anim_easing easing, uint8_t flags)
+{
+    if (!property)
+    {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++)
+    {
+        if (anim_tweens[i].running)
+        {
+            continue;
+        }
+
+        anim_tweens[i].property = property;
+        anim_tweens[i].from = from;
+        anim_tweens[i].to = to;
+        // Zero length tweens finish on the first update
+        anim_tweens[i].duration_us = duration_ms ? ((uint32_t)duration_ms * 1000UL) : 1U;
+        anim_tweens[i].elapsed_us = 0;
+        anim_tweens[i].easing = easing;
+        anim_tweens[i].flags = flags;
+        anim_tweens[i].running = 1;
+
+        *property = from;
+        return (int8_t)i;
+    }
+
+    return -1;
+}
+
+void anim_stop(int8_t handle)
+{
+    if (handle >= 0 && (uint8_t)handle < ANIM_MAX_TWEENS)
+    {
+        anim_tweens[handle].running = 0;
+    }
+}
+
+void anim_stop_property(int16_t *property)
+{
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++)
+    {
+        if (anim_tweens[i].property == property)
+        {
+            anim_tweens[i].running = 0;
+        }
+    }
+}
+
+uint8_t anim_is_running(int8_t handle)
+{
+    if (handle < 0 || (uint8_t)handle >= ANIM_MAX_TWEENS)
+    {
+        return 0;
+    }
+    return anim_tweens[handle].running;
+}
+
+uint8_t anim_update(uint32_t elapsed_us)
+{
+    uint8_t running = 0;
+
+    for (uint8_t i = 0; i < ANIM_MAX_TWEENS; i++)
+    {
+        struct anim_tween *tween = &anim_tweens[i];
+        if (!tween->running)
+        {
+            continue;
+        }
+
+        tween->elapsed_us += elapsed_us;
+
+        if (tween->elapsed_us >= tween->duration_us)
+        {
+            if (!(tween->flags & ANIM_FLAG_LOOP))
+            {
+                *tween->property = tween->to;
+                tween->running = 0;
+                continue;
+            }
+
+            // Keep the overshoot so looping tweens don't drift
+            tween->elapsed_us %= tween->duration_us;
+            if (tween->flags & ANIM_FLAG_PINGPONG)
+            {
+                int16_t swap = tween->from;
+                tween->from = tween->to;
+                tween->to = swap;
+            }
+            else if (tween->easing == ANIM_EASE_STEP)
+            {
+                // A looping step tween would never show 'to' otherwise
+                *tween->property = tween->to;
+                running++;
+                continue;
+            }
+        }
+
+        int32_t t = (int32_t)(((uint64_t)tween->elapsed_us << 16) / tween->duration_us);
+        int32_t eased = anim_ease(tween->easing, t);
+        int32_t delta = (int32_t)tween->to - tween->from;
+
+        *tween->property = (int16_t)(tween->from + anim_q16_mul(delta, eased));
+        running++;
+    }
+
+    return running;
+}
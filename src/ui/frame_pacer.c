@@ -0,0 +1,113 @@
+#include <stdint.h>
+
+#include "ui/frame_pacer.h"
+#include "util/timebase.h"
+#include "hal/idle.h"
+
+#define FRAME_US_PER_SECOND 1000000UL
+
+// Paced and measured on the timebase, which keeps counting PIOSC through
+// clock switches, so nothing here needs rescaling when the clock changes
+static uint16_t frame_fps = 1;
+static uint32_t frame_period_us = 0;
+// Microseconds of 1/fps left over each period, carried so the rate is exact
+static uint16_t frame_period_remainder = 0;
+static uint16_t frame_fraction = 0;
+static uint64_t frame_deadline = 0;
+static uint64_t frame_begin = 0;
+static uint64_t frame_previous_begin = 0;
+
+static uint32_t frame_count = 0;
+static uint32_t frame_dropped = 0;
+static uint32_t frame_min_us = 0;
+static uint32_t frame_max_us = 0;
+static uint64_t frame_total_us = 0;
+
+void frame_pacer_init(uint16_t fps)
+{
+    if (fps == 0)
+    {
+        fps = 1;
+    }
+
+    frame_fps = fps;
+    frame_period_us = FRAME_US_PER_SECOND / fps;
+    frame_period_remainder = (uint16_t)(FRAME_US_PER_SECOND % fps);
+    frame_fraction = 0;
+    frame_deadline = timebase_now_us();
+    frame_previous_begin = frame_deadline;
+
+    frame_pacer_reset_stats();
+}
+
+uint32_t frame_pacer_begin(void)
+{
+    uint32_t remaining;
+
+    // Sleep until the slot
+    while ((remaining = timebase_remaining_us(frame_deadline)))
+    {
+        idle_wait(remaining);
+    }
+
+    uint64_t now = timebase_now_us();
+    uint64_t late = now - frame_deadline;
+
+    if (late >= frame_period_us)
+    {
+        // Overran one or more whole slots. Skip them instead of trying to catch up
+        uint64_t missed = late / frame_period_us;
+        frame_dropped += (uint32_t)missed;
+        frame_deadline += missed * frame_period_us;
+    }
+
+    frame_deadline += frame_period_us;
+    frame_fraction += frame_period_remainder;
+    if (frame_fraction >= frame_fps)
+    {
+        frame_fraction -= frame_fps;
+        frame_deadline++;
+    }
+
+    uint64_t elapsed = now - frame_previous_begin;
+    frame_previous_begin = now;
+    frame_begin = now;
+
+    return (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed;
+}
+
+void frame_pacer_end(void)
+{
+    uint64_t elapsed = timebase_now_us() - frame_begin;
+    uint32_t duration = (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed;
+
+    if (frame_count == 0 || duration < frame_min_us)
+    {
+        frame_min_us = duration;
+    }
+    if (duration > frame_max_us)
+    {
+        frame_max_us = duration;
+    }
+    frame_total_us += duration;
+    frame_count++;
+}
+
+void frame_pacer_get_stats(struct frame_pacer_stats *stats)
+{
+    stats->frames = frame_count;
+    stats->dropped = frame_dropped;
+    stats->min_us = frame_min_us;
+    stats->max_us = frame_max_us;
+    stats->avg_us = frame_count ? (uint32_t)(frame_total_us / frame_count) : 0;
+    stats->period_us = frame_period_us;
+}
+
+void frame_pacer_reset_stats(void)
+{
+    frame_count = 0;
+    frame_dropped = 0;
+    frame_min_us = 0;
+    frame_max_us = 0;
+    frame_total_us = 0;
+}
@@ -0,0 +1,24 @@
+#include <stdint.h>
+
+#include "util/boot_time.h"
+#include "util/timebase.h"
+
+static uint32_t boot_times[BOOT_STAGES] = {0};
+
+void boot_time_mark( enum boot_stage stage )
+{
+    if ( stage >= BOOT_STAGES || boot_times[stage] )
+    {
+        return;
+    }
+
+    uint32_t us = (uint32_t)timebase_now_us();
+
+    // 0 means not reached
+    boot_times[stage] = us ? us : 1U;
+}
+
+uint32_t boot_time_get( enum boot_stage stage )
+{
+    return (stage < BOOT_STAGES) ? boot_times[stage] : 0;
+}
@@ -21,23 +21,6 @@ unsigned char common_reverse_bits_lookup[16] =
     0b1111
 };
 
-void delay(volatile unsigned long eigths)
-{
-	volatile unsigned long count;
-
-	eigths *= 2UL;
-
-	while (eigths > 0)
-	{					 
-		count = 197238UL;
-		while (count > 0)
-		{
-			count--;
-		}
-		eigths--;
-	}
-}
-
 uint8_t reverse_bits( uint8_t byte )
 {
 	uint8_t reversed = 0;
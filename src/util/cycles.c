@@ -0,0 +1,13 @@
+#include <stdint.h>
+
+#include "util/cycles.h"
+#include "hal/tm4c123gh6pm.h"
+
+void cycles_init( void )
+{
+    // Trace must be enabled before the DWT registers can be written
+    NVIC_DBG_INT_R |= NVIC_DBG_INT_TRCENA;
+
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+}
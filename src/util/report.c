@@ -0,0 +1,51 @@
+#include <stdint.h>
+
+#include "util/report.h"
+
+// Digits of UINT32_MAX
+#define REPORT_UINT32_DIGITS 10U
+
+void report_put_string( report_put put, const char * string, uint8_t width )
+{
+    uint8_t length = 0;
+
+    while ( *string )
+    {
+        put( *string++ );
+        if ( length < width )
+        {
+            length++;
+        }
+    }
+    while ( length++ < width )
+    {
+        put( ' ' );
+    }
+}
+
+void report_put_uint( report_put put, uint32_t value, uint8_t width )
+{
+    char digits[REPORT_UINT32_DIGITS];
+    uint8_t count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + (value % 10U));
+        value /= 10U;
+    } while ( value );
+
+    while ( width-- > count )
+    {
+        put( ' ' );
+    }
+    while ( count )
+    {
+        put( digits[--count] );
+    }
+}
+
+void report_put_line_end( report_put put )
+{
+    put( '\r' );
+    put( '\n' );
+}
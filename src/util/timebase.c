@@ -0,0 +1,160 @@
+#include <stdint.h>
+
+#include "util/timebase.h"
+#include "util/critical.h"
+#include "hal/tm4c123gh6pm.h"
+#include "hal/idle.h"
+
+// SysTick clocks up to the start of the current tick
+static volatile uint64_t timebase_base = 0;
+// Free running from timebase_start until timebase_init
+static uint32_t timebase_reload = NVIC_ST_RELOAD_M;
+static uint32_t timebase_ctrl = NVIC_ST_CTRL_ENABLE;
+
+void SysTickIntHandler( void )
+{
+    timebase_base += timebase_reload + 1U;
+}
+
+/**
+ * @brief   SysTick clocks since reset. Interrupts must be masked
+ *
+ */
+static uint64_t timebase_clocks( void )
+{
+    uint64_t base = timebase_base;
+    uint32_t current = NVIC_ST_CURRENT_R & NVIC_ST_CURRENT_M;
+
+    if ( NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET )
+    {
+        // Wrapped and the interrupt hasn't run yet, the count read may be
+        // from before the wrap
+        base += timebase_reload + 1U;
+        current = NVIC_ST_CURRENT_R & NVIC_ST_CURRENT_M;
+    }
+
+    // The tick is raised as the counter reaches 0, reload follows
+    return base + (current ? (timebase_reload + 1U - current) : 0U);
+}
+
+/**
+ * @brief   Stop SysTick and fold the count into the base. Interrupts must be
+ *          masked
+ *
+ */
+static void timebase_stop( void )
+{
+    NVIC_ST_CTRL_R = 0;
+    timebase_base = timebase_clocks();
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PENDSTCLR;
+    NVIC_ST_CURRENT_R = 0;
+}
+
+void timebase_start( void )
+{
+    // Down from the top, CLK_SRC clear for PIOSC / 4 and no interrupt
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = NVIC_ST_RELOAD_M;
+    NVIC_ST_CURRENT_R = 0;
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_ENABLE;
+}
+
+enum timebaseret timebase_init( uint32_t tick_hz )
+{
+    if ( tick_hz == 0 || (TIMEBASE_CLOCK_HZ % tick_hz) || (TIMEBASE_CLOCK_HZ / tick_hz) > (NVIC_ST_RELOAD_M + 1U) )
+    {
+        return TIMEBASE_INVALID_CONFIG;
+    }
+
+    uint32_t primask = critical_enter();
+
+    timebase_stop();
+
+    timebase_reload = (TIMEBASE_CLOCK_HZ / tick_hz) - 1U;
+    timebase_ctrl = NVIC_ST_CTRL_ENABLE | NVIC_ST_CTRL_INTEN;
+    NVIC_ST_RELOAD_R = timebase_reload;
+    NVIC_ST_CTRL_R = timebase_ctrl;
+
+    critical_exit( primask );
+
+    return TIMEBASE_OK;
+}
+
+uint64_t timebase_now_us( void )
+{
+    uint32_t primask = critical_enter();
+    uint64_t clocks = timebase_clocks();
+    critical_exit( primask );
+
+    return clocks / TIMEBASE_CLOCKS_PER_US;
+}
+
+uint64_t timebase_now_ms( void )
+{
+    return timebase_now_us() / 1000U;
+}
+
+uint64_t timebase_deadline( uint32_t timeout_us )
+{
+    return timebase_now_us() + timeout_us;
+}
+
+uint8_t timebase_expired( uint64_t deadline )
+{
+    return (timebase_now_us() >= deadline) ? 1U : 0U;
+}
+
+uint32_t timebase_remaining_us( uint64_t deadline )
+{
+    uint64_t now = timebase_now_us();
+
+    if ( now >= deadline )
+    {
+        return 0;
+    }
+    return ((deadline - now) > UINT32_MAX) ? UINT32_MAX : (uint32_t)(deadline - now);
+}
+
+static void timebase_wait_until( uint64_t deadline )
+{
+    uint8_t signalled = 0;
+    uint32_t remaining;
+
+    while ( (remaining = timebase_remaining_us( deadline )) )
+    {
+        signalled |= idle_wait( remaining );
+    }
+
+    // Meant for the main loop, leave it for its idle_wait
+    if ( signalled )
+    {
+        idle_signal();
+    }
+}
+
+void timebase_delay_us( uint32_t us )
+{
+    timebase_wait_until( timebase_deadline( us ) );
+}
+
+void timebase_delay_ms( uint32_t ms )
+{
+    timebase_wait_until( timebase_now_us() + ((uint64_t)ms * 1000U) );
+}
+
+void timebase_suspend( void )
+{
+    uint32_t primask = critical_enter();
+    timebase_stop();
+    critical_exit( primask );
+}
+
+void timebase_resume( uint64_t slept_us )
+{
+    uint32_t primask = critical_enter();
+
+    timebase_base += slept_us * TIMEBASE_CLOCKS_PER_US;
+    NVIC_ST_CTRL_R = timebase_ctrl;
+
+    critical_exit( primask );
+}
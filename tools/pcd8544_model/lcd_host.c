@@ -0,0 +1,321 @@
+/*
+ * Runs the unmodified LCD driver against the PCD8544 model and checks every
+ * frame it sends, pixel for pixel against a golden image and byte for byte
+ * against the expected bus traffic, so a rendering change shows up before
+ * it reaches a board.
+ *
+ * The register ranges lcd.c touches are plain memory here. The SSI, GPIO
+ * and delay calls it makes are stubbed: ssi0_write and ssi_write_buf feed
+ * the model with D/C' as the driver left it on PA6, and a delay with RES'
+ * (PA7) low resets the model.
+ *
+ * Build from this directory:
+ *      cc -std=gnu11 -O2 -no-pie -I../../include -I../../include/hal \
+ *          -o lcd_host pcd8544_model.c lcd_host.c \
+ *          ../../src/lcd_5110/lcd.c ../../src/util/common.c
+ *
+ * Usage:
+ *      lcd_host golden                     check each frame against
+ *                                          golden/<step>.pbm
+ *      lcd_host -w golden                  write the golden images instead
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/common.h"
+#include "hal/delay.h"
+#include "hal/gpio.h"
+#include "hal/ssi.h"
+#include "util/timebase.h"
+#include "lcd_5110/lcd.h"
+
+#include "pcd8544_model.h"
+
+// Pages holding SSI0 and GPIO Port A (AHB)
+#define HOST_SSI0_PAGE 0x40008000UL
+#define HOST_GPIOA_AHB_PAGE 0x40058000UL
+#define HOST_PAGE_SIZE 0x1000UL
+
+#define HOST_DATA_COMMAND (*(GPIO_PORTA_AHB_DATA_BITS_R + PIN_6))
+#define HOST_RESET__N (*(GPIO_PORTA_AHB_DATA_BITS_R + PIN_7))
+
+struct lcd_host_step
+{
+    // Golden image name, steps showing the same picture share one
+    const char *name;
+    const char *golden;
+    void (*run)(void);
+    // Expected traffic of the frame
+    uint32_t bytes;
+    uint32_t data_bytes;
+    uint32_t commands;
+    uint32_t address_commands;
+};
+
+static struct pcd8544_model model;
+static struct ssi_handle host_ssi;
+
+/*
+ * Stubs for what lcd.c calls outside itself
+ */
+
+enum ssiret ssi0_init(void)
+{
+    return SSI_OK;
+}
+
+struct ssi_handle *ssi_get_handle(enum ssi_instance instance)
+{
+    (void)instance;
+    return &host_ssi;
+}
+
+enum ssiret ssi_set_bitrate(struct ssi_handle *ssi, uint32_t bitrate, uint32_t *achieved)
+{
+    (void)ssi;
+    if (achieved)
+    {
+        *achieved = bitrate;
+    }
+    return SSI_OK;
+}
+
+enum ssiret ssi0_write(uint8_t byte)
+{
+    pcd8544_feed(&model, HOST_DATA_COMMAND ? 1U : 0U, byte);
+    return SSI_OK;
+}
+
+enum ssiret ssi_write_buf(struct ssi_handle *ssi, const uint8_t *tx, uint16_t length)
+{
+    (void)ssi;
+    for (uint16_t i = 0; i < length; i++)
+    {
+        ssi0_write(tx[i]);
+    }
+    return SSI_OK;
+}
+
+void gpio_enable_port(Port port)
+{
+    (void)port;
+}
+
+void delay_sleep_ns(uint64_t ns)
+{
+    (void)ns;
+
+    // RES' held low for the pulse
+    if (!HOST_RESET__N)
+    {
+        pcd8544_reset(&model);
+    }
+}
+
+void timebase_delay_ms(uint32_t ms)
+{
+    (void)ms;
+}
+
+/*
+ * Steps, run in order on one driver instance
+ */
+
+static void step_init_cold(void)
+{
+    lcd_init();
+}
+
+static void step_hello(void)
+{
+    lcd_write_row(5, 20, 1, "H E L L O !");
+    lcd_display_dirty();
+}
+
+static void step_hello_moved(void)
+{
+    // What the main loop does as the greeting slides down
+    lcd_write_row(0, 20, 0, "");
+    lcd_write_row(5, 21, 1, "H E L L O !");
+    lcd_display_dirty();
+}
+
+static void step_unchanged(void)
+{
+    lcd_display_dirty();
+}
+
+static void step_init_warm(void)
+{
+    // The driver's .noinit state is what a warm reset leaves behind
+    lcd_init();
+}
+
+static void step_text(void)
+{
+    // Twelve 7 pixel cells to a row, lcd_write_string wraps within it
+    lcd_clear_screen_buffer();
+    lcd_write_line(0, 0, "The quick");
+    lcd_write_line(1, 0, "brown fox");
+    lcd_write_line(2, 0, "jumps over");
+    lcd_write_line(3, 0, "the lazy dog");
+    lcd_write_line(5, 0, "0123456789!?");
+    lcd_display();
+}
+
+static void step_span(void)
+{
+    // An image loaded into the buffer and pushed bank by bank, as
+    // lcd_flash_show_image does
+    uint8_t *buffer = lcd_get_screen_buffer();
+    for (uint8_t x = 10; x < 30; x++)
+    {
+        buffer[(4U * LCD_5110_COLUMNS) + x] = (uint8_t)(x * 37U);
+    }
+    lcd_display_span(4, 10, 29);
+}
+
+static const struct lcd_host_step steps[] =
+{
+    // Setup, all on, bank 0 cleared by lcd_page_flip and again after it,
+    // normal mode twice
+    {"init_cold", "init_cold", step_init_cold, 182, 168, 14, 6},
+    // lcd_init leaves the whole buffer dirty, every bank goes out
+    {"hello", "hello", step_hello, 516, 504, 12, 12},
+    // Banks 2 and 3 across the whole width
+    {"hello_moved", "hello_moved", step_hello_moved, 172, 168, 4, 4},
+    {"unchanged", "hello_moved", step_unchanged, 0, 0, 0, 0},
+    // Setup, then the frame from .noinit in one run
+    {"init_warm", "hello_moved", step_init_warm, 512, 504, 8, 2},
+    {"text", "text", step_text, 506, 504, 2, 2},
+    {"span", "span", step_span, 22, 20, 2, 2},
+    // The span is part of the frame a warm reset restores
+    {"init_warm_span", "span", step_init_warm, 512, 504, 8, 2},
+};
+
+static int host_map(uintptr_t page)
+{
+    if (mmap((void *)page, HOST_PAGE_SIZE, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != (void *)page)
+    {
+        perror("lcd_host: mmap");
+        return -1;
+    }
+    return 0;
+}
+
+static int write_golden(const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (!file || pcd8544_write_pbm(&model, file))
+    {
+        perror(path);
+        if (file)
+        {
+            fclose(file);
+        }
+        return -1;
+    }
+    fclose(file);
+    return 0;
+}
+
+static long check_golden(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+
+    if (!file)
+    {
+        perror(path);
+        return -1;
+    }
+    long differences = pcd8544_compare_pbm(&model, file);
+    fclose(file);
+    return differences;
+}
+
+static int check_counter(const char *step, const char *label, uint32_t value, uint32_t expected)
+{
+    if (value == expected)
+    {
+        return 0;
+    }
+    printf("%s: %lu %s, expected %lu\n", step, (unsigned long)value, label, (unsigned long)expected);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    int write = (argc == 3 && strcmp(argv[1], "-w") == 0);
+    const char *directory = argv[argc - 1];
+    int failed = 0;
+
+    if (argc != 2 && !write)
+    {
+        fprintf(stderr, "usage: %s [-w] <golden directory>\n", argv[0]);
+        return 2;
+    }
+
+    if (host_map(HOST_SSI0_PAGE) || host_map(HOST_GPIOA_AHB_PAGE))
+    {
+        return 2;
+    }
+    // The transmit FIFO is always empty, lcd_send never waits
+    SSI0_SR_R = SSI_SR_TFE | SSI_SR_TNF;
+
+    pcd8544_reset(&model);
+
+    for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++)
+    {
+        const struct lcd_host_step *step = &steps[i];
+        const struct pcd8544_counters *frame = &model.last_frame;
+        char path[512];
+
+        step->run();
+        pcd8544_end_frame(&model);
+
+        printf("%-12s bytes %4lu  data %4lu  commands %3lu  address %3lu  redundant %4lu  invalid %lu\n",
+               step->name,
+               (unsigned long)frame->bytes,
+               (unsigned long)frame->data_bytes,
+               (unsigned long)frame->commands,
+               (unsigned long)frame->address_commands,
+               (unsigned long)frame->redundant_data_bytes,
+               (unsigned long)frame->invalid_commands);
+
+        failed |= check_counter(step->name, "bytes", frame->bytes, step->bytes);
+        failed |= check_counter(step->name, "data bytes", frame->data_bytes, step->data_bytes);
+        failed |= check_counter(step->name, "commands", frame->commands, step->commands);
+        failed |= check_counter(step->name, "address commands", frame->address_commands, step->address_commands);
+        failed |= check_counter(step->name, "invalid commands", frame->invalid_commands, 0);
+
+        snprintf(path, sizeof(path), "%s/%s.pbm", directory, step->golden);
+        if (write)
+        {
+            // Shared images are written by the first step showing them
+            if (strcmp(step->name, step->golden) == 0 && write_golden(path))
+            {
+                return 2;
+            }
+            continue;
+        }
+
+        long differences = check_golden(path);
+        if (differences < 0)
+        {
+            return 2;
+        }
+        if (differences)
+        {
+            printf("%s: %ld pixels differ from %s\n", step->name, differences, path);
+            failed = 1;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Replays an LCD_5110_TRACE capture through the PCD8544 model.
+ *
+ * Build on the host:
+ *      cc -std=c99 -Wall -o pcd8544_dump pcd8544_model.c pcd8544_dump.c
+ *
+ * Usage:
+ *      pcd8544_dump <capture> [<output prefix> [<golden.pbm>]]
+ *
+ * Prints the bytes and commands sent for every frame. With an output prefix
+ * each frame is written to <prefix>NNNN.pbm. With a golden image the final
+ * frame is compared against it and the exit status is 1 on any difference,
+ * so rendering changes can be checked both for pixel exact output and for
+ * how much SSI traffic they generate.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pcd8544_model.h"
+
+struct dump_context
+{
+    const char *prefix;
+};
+
+static void dump_print_counters(const char *label, const struct pcd8544_counters *counters)
+{
+    printf("%-8s bytes %6lu  data %6lu  commands %5lu  address %5lu  redundant %6lu  invalid %lu\n",
+           label,
+           (unsigned long)counters->bytes,
+           (unsigned long)counters->data_bytes,
+           (unsigned long)counters->commands,
+           (unsigned long)counters->address_commands,
+           (unsigned long)counters->redundant_data_bytes,
+           (unsigned long)counters->invalid_commands);
+}
+
+static void dump_frame(struct pcd8544_model *model, void *context)
+{
+    struct dump_context *dump = context;
+    char label[24];
+
+    snprintf(label, sizeof(label), "frame %lu", (unsigned long)model->frames);
+    dump_print_counters(label, &model->last_frame);
+
+    if (dump->prefix)
+    {
+        char path[512];
+        snprintf(path, sizeof(path), "%s%04lu.pbm", dump->prefix, (unsigned long)model->frames);
+
+        FILE *output = fopen(path, "w");
+        if (!output || pcd8544_write_pbm(model, output))
+        {
+            fprintf(stderr, "can't write %s\n", path);
+        }
+        if (output)
+        {
+            fclose(output);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    static struct pcd8544_model model;
+    struct dump_context dump = {0};
+
+    if (argc < 2 || argc > 4)
+    {
+        fprintf(stderr, "usage: %s <capture> [<output prefix> [<golden.pbm>]]\n", argv[0]);
+        return 2;
+    }
+    if (argc >= 3)
+    {
+        dump.prefix = argv[2];
+    }
+
+    FILE *capture = fopen(argv[1], "rb");
+    if (!capture)
+    {
+        fprintf(stderr, "can't open %s\n", argv[1]);
+        return 2;
+    }
+
+    pcd8544_reset(&model);
+    int status = pcd8544_feed_capture(&model, capture, dump_frame, &dump);
+    fclose(capture);
+
+    if (status)
+    {
+        fprintf(stderr, "malformed capture\n");
+        return 2;
+    }
+
+    if (model.current.bytes)
+    {
+        // Bytes after the last frame marker, e.g. initialisation without a display
+        dump_print_counters("trailing", &model.current);
+        pcd8544_end_frame(&model);
+    }
+    dump_print_counters("total", &model.total);
+
+    if (argc == 4)
+    {
+        FILE *golden = fopen(argv[3], "rb");
+        if (!golden)
+        {
+            fprintf(stderr, "can't open %s\n", argv[3]);
+            return 2;
+        }
+
+        long differences = pcd8544_compare_pbm(&model, golden);
+        fclose(golden);
+
+        if (differences < 0)
+        {
+            fprintf(stderr, "can't read golden image %s\n", argv[3]);
+            return 2;
+        }
+        printf("golden   %ld pixels differ\n", differences);
+        return differences ? 1 : 0;
+    }
+
+    return 0;
+}
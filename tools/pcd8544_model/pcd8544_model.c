@@ -0,0 +1,361 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pcd8544_model.h"
+
+// Function set: 0 0 1 0 0 PD V H
+#define FUNCTION_SET_MASK 0xF8U
+#define FUNCTION_SET 0x20U
+#define FUNCTION_SET_PD 0x04U
+#define FUNCTION_SET_V 0x02U
+#define FUNCTION_SET_H 0x01U
+
+// Basic instruction set (H = 0)
+#define DISPLAY_CONTROL_MASK 0xF8U
+#define DISPLAY_CONTROL 0x08U
+#define DISPLAY_CONTROL_D 0x04U
+#define DISPLAY_CONTROL_E 0x01U
+#define SET_Y_MASK 0xF8U
+#define SET_Y 0x40U
+#define SET_X 0x80U
+
+// Extended instruction set (H = 1)
+#define TEMPERATURE_MASK 0xFCU
+#define TEMPERATURE 0x04U
+#define BIAS_MASK 0xF8U
+#define BIAS 0x10U
+#define SET_VOP 0x80U
+
+void pcd8544_reset(struct pcd8544_model *model)
+{
+    memset(model, 0, sizeof(*model));
+
+    // After RES' the chip is powered down, horizontal addressing, basic
+    // instruction set, display blank. RAM content is undefined, modelled as clear
+    model->power_down = 1;
+    model->display_mode = PCD8544_DISPLAY_BLANK;
+}
+
+static void pcd8544_command(struct pcd8544_model *model, uint8_t byte)
+{
+    if (byte == 0x00)
+    {
+        // NOP
+        return;
+    }
+
+    if ((byte & FUNCTION_SET_MASK) == FUNCTION_SET)
+    {
+        model->power_down = (byte & FUNCTION_SET_PD) ? 1U : 0U;
+        model->vertical_addressing = (byte & FUNCTION_SET_V) ? 1U : 0U;
+        model->extended_instructions = (byte & FUNCTION_SET_H) ? 1U : 0U;
+        return;
+    }
+
+    if (model->extended_instructions)
+    {
+        if (byte & SET_VOP)
+        {
+            model->vop = byte & 0x7FU;
+        }
+        else if ((byte & BIAS_MASK) == BIAS)
+        {
+            model->bias = byte & 0x07U;
+        }
+        else if ((byte & TEMPERATURE_MASK) == TEMPERATURE)
+        {
+            model->temperature_coefficient = byte & 0x03U;
+        }
+        else
+        {
+            model->current.invalid_commands++;
+        }
+        return;
+    }
+
+    if (byte & SET_X)
+    {
+        uint8_t x = byte & 0x7FU;
+        model->current.address_commands++;
+        if (x < PCD8544_COLUMNS)
+        {
+            model->x = x;
+        }
+        else
+        {
+            model->current.invalid_commands++;
+        }
+    }
+    else if ((byte & SET_Y_MASK) == SET_Y)
+    {
+        uint8_t y = byte & 0x07U;
+        model->current.address_commands++;
+        if (y < PCD8544_BANKS)
+        {
+            model->y = y;
+        }
+        else
+        {
+            model->current.invalid_commands++;
+        }
+    }
+    else if ((byte & DISPLAY_CONTROL_MASK) == DISPLAY_CONTROL)
+    {
+        uint8_t d = (byte & DISPLAY_CONTROL_D) ? 1U : 0U;
+        uint8_t e = (byte & DISPLAY_CONTROL_E) ? 1U : 0U;
+
+        if (!d && !e)
+        {
+            model->display_mode = PCD8544_DISPLAY_BLANK;
+        }
+        else if (!d && e)
+        {
+            model->display_mode = PCD8544_DISPLAY_ALL_ON;
+        }
+        else if (d && !e)
+        {
+            model->display_mode = PCD8544_DISPLAY_NORMAL;
+        }
+        else
+        {
+            model->display_mode = PCD8544_DISPLAY_INVERSE;
+        }
+    }
+    else
+    {
+        model->current.invalid_commands++;
+    }
+}
+
+static void pcd8544_data(struct pcd8544_model *model, uint8_t byte)
+{
+    if (model->ram[model->y][model->x] == byte)
+    {
+        model->current.redundant_data_bytes++;
+    }
+    model->ram[model->y][model->x] = byte;
+
+    if (model->vertical_addressing)
+    {
+        if (++model->y >= PCD8544_BANKS)
+        {
+            model->y = 0;
+            if (++model->x >= PCD8544_COLUMNS)
+            {
+                model->x = 0;
+            }
+        }
+    }
+    else
+    {
+        if (++model->x >= PCD8544_COLUMNS)
+        {
+            model->x = 0;
+            if (++model->y >= PCD8544_BANKS)
+            {
+                model->y = 0;
+            }
+        }
+    }
+}
+
+void pcd8544_feed(struct pcd8544_model *model, uint8_t is_data, uint8_t byte)
+{
+    model->current.bytes++;
+
+    if (is_data)
+    {
+        model->current.data_bytes++;
+        pcd8544_data(model, byte);
+    }
+    else
+    {
+        model->current.commands++;
+        pcd8544_command(model, byte);
+    }
+}
+
+static void pcd8544_accumulate(struct pcd8544_counters *total, const struct pcd8544_counters *add)
+{
+    total->bytes += add->bytes;
+    total->data_bytes += add->data_bytes;
+    total->commands += add->commands;
+    total->address_commands += add->address_commands;
+    total->redundant_data_bytes += add->redundant_data_bytes;
+    total->invalid_commands += add->invalid_commands;
+}
+
+void pcd8544_end_frame(struct pcd8544_model *model)
+{
+    pcd8544_accumulate(&model->total, &model->current);
+    model->last_frame = model->current;
+    memset(&model->current, 0, sizeof(model->current));
+    model->frames++;
+}
+
+int pcd8544_feed_capture(struct pcd8544_model *model, FILE *capture,
+                         void (*on_frame)(struct pcd8544_model *model, void *context), void *context)
+{
+    int tag;
+    int byte;
+
+    while ((tag = fgetc(capture)) != EOF)
+    {
+        byte = fgetc(capture);
+        if (byte == EOF)
+        {
+            return -1;
+        }
+
+        switch (tag)
+        {
+        case PCD8544_RECORD_COMMAND:
+        case PCD8544_RECORD_DATA:
+            pcd8544_feed(model, (uint8_t)tag, (uint8_t)byte);
+            break;
+        case PCD8544_RECORD_FRAME:
+            pcd8544_end_frame(model);
+            if (on_frame)
+            {
+                on_frame(model, context);
+            }
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+uint8_t pcd8544_pixel(const struct pcd8544_model *model, uint8_t x, uint8_t y)
+{
+    if (model->power_down)
+    {
+        return 0;
+    }
+
+    uint8_t bit = (model->ram[y / 8U][x] >> (y % 8U)) & 0x01U;
+
+    switch (model->display_mode)
+    {
+    case PCD8544_DISPLAY_NORMAL:
+        return bit;
+    case PCD8544_DISPLAY_INVERSE:
+        return bit ^ 0x01U;
+    case PCD8544_DISPLAY_ALL_ON:
+        return 1;
+    case PCD8544_DISPLAY_BLANK:
+    default:
+        return 0;
+    }
+}
+
+int pcd8544_write_pbm(const struct pcd8544_model *model, FILE *output)
+{
+    fprintf(output, "P1\n%u %u\n", PCD8544_COLUMNS, PCD8544_ROWS);
+    for (uint8_t y = 0; y < PCD8544_ROWS; y++)
+    {
+        for (uint8_t x = 0; x < PCD8544_COLUMNS; x++)
+        {
+            fputc(pcd8544_pixel(model, x, y) ? '1' : '0', output);
+            fputc((x + 1U == PCD8544_COLUMNS) ? '\n' : ' ', output);
+        }
+    }
+    return ferror(output) ? -1 : 0;
+}
+
+/**
+ * @brief   Read the next header number of a PBM, skipping whitespace and comments
+ *
+ */
+static int pcd8544_pbm_number(FILE *input, unsigned *value)
+{
+    int c;
+
+    do
+    {
+        c = fgetc(input);
+        if (c == '#')
+        {
+            while (c != '\n' && c != EOF)
+            {
+                c = fgetc(input);
+            }
+        }
+    } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+
+    if (c < '0' || c > '9')
+    {
+        return -1;
+    }
+
+    *value = 0;
+    while (c >= '0' && c <= '9')
+    {
+        *value = (*value * 10U) + (unsigned)(c - '0');
+        c = fgetc(input);
+    }
+    // The single whitespace after the height separates the P4 raster
+    return 0;
+}
+
+long pcd8544_compare_pbm(const struct pcd8544_model *model, FILE *golden)
+{
+    char magic[2];
+    unsigned width;
+    unsigned height;
+    long differences = 0;
+
+    if (fread(magic, 1, 2, golden) != 2 || magic[0] != 'P' || (magic[1] != '1' && magic[1] != '4'))
+    {
+        return -1;
+    }
+    if (pcd8544_pbm_number(golden, &width) || pcd8544_pbm_number(golden, &height) ||
+        width != PCD8544_COLUMNS || height != PCD8544_ROWS)
+    {
+        return -1;
+    }
+
+    for (uint8_t y = 0; y < PCD8544_ROWS; y++)
+    {
+        int packed = 0;
+        for (uint8_t x = 0; x < PCD8544_COLUMNS; x++)
+        {
+            int pixel;
+            if (magic[1] == '1')
+            {
+                do
+                {
+                    pixel = fgetc(golden);
+                } while (pixel == ' ' || pixel == '\t' || pixel == '\r' || pixel == '\n');
+                if (pixel != '0' && pixel != '1')
+                {
+                    return -1;
+                }
+                pixel -= '0';
+            }
+            else
+            {
+                // P4 packs 8 pixels per byte, MSB first, rows padded to a byte
+                if ((x % 8U) == 0)
+                {
+                    packed = fgetc(golden);
+                    if (packed == EOF)
+                    {
+                        return -1;
+                    }
+                }
+                pixel = (packed >> (7U - (x % 8U))) & 0x01;
+            }
+
+            if ((uint8_t)pixel != pcd8544_pixel(model, x, y))
+            {
+                differences++;
+            }
+        }
+    }
+
+    return differences;
+}
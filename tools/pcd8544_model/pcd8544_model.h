@@ -0,0 +1,145 @@
+#ifndef PCD8544_MODEL_H__
+#define PCD8544_MODEL_H__
+
+/*
+ * Behavioural model of the PCD8544 controller used by the Nokia 5110 LCD.
+ * Runs on the host: feed it the D/C' flag and byte of everything lcd_send
+ * puts on the bus and it rebuilds the display RAM and what the glass shows.
+ *
+ * Capture format consumed by pcd8544_feed_capture, two bytes per record:
+ *      PCD8544_RECORD_COMMAND  byte    D/C' low
+ *      PCD8544_RECORD_DATA     byte    D/C' high
+ *      PCD8544_RECORD_FRAME    0x00    end of a frame (lcd_trace_frame)
+ * This is what an lcd_trace_byte/lcd_trace_frame pair writing straight to a
+ * UART or RAM log produces when the firmware is built with LCD_5110_TRACE.
+ *
+ * lcd_host.c feeds the model from lcd.c itself, built for the host, and
+ * checks the frames against the images in golden/.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define PCD8544_COLUMNS 84U
+#define PCD8544_BANKS 6U
+#define PCD8544_ROWS (PCD8544_BANKS * 8U)
+
+enum pcd8544_record
+{
+    PCD8544_RECORD_COMMAND = 0x00,
+    PCD8544_RECORD_DATA = 0x01,
+    PCD8544_RECORD_FRAME = 0x02
+};
+
+enum pcd8544_display_mode
+{
+    PCD8544_DISPLAY_BLANK,
+    PCD8544_DISPLAY_NORMAL,
+    PCD8544_DISPLAY_ALL_ON,
+    PCD8544_DISPLAY_INVERSE
+};
+
+struct pcd8544_counters
+{
+    uint32_t bytes;
+    uint32_t data_bytes;
+    uint32_t commands;
+    // Commands that moved the address pointer (0x80 X / 0x40 Y)
+    uint32_t address_commands;
+    // Data bytes that wrote the value already in RAM
+    uint32_t redundant_data_bytes;
+    // Commands the controller ignores in the current instruction set
+    uint32_t invalid_commands;
+};
+
+struct pcd8544_model
+{
+    uint8_t ram[PCD8544_BANKS][PCD8544_COLUMNS];
+
+    uint8_t x;
+    uint8_t y;
+
+    // Function set bits
+    uint8_t power_down;
+    uint8_t vertical_addressing;
+    uint8_t extended_instructions;
+
+    enum pcd8544_display_mode display_mode;
+
+    // Extended instruction set state
+    uint8_t vop;
+    uint8_t bias;
+    uint8_t temperature_coefficient;
+
+    // Counters since the last frame marker, and for the frame that just ended
+    struct pcd8544_counters current;
+    struct pcd8544_counters last_frame;
+    struct pcd8544_counters total;
+    uint32_t frames;
+};
+
+/**
+ * @brief   Put the model in the state the panel has after RES'
+ *
+ * @param model Model
+ */
+void pcd8544_reset(struct pcd8544_model *model);
+
+/**
+ * @brief   Consume one byte from the bus
+ *
+ * @param model Model
+ * @param is_data D/C' level, 1 for display data
+ * @param byte Byte clocked in
+ */
+void pcd8544_feed(struct pcd8544_model *model, uint8_t is_data, uint8_t byte);
+
+/**
+ * @brief   Close the current frame, moving its counters to last_frame
+ *
+ * @param model Model
+ */
+void pcd8544_end_frame(struct pcd8544_model *model);
+
+/**
+ * @brief   Feed a capture file, calling on_frame at every frame marker
+ *
+ * @param model Model
+ * @param capture Open capture file
+ * @param on_frame Called after each frame ends, may be NULL
+ * @param context Passed to on_frame
+ * @return int 0 on success, -1 on a malformed record
+ */
+int pcd8544_feed_capture(struct pcd8544_model *model, FILE *capture,
+                         void (*on_frame)(struct pcd8544_model *model, void *context), void *context);
+
+/**
+ * @brief   Pixel as shown on the glass, taking the display mode into account
+ *
+ * @param model Model
+ * @param x Column 0:83
+ * @param y Row 0:47
+ * @return uint8_t 1 when the pixel is dark
+ */
+uint8_t pcd8544_pixel(const struct pcd8544_model *model, uint8_t x, uint8_t y);
+
+/**
+ * @brief   Write what the glass shows as a plain (P1) PBM, which diffs well
+ *          as a golden image
+ *
+ * @param model Model
+ * @param output Open output file
+ * @return int 0 on success
+ */
+int pcd8544_write_pbm(const struct pcd8544_model *model, FILE *output);
+
+/**
+ * @brief   Compare what the glass shows against a P1 or P4 PBM golden image
+ *
+ * @param model Model
+ * @param golden Open golden image
+ * @return long Number of differing pixels, -1 if the image can't be read
+ */
+long pcd8544_compare_pbm(const struct pcd8544_model *model, FILE *golden);
+
+#endif
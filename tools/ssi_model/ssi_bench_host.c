@@ -0,0 +1,201 @@
+/*
+ * Runs the SSI benchmark against the host register model and checks the
+ * cycle counts against a saved baseline, so a driver change that slows a
+ * path down shows up before it reaches a board.
+ *
+ * Build from this directory:
+ *      cc -std=gnu11 -O2 -no-pie -I../../include -I../../include/hal \
+ *          -o ssi_bench_host ssi_model.c ssi_bench_host.c \
+ *          ../../src/hal/ssi.c ../../src/hal/gpio.c ../../src/hal/udma.c \
+ *          ../../src/hal/ssi_bench.c ../../src/util/cycles.c \
+ *          ../../src/util/report.c
+ *
+ * Usage:
+ *      ssi_bench_host                      print the results
+ *      ssi_bench_host -w baseline.csv      also save them as the baseline
+ *      ssi_bench_host baseline.csv [pct]   fail if any run takes more than
+ *                                          pct (default 5) percent more
+ *                                          cycles than the baseline
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal/clock.h"
+#include "hal/clock_gate.h"
+#include "hal/idle.h"
+#include "hal/pll.h"
+#include "hal/ssi.h"
+#include "hal/ssi_bench.h"
+
+#include "ssi_model.h"
+
+#define BENCH_BITRATE 4000000UL
+#define BENCH_TOLERANCE_PERCENT 5UL
+
+// SSI0 interrupt number
+#define BENCH_SSI0_IRQ 7U
+
+// The model has no clock tree: the clock pll_init sets, and it never changes
+uint32_t SystemCoreClock = PLL_SYSTEM_CLOCK_HZ;
+
+enum clockret clock_register_notifier(clock_notifier notifier)
+{
+    (void)notifier;
+    return CLOCK_OK;
+}
+
+// clock_gate.c masks interrupts with ARM instructions; the model only needs
+// the module clocks on, and reports every module ready
+void clock_gate_enable(enum clock_gate_class gate, uint32_t modules, uint8_t modes)
+{
+    (void)modes;
+    if (gate == CLOCK_GATE_GPIO)
+    {
+        SYSCTL_RCGCGPIO_R |= modules;
+    }
+    else if (gate == CLOCK_GATE_SSI)
+    {
+        SYSCTL_RCGCSSI_R |= modules;
+    }
+    else if (gate == CLOCK_GATE_DMA)
+    {
+        SYSCTL_RCGCDMA_R |= modules;
+    }
+}
+
+void clock_gate_disable(enum clock_gate_class gate, uint32_t modules, uint8_t modes)
+{
+    (void)gate;
+    (void)modules;
+    (void)modes;
+}
+
+// The model never sleeps, only count the holds so unbalanced ones show up
+static int deep_sleep_blocks = 0;
+
+void idle_block_deep_sleep(void)
+{
+    deep_sleep_blocks++;
+}
+
+void idle_allow_deep_sleep(void)
+{
+    deep_sleep_blocks--;
+}
+
+static void put(char character)
+{
+    if (character != '\r')
+    {
+        putchar(character);
+    }
+}
+
+static int write_baseline(const char *path, const struct ssi_bench_result *results, uint8_t count)
+{
+    FILE *file = fopen(path, "w");
+
+    if (!file)
+    {
+        perror(path);
+        return -1;
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        fprintf(file, "%d,%u,%lu\n", results[i].mode, results[i].length, (unsigned long)results[i].cycles);
+    }
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief   Compare against a baseline
+ *
+ * @return int Number of runs slower than allowed, -1 if the file can't be read
+ */
+static int check_baseline(const char *path, unsigned long tolerance,
+                          const struct ssi_bench_result *results, uint8_t count)
+{
+    FILE *file = fopen(path, "r");
+    int mode;
+    unsigned length;
+    unsigned long cycles;
+    int regressions = 0;
+
+    if (!file)
+    {
+        perror(path);
+        return -1;
+    }
+
+    while (fscanf(file, "%d,%u,%lu", &mode, &length, &cycles) == 3)
+    {
+        for (uint8_t i = 0; i < count; i++)
+        {
+            if ((int)results[i].mode != mode || results[i].length != length)
+            {
+                continue;
+            }
+            if (results[i].cycles * 100UL > cycles * (100UL + tolerance))
+            {
+                printf("regression: mode %d, %u B: %lu cycles, baseline %lu\n",
+                       mode, length, (unsigned long)results[i].cycles, cycles);
+                regressions++;
+            }
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+int main(int argc, char **argv)
+{
+    static struct ssi_bench_result results[SSI_BENCH_RESULTS];
+    int failed = 0;
+
+    if (ssi_model_init() != 0)
+    {
+        return 2;
+    }
+    ssi_model_set_handler(BENCH_SSI0_IRQ, SSI0IntHandler);
+
+    uint8_t count = ssi_bench_run(SSI_INSTANCE_0, SSI_PINMUX_SSI0_PA2_PA5, BENCH_BITRATE,
+                                  results, SSI_BENCH_RESULTS);
+    ssi_bench_report(results, count, put);
+    printf("%llu register accesses\n", (unsigned long long)ssi_model_accesses());
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        failed |= results[i].timed_out || results[i].errors;
+    }
+
+    // Every mode the bench switched on was switched off again
+    if (deep_sleep_blocks != 0)
+    {
+        printf("deep sleep left blocked %d times\n", deep_sleep_blocks);
+        failed = 1;
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "-w") == 0)
+    {
+        if (write_baseline(argv[2], results, count) != 0)
+        {
+            return 2;
+        }
+    }
+    else if (argc >= 2)
+    {
+        unsigned long tolerance = (argc >= 3) ? strtoul(argv[2], NULL, 10) : BENCH_TOLERANCE_PERCENT;
+        int regressions = check_baseline(argv[1], tolerance, results, count);
+        if (regressions < 0)
+        {
+            return 2;
+        }
+        failed |= regressions > 0;
+    }
+
+    return failed ? 1 : 0;
+}
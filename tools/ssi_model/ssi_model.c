@@ -0,0 +1,848 @@
+#define _GNU_SOURCE
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#include "hal/tm4c123gh6pm.h"
+#include "hal/udma.h"
+
+#include "ssi_model.h"
+
+#define PERIPHERAL_BASE 0x40000000UL
+#define PERIPHERAL_SIZE 0x00100000UL
+#define SYSTEM_BASE 0xE0000000UL
+#define SYSTEM_SIZE 0x00010000UL
+#define PAGE_SIZE 0x1000UL
+
+#define SSI_BASE 0x40008000UL
+#define SSI_COUNT 4U
+#define SSI_CR0 0x000UL
+#define SSI_CR1 0x004UL
+#define SSI_DR 0x008UL
+#define SSI_SR 0x00CUL
+#define SSI_CPSR 0x010UL
+#define SSI_IM 0x014UL
+#define SSI_RIS 0x018UL
+#define SSI_MIS 0x01CUL
+#define SSI_ICR 0x020UL
+#define SSI_DMACTL 0x024UL
+
+#define SYSCTL_PR_START 0x400FEA00UL
+#define SYSCTL_PR_END 0x400FEB00UL
+
+#define UDMA_BASE 0x400FF000UL
+#define UDMA_CFG 0x004UL
+#define UDMA_CTLBASE 0x008UL
+#define UDMA_ALTBASE 0x00CUL
+#define UDMA_USEBURSTSET 0x018UL
+#define UDMA_USEBURSTCLR 0x01CUL
+#define UDMA_REQMASKSET 0x020UL
+#define UDMA_REQMASKCLR 0x024UL
+#define UDMA_ENASET 0x028UL
+#define UDMA_ENACLR 0x02CUL
+#define UDMA_ALTSET 0x030UL
+#define UDMA_ALTCLR 0x034UL
+#define UDMA_PRIOSET 0x038UL
+#define UDMA_PRIOCLR 0x03CUL
+#define UDMA_CHIS 0x504UL
+#define UDMA_CHMAP0 0x510UL
+
+#define DWT_PAGE 0xE0001000UL
+#define DWT_CYCCNT 0xE0001004UL
+
+#define NVIC_PAGE 0xE000E000UL
+#define NVIC_EN0 0xE000E100UL
+#define NVIC_DIS0 0xE000E180UL
+#define NVIC_WORDS 5U
+#define NVIC_IRQS (NVIC_WORDS * 32U)
+
+#define FIFO_DEPTH 8U
+// TX FIFO at or below this raises TXRIS and burst requests, RX at or above
+#define FIFO_HALF 4U
+// Bit times an RX frame may sit unread before RTRIS
+#define RX_TIMEOUT_BITS 32U
+
+// Put in write-only data registers before a write, to spot any value written
+#define WRITE_SENTINEL 0xDEADBEEFU
+
+#define EFLAGS_TRAP 0x100
+
+struct fifo
+{
+    uint16_t data[FIFO_DEPTH];
+    uint8_t head;
+    uint8_t count;
+};
+
+struct ssi_state
+{
+    struct fifo tx;
+    struct fifo rx;
+    uint8_t shifting;
+    uint16_t shift_frame;
+    uint64_t shift_done;
+    uint64_t last_rx;
+    uint8_t overrun;
+    uint8_t timeout;
+};
+
+// Interrupt number and uDMA channels/encoding of each SSI module
+static const struct
+{
+    uint8_t irq;
+    uint8_t rx_channel;
+    uint8_t tx_channel;
+    uint8_t encoding;
+} ssi_wiring[SSI_COUNT] =
+{
+    {7U, 10U, 11U, 0U},
+    {34U, 24U, 25U, 0U},
+    {57U, 12U, 13U, 2U},
+    {58U, 14U, 15U, 2U}
+};
+
+static struct
+{
+    uint64_t now;
+    uint64_t accesses;
+    uint32_t cyccnt_offset;
+
+    struct ssi_state ssi[SSI_COUNT];
+
+    uint32_t dma_enabled;
+    uint32_t dma_alternate;
+    uint32_t dma_useburst;
+    uint32_t dma_reqmask;
+    uint32_t dma_priority;
+    uint32_t dma_done;
+
+    uint32_t nvic_enabled[NVIC_WORDS];
+    ssi_model_handler handlers[NVIC_IRQS];
+    volatile int in_isr;
+
+    // Access being single stepped
+    uintptr_t page;
+    uintptr_t address;
+    int write;
+    uint32_t snapshot[PAGE_SIZE / 4U];
+
+    // Interrupted program state while a handler runs
+    gregset_t saved_gregs;
+    struct _libc_fpstate saved_fpregs;
+} model;
+
+static volatile uint32_t *reg(uintptr_t address)
+{
+    return (volatile uint32_t *)address;
+}
+
+static uintptr_t ssi_base(unsigned instance)
+{
+    return SSI_BASE + (instance * PAGE_SIZE);
+}
+
+static void fifo_push(struct fifo *fifo, uint16_t value)
+{
+    fifo->data[(fifo->head + fifo->count) % FIFO_DEPTH] = value;
+    fifo->count++;
+}
+
+static uint16_t fifo_pop(struct fifo *fifo)
+{
+    uint16_t value = fifo->data[fifo->head];
+    fifo->head = (fifo->head + 1U) % FIFO_DEPTH;
+    fifo->count--;
+    return value;
+}
+
+/*
+ * SSI
+ */
+
+static uint32_t ssi_bit_cycles(unsigned instance)
+{
+    uintptr_t base = ssi_base(instance);
+    uint32_t cpsr = *reg(base + SSI_CPSR) & 0xFFU;
+    uint32_t scr = (*reg(base + SSI_CR0) >> 8U) & 0xFFU;
+
+    return (cpsr ? cpsr : 2U) * (scr + 1U);
+}
+
+static uint16_t ssi_frame_mask(unsigned instance)
+{
+    uint32_t dss = *reg(ssi_base(instance) + SSI_CR0) & 0xFU;
+    return (uint16_t)((1UL << (dss + 1U)) - 1U);
+}
+
+static void ssi_advance(unsigned instance)
+{
+    struct ssi_state *ssi = &model.ssi[instance];
+    uint32_t cr1 = *reg(ssi_base(instance) + SSI_CR1);
+    uint16_t mask = ssi_frame_mask(instance);
+
+    if (!(cr1 & SSI_CR1_SSE))
+    {
+        return;
+    }
+
+    for (;;)
+    {
+        uint64_t start = model.now;
+
+        if (ssi->shifting)
+        {
+            if (ssi->shift_done > model.now)
+            {
+                break;
+            }
+
+            // Loopback returns the frame, otherwise MISO idles high
+            ssi->shifting = 0;
+            if (ssi->rx.count < FIFO_DEPTH)
+            {
+                fifo_push(&ssi->rx, (cr1 & SSI_CR1_LBM) ? (ssi->shift_frame & mask) : mask);
+            }
+            else
+            {
+                ssi->overrun = 1;
+            }
+            ssi->last_rx = ssi->shift_done;
+            start = ssi->shift_done;
+        }
+
+        if (!ssi->tx.count)
+        {
+            break;
+        }
+
+        // Back to back with the previous frame
+        ssi->shift_frame = fifo_pop(&ssi->tx);
+        ssi->shift_done = start + ((uint64_t)ssi_bit_cycles(instance) * ((*reg(ssi_base(instance) + SSI_CR0) & 0xFU) + 1U));
+        ssi->shifting = 1;
+    }
+
+    if (ssi->rx.count && (model.now - ssi->last_rx) >= (RX_TIMEOUT_BITS * (uint64_t)ssi_bit_cycles(instance)))
+    {
+        ssi->timeout = 1;
+    }
+}
+
+static uint32_t ssi_status(unsigned instance)
+{
+    struct ssi_state *ssi = &model.ssi[instance];
+    uint32_t status = 0;
+
+    status |= ssi->tx.count == 0 ? SSI_SR_TFE : 0;
+    status |= ssi->tx.count < FIFO_DEPTH ? SSI_SR_TNF : 0;
+    status |= ssi->rx.count > 0 ? SSI_SR_RNE : 0;
+    status |= ssi->rx.count == FIFO_DEPTH ? SSI_SR_RFF : 0;
+    status |= (ssi->shifting || ssi->tx.count) ? SSI_SR_BSY : 0;
+
+    return status;
+}
+
+static uint32_t ssi_raw_interrupts(unsigned instance)
+{
+    struct ssi_state *ssi = &model.ssi[instance];
+    uint32_t cr1 = *reg(ssi_base(instance) + SSI_CR1);
+    uint32_t ris = 0;
+
+    if (cr1 & SSI_CR1_EOT)
+    {
+        ris |= (!ssi->tx.count && !ssi->shifting) ? SSI_RIS_TXRIS : 0;
+    }
+    else
+    {
+        ris |= ssi->tx.count <= FIFO_HALF ? SSI_RIS_TXRIS : 0;
+    }
+    ris |= ssi->rx.count >= FIFO_HALF ? SSI_RIS_RXRIS : 0;
+    ris |= ssi->timeout ? SSI_RIS_RTRIS : 0;
+    ris |= ssi->overrun ? SSI_RIS_RORRIS : 0;
+
+    return ris;
+}
+
+static uint16_t ssi_read_data(unsigned instance)
+{
+    struct ssi_state *ssi = &model.ssi[instance];
+
+    if (!ssi->rx.count)
+    {
+        return 0;
+    }
+    if (ssi->rx.count == 1U)
+    {
+        ssi->timeout = 0;
+    }
+    return fifo_pop(&ssi->rx);
+}
+
+static void ssi_write_data(unsigned instance, uint16_t value)
+{
+    struct ssi_state *ssi = &model.ssi[instance];
+
+    if (ssi->tx.count < FIFO_DEPTH)
+    {
+        fifo_push(&ssi->tx, value);
+    }
+}
+
+static int ssi_instance_of(uintptr_t address)
+{
+    if (address >= SSI_BASE && address < SSI_BASE + (SSI_COUNT * PAGE_SIZE))
+    {
+        return (int)((address - SSI_BASE) / PAGE_SIZE);
+    }
+    return -1;
+}
+
+/*
+ * uDMA
+ */
+
+static uint8_t dma_channel_encoding(uint8_t channel)
+{
+    uint32_t chmap = *reg(UDMA_BASE + UDMA_CHMAP0 + ((channel / 8U) * 4U));
+    return (uint8_t)((chmap >> ((channel % 8U) * 4U)) & 0xFU);
+}
+
+/**
+ * @brief   Request state of a channel. 0 none, 1 single, 2 burst
+ *
+ */
+static int dma_request(uint8_t channel)
+{
+    for (unsigned i = 0; i < SSI_COUNT; i++)
+    {
+        struct ssi_state *ssi = &model.ssi[i];
+        uint32_t dmactl = *reg(ssi_base(i) + SSI_DMACTL);
+
+        if (dma_channel_encoding(channel) != ssi_wiring[i].encoding)
+        {
+            continue;
+        }
+        if (channel == ssi_wiring[i].rx_channel && (dmactl & SSI_DMACTL_RXDMAE) && ssi->rx.count)
+        {
+            return ssi->rx.count >= FIFO_HALF ? 2 : 1;
+        }
+        if (channel == ssi_wiring[i].tx_channel && (dmactl & SSI_DMACTL_TXDMAE) && ssi->tx.count < FIFO_DEPTH)
+        {
+            return ssi->tx.count <= FIFO_HALF ? 2 : 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t dma_load(uintptr_t address, uint32_t size)
+{
+    int instance = ssi_instance_of(address);
+
+    if (instance >= 0 && (address & (PAGE_SIZE - 1U)) == SSI_DR)
+    {
+        return ssi_read_data((unsigned)instance);
+    }
+    switch (size)
+    {
+        case 1:
+            return *(volatile uint8_t *)address;
+        case 2:
+            return *(volatile uint16_t *)address;
+        default:
+            return *(volatile uint32_t *)address;
+    }
+}
+
+static void dma_store(uintptr_t address, uint32_t size, uint32_t value)
+{
+    int instance = ssi_instance_of(address);
+
+    if (instance >= 0 && (address & (PAGE_SIZE - 1U)) == SSI_DR)
+    {
+        ssi_write_data((unsigned)instance, (uint16_t)value);
+        return;
+    }
+    switch (size)
+    {
+        case 1:
+            *(volatile uint8_t *)address = (uint8_t)value;
+            break;
+        case 2:
+            *(volatile uint16_t *)address = (uint16_t)value;
+            break;
+        default:
+            *(volatile uint32_t *)address = value;
+            break;
+    }
+}
+
+static uint32_t dma_step_size(uint32_t increment)
+{
+    // Increment code 3 is no increment, otherwise bytes are 1 << code
+    return (increment == 3U) ? 0U : (1U << increment);
+}
+
+/**
+ * @brief   Move up to one arbitration's worth of items on a channel
+ *
+ * @return int Items moved
+ */
+static int dma_service_channel(uint8_t channel, int request)
+{
+    uint32_t bit = 1UL << channel;
+    struct udma_descriptor *table = (struct udma_descriptor *)(uintptr_t)*reg(UDMA_BASE + UDMA_CTLBASE);
+    struct udma_descriptor *descriptor = &table[channel + ((model.dma_alternate & bit) ? UDMA_CHANNELS : 0U)];
+    uint32_t control = descriptor->control;
+    uint32_t mode = control & UDMA_CHCTL_XFERMODE_M;
+    int moved = 0;
+
+    if (mode == UDMA_CHCTL_XFERMODE_STOP)
+    {
+        model.dma_enabled &= ~bit;
+        return 0;
+    }
+
+    uint32_t arbitration = request == 2 ? (1UL << ((control & UDMA_CHCTL_ARBSIZE_M) >> 14U)) : 1U;
+    uint32_t src_size = (control & UDMA_CHCTL_SRCSIZE_M) >> 24U;
+    uint32_t dst_size = (control & UDMA_CHCTL_DSTSIZE_M) >> 28U;
+    uint32_t src_step = dma_step_size((control & UDMA_CHCTL_SRCINC_M) >> 26U);
+    uint32_t dst_step = dma_step_size((control & UDMA_CHCTL_DSTINC_M) >> 30U);
+
+    while (arbitration-- && dma_request(channel))
+    {
+        uint32_t remaining = ((control & UDMA_CHCTL_XFERSIZE_M) >> 4U) + 1U;
+        uintptr_t src = (uintptr_t)descriptor->src_end - ((remaining - 1U) * src_step);
+        uintptr_t dst = (uintptr_t)descriptor->dst_end - ((remaining - 1U) * dst_step);
+
+        dma_store(dst, 1U << dst_size, dma_load(src, 1U << src_size));
+        moved++;
+
+        if (remaining > 1U)
+        {
+            control = (control & ~UDMA_CHCTL_XFERSIZE_M) | ((remaining - 2U) << 4U);
+            descriptor->control = control;
+            continue;
+        }
+
+        // Done: the descriptor stops and the channel signals completion
+        descriptor->control = control & ~(UDMA_CHCTL_XFERSIZE_M | UDMA_CHCTL_XFERMODE_M);
+        model.dma_done |= bit;
+
+        if (mode == UDMA_CHCTL_XFERMODE_PINGPONG)
+        {
+            model.dma_alternate ^= bit;
+            struct udma_descriptor *next = &table[channel + ((model.dma_alternate & bit) ? UDMA_CHANNELS : 0U)];
+            if ((next->control & UDMA_CHCTL_XFERMODE_M) == UDMA_CHCTL_XFERMODE_STOP)
+            {
+                model.dma_enabled &= ~bit;
+            }
+        }
+        else
+        {
+            model.dma_enabled &= ~bit;
+        }
+        break;
+    }
+
+    return moved;
+}
+
+static int dma_service(void)
+{
+    int moved = 0;
+
+    if (!(*reg(UDMA_BASE + UDMA_CFG) & UDMA_CFG_MASTEN))
+    {
+        return 0;
+    }
+
+    // High priority channels first, then by channel number
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (uint8_t channel = 0; channel < UDMA_CHANNELS; channel++)
+        {
+            uint32_t bit = 1UL << channel;
+            int high = (model.dma_priority & bit) != 0;
+
+            if ((pass == 0) != high || !(model.dma_enabled & bit) || (model.dma_reqmask & bit))
+            {
+                continue;
+            }
+
+            int request = dma_request(channel);
+            if (request == 1 && (model.dma_useburst & bit))
+            {
+                request = 0;
+            }
+            if (request)
+            {
+                moved += dma_service_channel(channel, request);
+            }
+        }
+    }
+
+    return moved;
+}
+
+/*
+ * Interrupts
+ */
+
+static int irq_line(unsigned irq)
+{
+    for (unsigned i = 0; i < SSI_COUNT; i++)
+    {
+        if (ssi_wiring[i].irq != irq)
+        {
+            continue;
+        }
+
+        uint32_t dma_bits = (1UL << ssi_wiring[i].rx_channel) | (1UL << ssi_wiring[i].tx_channel);
+        uint32_t mis = ssi_raw_interrupts(i) & *reg(ssi_base(i) + SSI_IM);
+        return mis || (model.dma_done & dma_bits);
+    }
+    return 0;
+}
+
+static int irq_pending(void)
+{
+    for (unsigned irq = 0; irq < NVIC_IRQS; irq++)
+    {
+        if ((model.nvic_enabled[irq / 32U] & (1UL << (irq % 32U))) && irq_line(irq))
+        {
+            return (int)irq;
+        }
+    }
+    return -1;
+}
+
+/*
+ * The register ranges are only accessible to the model while it handles an
+ * access; the model itself keeps its registers in that memory.
+ */
+
+static int model_unlock(void)
+{
+    int result = mprotect((void *)PERIPHERAL_BASE, PERIPHERAL_SIZE, PROT_READ | PROT_WRITE);
+    return result | mprotect((void *)SYSTEM_BASE, SYSTEM_SIZE, PROT_READ | PROT_WRITE);
+}
+
+static void model_lock(void)
+{
+    mprotect((void *)PERIPHERAL_BASE, PERIPHERAL_SIZE, PROT_NONE);
+    mprotect((void *)SYSTEM_BASE, SYSTEM_SIZE, PROT_NONE);
+}
+
+static int model_next_irq(void)
+{
+    int irq;
+
+    model_unlock();
+    irq = irq_pending();
+    model_lock();
+    return irq;
+}
+
+static void model_step(void)
+{
+    int moved;
+
+    do
+    {
+        for (unsigned i = 0; i < SSI_COUNT; i++)
+        {
+            ssi_advance(i);
+        }
+        moved = dma_service();
+    } while (moved);
+}
+
+/**
+ * @brief   Runs in place of the interrupted program until nothing is pending,
+ *          then has the SIGUSR1 handler put the program back
+ *
+ */
+static void model_isr_trampoline(void)
+{
+    int irq;
+
+    while ((irq = model_next_irq()) >= 0)
+    {
+        if (!model.handlers[irq])
+        {
+            fprintf(stderr, "ssi_model: no handler for enabled interrupt %d, disabling it\n", irq);
+            model.nvic_enabled[irq / 32] &= ~(1UL << (irq % 32));
+            continue;
+        }
+        model.handlers[irq]();
+    }
+
+    raise(SIGUSR1);
+    abort();
+}
+
+static void model_return_from_isr(int signal, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = context;
+
+    (void)signal;
+    (void)info;
+    memcpy(uc->uc_mcontext.gregs, model.saved_gregs, sizeof(gregset_t));
+    memcpy(uc->uc_mcontext.fpregs, &model.saved_fpregs, sizeof(model.saved_fpregs));
+    model.in_isr = 0;
+}
+
+/*
+ * Register access trapping
+ */
+
+/**
+ * @brief   Put what each modelled register of a page reads into memory. For
+ *          writes, registers whose writes must always be seen get a value
+ *          the program won't write instead.
+ *
+ */
+static void prepare_page(uintptr_t page, int write)
+{
+    int instance = ssi_instance_of(page);
+
+    if (instance >= 0)
+    {
+        struct ssi_state *ssi = &model.ssi[instance];
+        uint32_t ris = ssi_raw_interrupts((unsigned)instance);
+
+        *reg(page + SSI_DR) = write ? WRITE_SENTINEL : (ssi->rx.count ? ssi->rx.data[ssi->rx.head] : 0U);
+        *reg(page + SSI_SR) = ssi_status((unsigned)instance);
+        *reg(page + SSI_RIS) = ris;
+        *reg(page + SSI_MIS) = ris & *reg(page + SSI_IM);
+        *reg(page + SSI_ICR) = 0;
+    }
+    else if (page == UDMA_BASE)
+    {
+        *reg(page + UDMA_ALTBASE) = *reg(page + UDMA_CTLBASE) + (UDMA_CHANNELS * sizeof(struct udma_descriptor));
+        *reg(page + UDMA_USEBURSTSET) = write ? 0 : model.dma_useburst;
+        *reg(page + UDMA_USEBURSTCLR) = 0;
+        *reg(page + UDMA_REQMASKSET) = write ? 0 : model.dma_reqmask;
+        *reg(page + UDMA_REQMASKCLR) = 0;
+        *reg(page + UDMA_ENASET) = write ? 0 : model.dma_enabled;
+        *reg(page + UDMA_ENACLR) = 0;
+        *reg(page + UDMA_ALTSET) = write ? 0 : model.dma_alternate;
+        *reg(page + UDMA_ALTCLR) = 0;
+        *reg(page + UDMA_PRIOSET) = write ? 0 : model.dma_priority;
+        *reg(page + UDMA_PRIOCLR) = 0;
+        *reg(page + UDMA_CHIS) = write ? 0 : model.dma_done;
+    }
+    else if (page == (SYSCTL_PR_START & ~(PAGE_SIZE - 1U)))
+    {
+        // Every peripheral is ready as soon as it is clocked
+        for (uintptr_t address = SYSCTL_PR_START; address < SYSCTL_PR_END; address += 4U)
+        {
+            *reg(address) = 0xFFFFFFFFU;
+        }
+    }
+    else if (page == DWT_PAGE)
+    {
+        *reg(DWT_CYCCNT) = write ? WRITE_SENTINEL : (uint32_t)model.now + model.cyccnt_offset;
+    }
+    else if (page == NVIC_PAGE)
+    {
+        for (unsigned i = 0; i < NVIC_WORDS; i++)
+        {
+            *reg(NVIC_EN0 + (i * 4U)) = write ? 0 : model.nvic_enabled[i];
+            *reg(NVIC_DIS0 + (i * 4U)) = write ? 0 : model.nvic_enabled[i];
+        }
+    }
+}
+
+static void register_written(uintptr_t address, uint32_t value)
+{
+    int instance = ssi_instance_of(address);
+    uintptr_t offset = address & (PAGE_SIZE - 1U);
+    uintptr_t page = address & ~(PAGE_SIZE - 1U);
+
+    if (instance >= 0)
+    {
+        struct ssi_state *ssi = &model.ssi[instance];
+
+        if (offset == SSI_DR && value != WRITE_SENTINEL)
+        {
+            ssi_write_data((unsigned)instance, (uint16_t)value);
+        }
+        else if (offset == SSI_ICR)
+        {
+            ssi->overrun &= !(value & SSI_ICR_RORIC);
+            ssi->timeout &= !(value & SSI_ICR_RTIC);
+        }
+        else if (offset == SSI_CR1 && !(value & SSI_CR1_SSE))
+        {
+            ssi->shifting = 0;
+        }
+    }
+    else if (page == UDMA_BASE)
+    {
+        switch (offset)
+        {
+            case UDMA_USEBURSTSET: model.dma_useburst |= value; break;
+            case UDMA_USEBURSTCLR: model.dma_useburst &= ~value; break;
+            case UDMA_REQMASKSET: model.dma_reqmask |= value; break;
+            case UDMA_REQMASKCLR: model.dma_reqmask &= ~value; break;
+            case UDMA_ENASET: model.dma_enabled |= value; break;
+            case UDMA_ENACLR: model.dma_enabled &= ~value; break;
+            case UDMA_ALTSET: model.dma_alternate |= value; break;
+            case UDMA_ALTCLR: model.dma_alternate &= ~value; break;
+            case UDMA_PRIOSET: model.dma_priority |= value; break;
+            case UDMA_PRIOCLR: model.dma_priority &= ~value; break;
+            case UDMA_CHIS: model.dma_done &= ~value; break;
+            default: break;
+        }
+    }
+    else if (address == DWT_CYCCNT && value != WRITE_SENTINEL)
+    {
+        model.cyccnt_offset = value - (uint32_t)model.now;
+    }
+    else if (address >= NVIC_EN0 && address < NVIC_EN0 + (NVIC_WORDS * 4U))
+    {
+        model.nvic_enabled[(address - NVIC_EN0) / 4U] |= value;
+    }
+    else if (address >= NVIC_DIS0 && address < NVIC_DIS0 + (NVIC_WORDS * 4U))
+    {
+        model.nvic_enabled[(address - NVIC_DIS0) / 4U] &= ~value;
+    }
+}
+
+static int model_region(uintptr_t address)
+{
+    return (address >= PERIPHERAL_BASE && address < PERIPHERAL_BASE + PERIPHERAL_SIZE) ||
+           (address >= SYSTEM_BASE && address < SYSTEM_BASE + SYSTEM_SIZE);
+}
+
+static void model_crash(void)
+{
+    struct sigaction action = {0};
+
+    // Returning re-runs the faulting instruction, which now ends the program
+    action.sa_handler = SIG_DFL;
+    sigaction(SIGSEGV, &action, NULL);
+}
+
+static void model_fault(int signal, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = context;
+    uintptr_t address = (uintptr_t)info->si_addr;
+
+    (void)signal;
+    if (!model_region(address))
+    {
+        model_crash();
+        return;
+    }
+
+    model.address = address;
+    model.page = address & ~(PAGE_SIZE - 1U);
+    model.write = (uc->uc_mcontext.gregs[REG_ERR] & 2) != 0;
+
+    if (model_unlock() != 0)
+    {
+        model_crash();
+        return;
+    }
+
+    model.accesses++;
+    model.now += SSI_MODEL_ACCESS_CYCLES;
+    model_step();
+    prepare_page(model.page, model.write);
+    if (model.write)
+    {
+        memcpy(model.snapshot, (const void *)model.page, PAGE_SIZE);
+    }
+
+    // Run the one instruction, model_step_done picks up afterwards
+    uc->uc_mcontext.gregs[REG_EFL] |= EFLAGS_TRAP;
+}
+
+static void model_step_done(int signal, siginfo_t *info, void *context)
+{
+    ucontext_t *uc = context;
+
+    (void)signal;
+    (void)info;
+    uc->uc_mcontext.gregs[REG_EFL] &= ~EFLAGS_TRAP;
+
+    if (model.write)
+    {
+        const uint32_t *words = (const uint32_t *)model.page;
+        for (unsigned i = 0; i < PAGE_SIZE / 4U; i++)
+        {
+            if (words[i] != model.snapshot[i])
+            {
+                register_written(model.page + (i * 4U), words[i]);
+            }
+        }
+    }
+    else
+    {
+        int instance = ssi_instance_of(model.address);
+        if (instance >= 0 && (model.address & ~3UL) == model.page + SSI_DR)
+        {
+            (void)ssi_read_data((unsigned)instance);
+        }
+    }
+
+    model_step();
+    int pending = irq_pending();
+    model_lock();
+
+    if (!model.in_isr && pending >= 0)
+    {
+        // Preempt: park the program's registers and run the handlers on its
+        // stack, below the red zone
+        greg_t rsp = uc->uc_mcontext.gregs[REG_RSP];
+
+        model.in_isr = 1;
+        memcpy(model.saved_gregs, uc->uc_mcontext.gregs, sizeof(gregset_t));
+        memcpy(&model.saved_fpregs, uc->uc_mcontext.fpregs, sizeof(model.saved_fpregs));
+
+        uc->uc_mcontext.gregs[REG_RSP] = ((rsp - 512) & ~(greg_t)15) - 8;
+        uc->uc_mcontext.gregs[REG_RIP] = (greg_t)(uintptr_t)model_isr_trampoline;
+    }
+}
+
+int ssi_model_init(void)
+{
+    struct sigaction action = {0};
+
+    if (mmap((void *)PERIPHERAL_BASE, PERIPHERAL_SIZE, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != (void *)PERIPHERAL_BASE ||
+        mmap((void *)SYSTEM_BASE, SYSTEM_SIZE, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != (void *)SYSTEM_BASE)
+    {
+        perror("ssi_model: mmap");
+        return -1;
+    }
+
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+
+    action.sa_sigaction = model_fault;
+    sigaction(SIGSEGV, &action, NULL);
+    action.sa_sigaction = model_step_done;
+    sigaction(SIGTRAP, &action, NULL);
+    action.sa_sigaction = model_return_from_isr;
+    sigaction(SIGUSR1, &action, NULL);
+
+    return 0;
+}
+
+void ssi_model_set_handler(uint8_t irq, ssi_model_handler handler)
+{
+    model.handlers[irq] = handler;
+}
+
+uint64_t ssi_model_accesses(void)
+{
+    return model.accesses;
+}
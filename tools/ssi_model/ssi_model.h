@@ -0,0 +1,59 @@
+#ifndef SSI_MODEL_H__
+#define SSI_MODEL_H__
+
+/*
+ * Host register model of the TM4C123 parts the SSI driver touches, so the
+ * unmodified driver sources run on an x86-64 Linux host.
+ *
+ * The peripheral (0x40000000) and system (0xE0000000) address ranges are
+ * mapped at their target addresses with no access rights. Every register
+ * access faults; the model fills in what the register would read, lets the
+ * instruction run single stepped, then looks at what it wrote. Plain
+ * configuration registers simply live in that memory.
+ *
+ * Modelled:
+ *      SSI0-3      FIFOs, shifter timing from CPSR/SCR/DSS, SR, RIS/MIS/ICR,
+ *                  loopback, EOT, RX timeout and overrun, DMA requests
+ *      uDMA        channel enable/alt/priority sets, basic and ping-pong
+ *                  descriptors from the control table, CHIS
+ *      NVIC        enable/disable; pending interrupts preempt the program
+ *                  between two register accesses
+ *      DWT         CYCCNT, reads model time
+ *      SYSCTL      peripheral ready registers always read ready
+ *
+ * Model time advances SSI_MODEL_ACCESS_CYCLES per register access and the
+ * SSI shifts frames in model time, so a run is fully deterministic: numbers
+ * are for comparing driver versions, not a prediction of target timing.
+ *
+ * Build with -no-pie so the uDMA control table has a 32-bit address.
+ */
+
+#include <stdint.h>
+
+#define SSI_MODEL_ACCESS_CYCLES 4U
+
+typedef void (*ssi_model_handler)(void);
+
+/**
+ * @brief   Map the register ranges and install the fault handlers
+ *
+ * @return int 0 on success
+ */
+int ssi_model_init(void);
+
+/**
+ * @brief   Set the handler run for an NVIC interrupt number
+ *
+ * @param irq Interrupt number
+ * @param handler Handler, as installed in the vector table
+ */
+void ssi_model_set_handler(uint8_t irq, ssi_model_handler handler);
+
+/**
+ * @brief   Register accesses trapped so far
+ *
+ * @return uint64_t Accesses
+ */
+uint64_t ssi_model_accesses(void);
+
+#endif